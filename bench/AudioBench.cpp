@@ -0,0 +1,79 @@
+// CPU cost of the audio path per second of recorded audio: AudioMixer fed and drained in
+// 10 ms chunks the way main.cpp's audio thread does, for the source layouts the UI can
+// produce, at each CpuDispatch level. Ten seconds of audio per run, best of 5 runs.
+#include "AudioMixer.hpp"
+#include "CpuDispatch.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static constexpr int kSeconds = 10;
+
+struct Layout {
+    const char* name;
+    int micRate;     // 0 = no mic
+    int systemRate;  // 0 = no system audio
+    bool separate;   // Two tracks (ReadSource) instead of one mix
+};
+
+static std::vector<float> Tone(int rate, int channels, double hz) {
+    std::vector<float> out((size_t)rate * kSeconds * channels);
+    for (size_t i = 0; i < out.size(); ++i) out[i] = 0.3f * (float)std::sin(6.283185307 * hz * (double)(i / channels) / rate);
+    return out;
+}
+
+// Milliseconds of CPU per second of audio
+static double Run(const Layout& layout, const std::vector<float>& mic, const std::vector<float>& system) {
+    double best = 1e30;
+    std::vector<float> out;
+    for (int run = 0; run < 5; ++run) {
+        AudioMixer mixer;
+        int micSource = layout.micRate ? mixer.AddSource(layout.micRate, 1) : -1;
+        int systemSource = layout.systemRate ? mixer.AddSource(layout.systemRate, 2) : -1;
+        size_t micChunk = (size_t)layout.micRate / 100, systemChunk = (size_t)layout.systemRate / 100;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int chunk = 0; chunk < kSeconds * 100; ++chunk) {
+            if (micSource >= 0) mixer.PushSamples(micSource, mic.data() + chunk * micChunk, micChunk);
+            if (systemSource >= 0) mixer.PushSamples(systemSource, system.data() + chunk * systemChunk * 2, systemChunk);
+            if (layout.separate) {
+                mixer.ReadSource(micSource, AudioMixer::kOutputRate / 100, out);
+                mixer.ReadSource(systemSource, AudioMixer::kOutputRate / 100, out);
+            } else {
+                mixer.Mix(AudioMixer::kOutputRate / 100, out);
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / kSeconds;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+int main() {
+    const Layout layouts[] = {
+        { "system 48k stereo", 0, 48000, false },
+        { "mic 48k mono", 48000, 0, false },
+        { "mic 44.1k mono", 44100, 0, false },
+        { "mic 44.1k + system 48k", 44100, 48000, false },
+        { "same, separate tracks", 44100, 48000, true },
+    };
+    std::vector<float> mic48 = Tone(48000, 1, 440.0), mic44 = Tone(44100, 1, 440.0), system = Tone(48000, 2, 1000.0);
+
+    std::printf("Audio mix cost (ms of CPU per second of audio)\n%-24s", "sources");
+    std::vector<CpuDispatch::Isa> levels;
+    for (CpuDispatch::Isa isa : { CpuDispatch::Isa::Scalar, CpuDispatch::Isa::SSE2, CpuDispatch::Isa::AVX2 }) {
+        if (CpuDispatch::Force(isa) != isa) continue;
+        levels.push_back(isa);
+        std::printf(" %8s", CpuDispatch::Name(isa));
+    }
+    std::printf("\n");
+    for (const Layout& layout : layouts) {
+        std::printf("%-24s", layout.name);
+        for (CpuDispatch::Isa isa : levels) {
+            CpuDispatch::Force(isa);
+            std::printf(" %8.3f", Run(layout, layout.micRate == 48000 ? mic48 : mic44, system));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Cost of ChangeMap::Update (every tile hashed) per frame at common screen sizes and SIMD
+// levels, next to a memcpy and a plain read of the same frame (the floor for any pass over
+// it), an exact Diff() against a retained copy of the previous frame (unchanged, so every
+// byte is compared), and a Refresh() for a caret-sized OS damage rect. Best of many runs.
+#include "ChangeMap.hpp"
+#include "CpuDispatch.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+// Many short runs: on a shared core the minimum is the only stable figure
+static double BestMs(const std::function<void()>& body, int reps) {
+    double best = 1e30;
+    for (int run = 0; run < 40; ++run) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i) body();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937 rng(1);
+    struct Size { int w, h; } sizes[] = { { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+
+    std::printf("%-10s %-7s %10s %10s %10s %10s %12s\n", "size", "isa", "hash ms", "memcpy ms", "read ms", "diff ms", "refresh us");
+    for (Size s : sizes) {
+        std::vector<uint8_t> pixels, copy((size_t)s.w * s.h * 4);
+        Frame frame = Frame::Wrap(pixels, s.w, s.h);
+        for (uint8_t& b : pixels) b = (uint8_t)rng();
+        int reps = 3840 * 2160 / (s.w * s.h);
+
+        double copyMs = BestMs([&] {
+            std::memcpy(copy.data(), pixels.data(), pixels.size());
+        }, reps);
+        volatile uint64_t sink = 0;
+        double readMs = BestMs([&] {
+            uint64_t acc = 0;
+#ifdef SSR_X86_SSE2
+            __m128i v = _mm_setzero_si128();
+            for (size_t i = 0; i < pixels.size(); i += 16) v = _mm_xor_si128(v, _mm_loadu_si128((const __m128i*)(pixels.data() + i)));
+            acc = (uint64_t)_mm_cvtsi128_si64(v);
+#else
+            for (size_t i = 0; i < pixels.size(); i += 8) { uint64_t w; std::memcpy(&w, pixels.data() + i, 8); acc ^= w; }
+#endif
+            sink = acc;
+        }, reps);
+        std::memcpy(copy.data(), pixels.data(), pixels.size());
+        Frame previous = Frame::Wrap(copy, s.w, s.h);
+        ChangeMap exact;
+        exact.Diff(frame, previous); // The first call only sizes the map
+        double diffMs = BestMs([&] { exact.Diff(frame, previous); }, reps);
+
+        for (CpuDispatch::Isa isa : { CpuDispatch::Isa::Scalar, CpuDispatch::Isa::SSE2, CpuDispatch::Isa::AVX2 }) {
+            if (CpuDispatch::Force(isa) != isa) continue;
+            ChangeMap map;
+            map.Update(frame);
+            double hashMs = BestMs([&] { map.Update(frame); }, reps);
+            std::vector<FrameRect> caret = { { s.w / 2, s.h / 2, 2, 20 } };
+            double refreshMs = BestMs([&] { map.Refresh(frame, caret); }, reps * 100);
+            std::printf("%4dx%-5d %-7s %10.2f %10.2f %10.2f %10.2f %12.2f\n", s.w, s.h, CpuDispatch::Name(isa),
+                        hashMs, copyMs, readMs, diffMs, refreshMs * 1000.0);
+        }
+    }
+    return 0;
+}
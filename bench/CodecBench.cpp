@@ -0,0 +1,122 @@
+// ScreenCodec ratio and throughput over a synthetic corpus at 2560x1440: keyframes of a
+// desktop with text, a gradient, photo-like content and noise, then deltas for typing and
+// scrolling. Throughput is full-frame equivalent (frame bytes / encode time, change detection
+// included). Every frame is also decoded and checked, so a lossy result fails the run.
+// Usage: CodecBench [width height]
+#include "ScreenCodec.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng(5);
+
+static void FillRect(const Frame& f, int x, int y, int w, int h, uint32_t color) {
+    for (int j = y; j < y + h && j < f.height; ++j) {
+        for (int i = x; i < x + w && i < f.width; ++i) ((uint32_t*)f.Row(j))[i] = color;
+    }
+}
+
+// Dark 6x10 glyph-like speckles on a 8x16 grid
+static void Text(const Frame& f, int x, int y, int w, int h) {
+    for (int j = y; j < y + h && j + 12 <= f.height; j += 16) {
+        for (int i = x; i < x + w && i + 7 <= f.width; i += 8) {
+            if (rng() % 5 == 0) continue;
+            for (int yy = 2; yy < 12; ++yy) {
+                for (int xx = 1; xx < 7; ++xx) {
+                    if (rng() % 3 == 0) ((uint32_t*)f.Row(j + yy))[i + xx] = 0xFF202020u;
+                }
+            }
+        }
+    }
+}
+
+static void Desktop(const Frame& f) {
+    FillRect(f, 0, 0, f.width, f.height, 0xFF2D5F8Bu);
+    FillRect(f, 100, 80, f.width - 860, f.height - 440, 0xFFFFFFFFu);
+    FillRect(f, 100, 80, f.width - 860, 32, 0xFFE0E0E0u);
+    Text(f, 120, 130, f.width - 1060, f.height - 540);
+    FillRect(f, 0, f.height - 48, f.width, 48, 0xFF101010u);
+}
+
+static void Gradient(const Frame& f) {
+    for (int y = 0; y < f.height; ++y) {
+        for (int x = 0; x < f.width; ++x) {
+            ((uint32_t*)f.Row(y))[x] = 0xFF000000u | (uint32_t)(x * 255 / f.width) << 16 | (uint32_t)(y * 255 / f.height) << 8 | 0x40;
+        }
+    }
+}
+
+static void Photo(const Frame& f) {
+    uint32_t v = 0x808080;
+    for (int y = 0; y < f.height; ++y) {
+        for (int x = 0; x < f.width; ++x) {
+            v = (v + rng() % 7 - 3) & 0xFFFFFF;
+            ((uint32_t*)f.Row(y))[x] = 0xFF000000u | v | (rng() & 0x030303);
+        }
+    }
+}
+
+static void Noise(const Frame& f) {
+    for (int y = 0; y < f.height; ++y) {
+        for (int x = 0; x < f.width; ++x) ((uint32_t*)f.Row(y))[x] = rng() | 0xFF000000u;
+    }
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 2 ? std::atoi(argv[1]) : 2560;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1440;
+    if (width < 1280 || height < 720) {
+        std::fprintf(stderr, "size must be at least 1280x720\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> pixels, decoded;
+    Frame frame = Frame::Wrap(pixels, width, height);
+    Frame canvas = Frame::Wrap(decoded, width, height);
+
+    enum Workload { DesktopKey, GradientKey, PhotoKey, NoiseKey, Typing, Scrolling };
+    const char* names[] = { "desktop+text (key)", "gradient (key)", "photo-like (key)", "noise (key)", "typing (delta)", "scrolling (delta)" };
+
+    std::printf("%dx%d\n%-20s %10s %10s %10s\n", width, height, "workload", "ratio", "ms/frame", "GB/s");
+    for (int w = DesktopKey; w <= Scrolling; ++w) {
+        if (w == GradientKey) Gradient(frame);
+        else if (w == PhotoKey) Photo(frame);
+        else if (w == NoiseKey) Noise(frame);
+        else Desktop(frame);
+
+        ScreenCodec codec;
+        std::vector<uint8_t> out;
+        codec.Encode(frame, true, out);
+        ScreenCodec::Decode(out.data(), out.size(), canvas);
+
+        bool key = w < Typing;
+        int frames = key ? 10 : 60;
+        double ms = 0;
+        uint64_t in = 0, coded = 0;
+        for (int i = 0; i < frames; ++i) {
+            if (w == Typing) FillRect(frame, 120 + (i * 8) % 1500, 300, 8, 16, 0xFF202020u);
+            if (w == Scrolling) {
+                std::memmove(frame.Row(130), frame.Row(146), (size_t)frame.stride * (height - 440 - 16));
+                Text(frame, 120, height - 340, width - 1060, 16);
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            bool any = codec.Encode(frame, key, out);
+            ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if (any && !ScreenCodec::Decode(out.data(), out.size(), canvas)) {
+                std::fprintf(stderr, "%s: decode failed\n", names[w]);
+                return 1;
+            }
+            in += pixels.size();
+            coded += out.size();
+        }
+        if (std::memcmp(pixels.data(), decoded.data(), pixels.size()) != 0) {
+            std::fprintf(stderr, "%s: decoded frame differs\n", names[w]);
+            return 1;
+        }
+        std::printf("%-20s %9.1f:1 %10.2f %10.2f\n", names[w], (double)in / (double)(coded ? coded : 1), ms / frames, in / ms / 1e6);
+    }
+    return 0;
+}
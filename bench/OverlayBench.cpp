@@ -0,0 +1,99 @@
+// OverlayPipeline's specialized variants against the generic loop body they replaced (every
+// feature flag re-checked each frame), for all 8 combinations of ROI, highlight and cursor.
+// 1080p, compositor Begin() plus overlays per frame, with a video-sized area damaged every
+// frame so ROI has coarse blocks to work on; then the overlays alone, where the flag checks
+// are the biggest share. Best of 5 runs.
+#include "OverlayPipeline.hpp"
+#include "RoiMap.hpp"
+#include "FrameCompositor.hpp"
+#include "VisualEffects.hpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+static constexpr int kWidth = 1920;
+static constexpr int kHeight = 1080;
+
+// The frame loop's overlay code before OverlayPipeline: flags read (volatile) on every frame
+static void Generic(const volatile OverlayPipeline::Features& f, const Frame& out, POINT mouse,
+                    const std::vector<FrameRect>* damage, RoiMap& roi, FrameCompositor& compositor,
+                    std::vector<FrameRect>& touched) {
+    bool clicked = f.highlight && VisualEffects::IsLeftClicked();
+    int radius = clicked ? 30 : 25;
+    if (f.roi) {
+        FrameRect highlight = f.highlight ? FrameRect{ (int)mouse.x - radius, (int)mouse.y - radius, 2 * radius, 2 * radius } : FrameRect{};
+        roi.Update(out.width, out.height, damage, mouse, highlight);
+        touched.clear();
+        roi.Apply(out, touched);
+        for (const FrameRect& r : touched) compositor.AddOverlay(r);
+    }
+    if (f.highlight) {
+        VisualEffects::Color color = clicked ? VisualEffects::Color{ 255, 0, 0, 150 } : VisualEffects::Color{ 255, 255, 0, 100 };
+        compositor.AddOverlay(VisualEffects::DrawHighlight(out, mouse, radius, color));
+    }
+    if (f.cursor) compositor.AddOverlay(VisualEffects::DrawCursor(out, mouse));
+}
+
+static POINT Mouse(int i) { return { 300 + (i % 700), 300 + (i % 300) }; }
+
+// Microseconds per frame of `frames` iterations of body(frame, specialized), best of 5 runs;
+// fresh state for every run
+static void Measure(const OverlayPipeline::Features& features, int frames,
+                    const std::function<void(int, bool, RoiMap&, FrameCompositor&, OverlayPipeline&)>& body,
+                    double& generic, double& specialized) {
+    generic = specialized = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        for (bool special : { false, true }) {
+            RoiMap roi;
+            FrameCompositor compositor;
+            OverlayPipeline pipeline;
+            pipeline.Configure(features);
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; ++i) body(i, special, roi, compositor, pipeline);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / frames;
+            double& best = special ? specialized : generic;
+            if (us < best) best = us;
+        }
+    }
+}
+
+int main() {
+    std::vector<uint8_t> pixels;
+    Frame screen = Frame::Wrap(pixels, kWidth, kHeight);
+    for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = (uint8_t)(i * 7 / 13);
+    std::vector<FrameRect> damage = { { 1200, 200, 640, 360 } };
+    screen.damage = &damage;
+    std::vector<FrameRect> touched;
+
+    std::printf("Begin + overlays, 1080p (us/frame)\n%-4s %-3s %-4s %10s %12s %8s\n", "roi", "hl", "cur", "generic", "specialized", "diff");
+    for (int mask = 0; mask < 8; ++mask) {
+        OverlayPipeline::Features features{ (mask & 4) != 0, (mask & 2) != 0, (mask & 1) != 0 };
+        volatile OverlayPipeline::Features flags = features;
+        double generic, specialized;
+        Measure(features, 3000, [&](int i, bool special, RoiMap& roi, FrameCompositor& compositor, OverlayPipeline& pipeline) {
+            screen.sequence = (uint64_t)i + 1;
+            Frame out = compositor.Begin(screen, kWidth, kHeight);
+            if (special) pipeline.Run(out, OverlayPipeline::Input{ Mouse(i), &damage }, roi, compositor);
+            else Generic(flags, out, Mouse(i), &damage, roi, compositor, touched);
+        }, generic, specialized);
+        std::printf("%-4d %-3d %-4d %10.2f %12.2f %+7.1f%%\n", features.roi, features.highlight, features.cursor,
+                    generic, specialized, 100.0 * (specialized - generic) / generic);
+    }
+
+    // Overlays alone, drawn into a fixed canvas (no compositor copies)
+    std::vector<uint8_t> canvas(pixels);
+    Frame out = Frame::Wrap(canvas, kWidth, kHeight);
+    std::printf("\nOverlays only (us/frame)\n%-3s %-4s %10s %12s\n", "hl", "cur", "generic", "specialized");
+    for (int mask : { 1, 2, 3 }) {
+        OverlayPipeline::Features features{ false, (mask & 2) != 0, (mask & 1) != 0 };
+        volatile OverlayPipeline::Features flags = features;
+        double generic, specialized;
+        Measure(features, 200000, [&](int i, bool special, RoiMap& roi, FrameCompositor& compositor, OverlayPipeline& pipeline) {
+            if (special) pipeline.Run(out, OverlayPipeline::Input{ Mouse(i), nullptr }, roi, compositor);
+            else Generic(flags, out, Mouse(i), nullptr, roi, compositor, touched);
+        }, generic, specialized);
+        std::printf("%-3d %-4d %10.3f %12.3f\n", features.highlight, features.cursor, generic, specialized);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Synthetic 960x540, 30 FPS, 30 s screen recording for the ROI quantization measurement
+// (bench/roi_ssim.sh): typing next to the cursor, a log pane scrolling 2 px per frame and an
+// animated video area. Writes raw BGRA frames to stdout, with RoiMap applied as the engine
+// applies it when `roi` is given (damage from ChangeMap, cursor drawn after).
+// Usage: RoiCorpus off|roi [--stats]   (--stats: print the map's figures instead of frames)
+#include "ChangeMap.hpp"
+#include "RoiMap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static constexpr int kWidth = 960;
+static constexpr int kHeight = 540;
+static constexpr int kFps = 30;
+static constexpr int kSeconds = 30;
+
+static std::vector<uint32_t> g_screen((size_t)kWidth * kHeight);
+
+static void FillRect(int x, int y, int w, int h, uint32_t color) {
+    for (int j = std::max(0, y); j < std::min(kHeight, y + h); ++j) {
+        for (int i = std::max(0, x); i < std::min(kWidth, x + w); ++i) g_screen[(size_t)j * kWidth + i] = color;
+    }
+}
+
+// Four strokes in a 7x12 cell, fixed per code
+static void Glyph(int x, int y, unsigned code, uint32_t color) {
+    std::mt19937 r(code * 2654435761u);
+    for (int k = 0; k < 4; ++k) {
+        int gx = (int)(r() % 6), gy = (int)(r() % 10);
+        bool vertical = r() & 1;
+        FillRect(x + gx, y + gy, vertical ? 1 : 4, vertical ? 5 : 1, color);
+    }
+}
+
+static void Render(int f, POINT& cursor) {
+    double t = (double)f / kFps;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            g_screen[(size_t)y * kWidth + x] = 0xFF000000u | (uint32_t)(40 + y * 60 / kHeight) << 16 | (uint32_t)(60 + x * 40 / kWidth) << 8 | 120;
+        }
+    }
+
+    // Editor window, typing at 7 characters per second
+    FillRect(220, 20, kWidth - 240, kHeight - 60, 0xFFF5F5F5u);
+    FillRect(220, 20, kWidth - 240, 24, 0xFF1F4E79u);
+    int chars = (int)(t * 7);
+    for (int i = 0; i < chars && i < 360; ++i) Glyph(240 + (i % 60) * 8, 70 + (i / 60) * 18, (unsigned)(i * 13) % 56 + 8, 0xFF101010u);
+    cursor = { (LONG)(240 + (chars % 60) * 8 + 30), (LONG)(70 + (std::min(chars, 359) / 60) * 18 + 20) };
+
+    // Log pane scrolling 2 px per frame
+    FillRect(10, 20, 200, kHeight - 60, 0xFF1E1E1Eu);
+    int offset = f * 2;
+    for (int line = 0; line < 30; ++line) {
+        int y = 20 + ((line * 18 - offset) % (kHeight - 60) + (kHeight - 60)) % (kHeight - 60);
+        std::mt19937 r((unsigned)(line + offset / 18) * 77);
+        for (int c = 0; c < 22; ++c) {
+            if (r() % 5) Glyph(14 + c * 8, y, r() % 56 + 8, 0xFF9CDCFEu);
+        }
+    }
+
+    // Video area: moving textured pattern with a little grain
+    for (int y = 0; y < 180; ++y) {
+        for (int x = 0; x < 320; ++x) {
+            double u = x / 40.0 + t * 1.3, v = y / 30.0 - t * 0.7;
+            int r = (int)(128 + 100 * std::sin(u) * std::cos(v));
+            int g = (int)(128 + 90 * std::sin(u * 1.7 + v));
+            int b = (int)(128 + 80 * std::cos(v * 2.3 - u * 0.5));
+            int n = (x * 7919 + y * 104729 + f * 31) % 23;
+            g_screen[(size_t)(330 + y) * kWidth + 610 + x] = 0xFF000000u | (uint32_t)(r + n) << 16 | (uint32_t)(g + n) << 8 | (uint32_t)(b + n);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || (std::string(argv[1]) != "off" && std::string(argv[1]) != "roi")) {
+        std::fprintf(stderr, "Usage: RoiCorpus off|roi [--stats]\n");
+        return 2;
+    }
+    bool roi = std::string(argv[1]) == "roi";
+    bool stats = argc > 2 && std::string(argv[2]) == "--stats";
+
+    ChangeMap changes;
+    RoiMap map;
+    std::vector<FrameRect> damage, touched;
+    std::vector<uint32_t> out;
+    int64_t us = 0;
+    for (int f = 0; f < kFps * kSeconds; ++f) {
+        POINT cursor;
+        Render(f, cursor);
+        Frame screen;
+        screen.data = (uint8_t*)g_screen.data();
+        screen.width = kWidth;
+        screen.height = kHeight;
+        screen.stride = kWidth * 4;
+        changes.Update(screen);
+        changes.ToRects(damage);
+
+        out = g_screen;
+        Frame frame = screen;
+        frame.data = (uint8_t*)out.data();
+        if (roi) {
+            auto start = std::chrono::steady_clock::now();
+            map.Update(kWidth, kHeight, f ? &damage : nullptr, cursor, FrameRect{});
+            touched.clear();
+            map.Apply(frame, touched);
+            us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Arrow cursor on top, as the overlays are drawn after pre-quantization
+        for (int j = 0; j < 16; ++j) {
+            for (int i = 0; i <= j / 2; ++i) out[(size_t)(cursor.y + j) * kWidth + cursor.x + i] = (i == j / 2 || j == 15) ? 0xFF000000u : 0xFFFFFFFFu;
+        }
+        if (!stats) std::fwrite(out.data(), 4, out.size(), stdout);
+    }
+
+    if (stats) {
+        RoiMap::Stats s = map.GetStats();
+        std::printf("focus %.1f%%, coarse %.1f%% of blocks, %.3f ms/frame (Update + Apply)\n",
+                    s.blocks ? 100.0 * s.focusBlocks / s.blocks : 0.0, s.blocks ? 100.0 * s.coarseBlocks / s.blocks : 0.0,
+                    us / 1000.0 / (kFps * kSeconds));
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Encoder share of the time to first frame: from Start until the first 1080p frame is taken
+// off the pipe by an FFmpeg started with VideoEncoder::Start's options (720p output, live
+// rate control). Cold: FFmpeg is spawned at Start, as before the engine warmed up ahead of
+// time. Pre-warmed: FFmpeg was spawned a second earlier and waits on its pipe. Device
+// activation (WASAPI, camera) is Windows-only and not part of this figure; it adds to the
+// cold start in the app. Needs FFmpeg with libx264 ($FFMPEG, or ffmpeg on PATH). Best and
+// median of 15 runs.
+#include "RateController.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+static const char* kNull = "NUL";
+#else
+static const char* kNull = "/dev/null";
+#endif
+
+static constexpr int kWidth = 1920;
+static constexpr int kHeight = 1080;
+static constexpr int kFps = 30;
+static constexpr int kRuns = 15;
+
+static std::string Quote(const std::string& s) { return "\"" + s + "\""; }
+
+// Milliseconds from `start` until the first frame has gone into the pipe
+static double FirstFrameMs(const std::string& cmd, const std::vector<uint8_t>& frame, bool prewarm) {
+    auto start = std::chrono::steady_clock::now();
+    std::FILE* pipe = nullptr;
+    if (prewarm) {
+        pipe = popen(cmd.c_str(), "w");
+        std::this_thread::sleep_for(std::chrono::seconds(1)); // The warm-up, well before Start
+        start = std::chrono::steady_clock::now();
+    } else {
+        pipe = popen(cmd.c_str(), "w");
+    }
+    if (!pipe) return -1.0;
+    // The pipe holds far less than a frame, so this returns once FFmpeg has read it
+    std::fwrite(frame.data(), 1, frame.size(), pipe);
+    std::fflush(pipe);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    pclose(pipe);
+    return ms;
+}
+
+int main() {
+    const char* env = std::getenv("FFMPEG");
+    std::string ffmpeg = env && *env ? env : "ffmpeg";
+    if (std::system((Quote(ffmpeg) + " -v quiet -hide_banner -h encoder=libx264 > " + kNull + " 2>&1").c_str()) != 0) {
+        std::printf("No FFmpeg with libx264 (set FFMPEG=...)\n");
+        return 77;
+    }
+
+    std::string output = (std::filesystem::temp_directory_path() / "ssr_start_latency.mp4").string();
+    std::string cmd = Quote(ffmpeg) + " -loglevel warning -thread_queue_size 2048 -f rawvideo -pixel_format bgra"
+                      " -video_size " + std::to_string(kWidth) + "x" + std::to_string(kHeight) +
+                      " -framerate " + std::to_string(kFps) + " -i - -vf \"scale=-2:720:flags=bicubic\""
+                      " -c:v libx264 -preset ultrafast" + RateController::Live(1280, 720, kFps).EncoderArgs(10) +
+                      " -pix_fmt yuv420p -y " + Quote(output);
+
+    std::vector<uint8_t> frame((size_t)kWidth * kHeight * 4);
+    for (size_t i = 0; i < frame.size(); ++i) frame[i] = (uint8_t)(i * 7 / 13);
+
+    std::printf("Time to first frame, encoder part (ms)\n%-12s %8s %8s\n", "", "best", "median");
+    for (bool prewarm : { false, true }) {
+        std::vector<double> runs;
+        for (int run = 0; run < kRuns; ++run) runs.push_back(FirstFrameMs(cmd, frame, prewarm));
+        std::sort(runs.begin(), runs.end());
+        std::printf("%-12s %8.1f %8.1f\n", prewarm ? "pre-warmed" : "cold", runs.front(), runs[runs.size() / 2]);
+    }
+    std::filesystem::remove(output);
+    return 0;
+}
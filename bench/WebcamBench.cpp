@@ -0,0 +1,189 @@
+// Webcam PIP path without a camera: a stand-in camera thread delivers 1280x720 YUY2 frames
+// at 30 FPS, converted to the PIP size into a triple buffer as WebcamDevice::Deliver does,
+// and a 30 FPS recorder loop composites them with WebcamOverlay into a 1080p frame.
+//
+// Time from Start to the first composited webcam frame, for the three ways the recorder can
+// meet the camera: subscribed to the shared session during warm-up (the app now), subscribed
+// at Start, and a device of its own opened at Start (before the shared session; the device
+// open itself is not simulated and comes on top). Best, median and worst of 20 runs.
+//
+// Then the PIP's cost per output frame at 30, 60 and 120 FPS with that 30 FPS camera:
+// rescaled from the native frame on every output frame (before the cached tile), rescaled
+// 1:1 once per camera frame (the cached tile, fed frames already at the PIP size) and used in
+// place (WebcamOverlay now). Ten seconds of output, no pacing, best of 5 runs.
+#include "WebcamOverlay.hpp"
+#include "PixelConvert.hpp"
+#include "TripleBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int kCameraWidth = 1280;
+static constexpr int kCameraHeight = 720;
+static constexpr int kPipHeight = 216; // 20% of 1080p, the default
+static constexpr auto kInterval = std::chrono::microseconds(1000000 / 30);
+
+struct Slot {
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+};
+
+// Delivers a frame every kInterval from its start (first one an interval in, like a device
+// that has to expose its first frame) once `subscribed` is set
+class FakeCamera {
+public:
+    explicit FakeCamera(const std::vector<uint8_t>& yuy2) : m_yuy2(yuy2) {}
+    ~FakeCamera() { Stop(); }
+
+    void Start() {
+        m_stop = false;
+        m_worker = std::thread([this] {
+            auto next = Clock::now() + kInterval;
+            while (!m_stop) {
+                std::this_thread::sleep_until(next);
+                next += kInterval;
+                if (!subscribed) continue;
+                int outW = WebcamOverlay::TileWidth(kCameraWidth, kCameraHeight, kPipHeight);
+                Slot& slot = frames.WriteBuffer();
+                slot.pixels.resize((size_t)outW * kPipHeight * 4);
+                PixelConvert::ConvertScaled(m_yuy2.data(), kCameraWidth * 2, kCameraWidth, kCameraHeight,
+                                            PixelConvert::Format::YUY2, slot.pixels.data(), outW * 4, outW, kPipHeight);
+                slot.width = outW;
+                slot.height = kPipHeight;
+                frames.Publish();
+            }
+        });
+    }
+
+    void Stop() {
+        m_stop = true;
+        if (m_worker.joinable()) m_worker.join();
+    }
+
+    TripleBuffer<Slot> frames;
+    std::atomic<bool> subscribed{ false };
+
+private:
+    const std::vector<uint8_t>& m_yuy2;
+    std::thread m_worker;
+    std::atomic<bool> m_stop{ false };
+};
+
+enum class Meet { WarmUp, AtStart, OwnDevice };
+
+// Milliseconds from Start to the first composited webcam frame
+static double FirstComposite(Meet meet, const std::vector<uint8_t>& yuy2, std::vector<uint8_t>& screen, std::mt19937& rng) {
+    FakeCamera camera(yuy2);
+    if (meet != Meet::OwnDevice) {
+        camera.Start();
+        camera.subscribed = (meet == Meet::WarmUp);
+        // Start lands at a random point of the camera's frame period, after the warm-up
+        std::this_thread::sleep_for(3 * kInterval + std::chrono::microseconds(rng() % kInterval.count()));
+    }
+
+    auto start = Clock::now();
+    camera.subscribed = true;
+    if (meet == Meet::OwnDevice) camera.Start();
+
+    Frame out = Frame::Wrap(screen, 1920, 1080);
+    WebcamOverlay overlay;
+    double ms = -1.0;
+    for (auto next = start; ms < 0.0; next += kInterval) {
+        std::this_thread::sleep_until(next);
+        camera.frames.Update();
+        const Slot& slot = camera.frames.ReadBuffer();
+        if (slot.pixels.empty()) continue;
+        overlay.Update(slot.pixels.data(), slot.width, slot.height, camera.frames.ReadSequence(), kPipHeight);
+        overlay.Blit(out, 1500, 840);
+        ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    return ms;
+}
+
+enum class Pip { EveryFrame, PerCameraFrame, InPlace };
+
+// Microseconds of PIP work (scale and blit) per output frame
+static double PipCost(Pip pip, int fps, const std::vector<uint8_t>& native, const std::vector<uint8_t>& delivered,
+                      std::vector<uint8_t>& screen) {
+    int pipW = WebcamOverlay::TileWidth(kCameraWidth, kCameraHeight, kPipHeight);
+    Frame out = Frame::Wrap(screen, 1920, 1080);
+    std::vector<uint8_t> tile((size_t)pipW * kPipHeight * 4);
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        WebcamOverlay overlay;
+        uint64_t tileSequence = 0;
+        int frames = fps * 10;
+        auto t0 = Clock::now();
+        for (int i = 0; i < frames; ++i) {
+            uint64_t sequence = (uint64_t)i * 30 / fps + 1; // The camera's newest frame
+            switch (pip) {
+            case Pip::EveryFrame:
+                overlay.Update(native.data(), kCameraWidth, kCameraHeight, (uint64_t)i + 1, kPipHeight);
+                break;
+            case Pip::PerCameraFrame:
+                if (sequence != tileSequence) {
+                    PixelConvert::ConvertScaled(delivered.data(), pipW * 4, pipW, kPipHeight, PixelConvert::Format::BGRA,
+                                                tile.data(), pipW * 4, pipW, kPipHeight);
+                    tileSequence = sequence;
+                }
+                overlay.Update(tile.data(), pipW, kPipHeight, tileSequence, kPipHeight);
+                break;
+            case Pip::InPlace:
+                overlay.Update(delivered.data(), pipW, kPipHeight, sequence, kPipHeight);
+                break;
+            }
+            overlay.Blit(out, 1500, 840);
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / frames;
+        best = std::min(best, us);
+    }
+    return best;
+}
+
+int main() {
+    std::vector<uint8_t> yuy2((size_t)kCameraWidth * kCameraHeight * 2);
+    for (size_t i = 0; i < yuy2.size(); ++i) yuy2[i] = (uint8_t)(16 + (i * 7 / 13) % 220);
+    std::vector<uint8_t> screen;
+    Frame::Wrap(screen, 1920, 1080); // Sized and touched up front, not in the first run
+    std::fill(screen.begin(), screen.end(), (uint8_t)0);
+    std::mt19937 rng(1);
+
+    std::printf("Start to first composited webcam frame (ms), 30 FPS camera and recorder\n%-30s %7s %7s %7s\n",
+                "recorder meets the camera", "best", "median", "worst");
+    const struct { Meet meet; const char* name; } cases[] = {
+        { Meet::WarmUp, "shared, subscribed in warm-up" },
+        { Meet::AtStart, "shared, subscribed at Start" },
+        { Meet::OwnDevice, "own device opened at Start" },
+    };
+    for (const auto& c : cases) {
+        std::vector<double> runs;
+        for (int run = 0; run < 20; ++run) runs.push_back(FirstComposite(c.meet, yuy2, screen, rng));
+        std::sort(runs.begin(), runs.end());
+        std::printf("%-30s %7.2f %7.2f %7.2f\n", c.name, runs.front(), runs[runs.size() / 2], runs.back());
+    }
+
+    // BGRA frames as the recorder's subscription gets them: native size before, PIP size now
+    std::vector<uint8_t> native((size_t)kCameraWidth * kCameraHeight * 4);
+    PixelConvert::ConvertScaled(yuy2.data(), kCameraWidth * 2, kCameraWidth, kCameraHeight, PixelConvert::Format::YUY2,
+                                native.data(), kCameraWidth * 4, kCameraWidth, kCameraHeight);
+    int pipW = WebcamOverlay::TileWidth(kCameraWidth, kCameraHeight, kPipHeight);
+    std::vector<uint8_t> delivered((size_t)pipW * kPipHeight * 4);
+    PixelConvert::ConvertScaled(yuy2.data(), kCameraWidth * 2, kCameraWidth, kCameraHeight, PixelConvert::Format::YUY2,
+                                delivered.data(), pipW * 4, pipW, kPipHeight);
+
+    std::printf("\nPIP %dx%d from a 30 FPS camera (us per output frame)\n%-6s %12s %14s %10s\n", pipW, kPipHeight,
+                "fps", "every frame", "per cam frame", "in place");
+    for (int fps : { 30, 60, 120 }) {
+        std::printf("%-6d %12.2f %14.2f %10.2f\n", fps, PipCost(Pip::EveryFrame, fps, native, delivered, screen),
+                    PipCost(Pip::PerCameraFrame, fps, native, delivered, screen),
+                    PipCost(Pip::InPlace, fps, native, delivered, screen));
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// The capture-to-encode path on X11, for load tests with no GPU: ScreenCapture (MIT-SHM grab,
+// XDamage) -> FrameCompositor -> ScreenCodec, the spool path of the recorder, paced at the
+// target frame rate like RecordingThread. The bench itself draws on the root window before
+// every grab: nothing (idle), a caret-sized block (typing), or most of the screen
+// (scrolling). Per scenario: the frame rate reached, the process CPU time as a share of one
+// core, and the time per frame in each stage.
+// Usage: xvfb-run -s "-screen 0 1920x1080x24" ./bench/X11PipelineBench [seconds] [fps]
+#include "ScreenCapture.hpp"
+#include "FrameCompositor.hpp"
+#include "ScreenCodec.hpp"
+#include <X11/Xlib.h>
+#include <sys/resource.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+enum class Activity { Idle, Typing, Scrolling };
+
+static double CpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static double Ms(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+int main(int argc, char** argv) {
+    if (!std::getenv("DISPLAY")) {
+        std::printf("No DISPLAY (run under xvfb-run), skipped\n");
+        return 77;
+    }
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 10;
+    int fps = argc > 2 ? std::atoi(argv[2]) : 30;
+    if (seconds <= 0 || fps <= 0) return 1;
+
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) return 77;
+    int screenIndex = DefaultScreen(display);
+    int width = DisplayWidth(display, screenIndex), height = DisplayHeight(display, screenIndex);
+    Window root = DefaultRootWindow(display);
+    GC gc = XCreateGC(display, root, 0, nullptr);
+    XSetSubwindowMode(display, gc, IncludeInferiors);
+
+    ScreenCapture capture;
+    if (!capture.Initialize()) {
+        std::printf("ScreenCapture::Initialize failed (MIT-SHM and XDamage needed)\n");
+        return 1;
+    }
+
+    std::printf("%dx%d at %d FPS, %d s per scenario\n%-10s %6s %6s %10s %10s %10s %8s\n", width, height, fps, seconds,
+                "activity", "fps", "cpu%", "grab ms", "compose ms", "encode ms", "MB/s");
+    const struct { Activity activity; const char* name; } scenarios[] = {
+        { Activity::Idle, "idle" }, { Activity::Typing, "typing" }, { Activity::Scrolling, "scrolling" },
+    };
+    for (const auto& s : scenarios) {
+        FrameCompositor compositor;
+        ScreenCodec codec;
+        std::vector<uint8_t> encoded;
+        Clock::duration grab{}, compose{}, encode{};
+        uint64_t bytes = 0;
+        int frames = 0;
+        int total = seconds * fps;
+        auto interval = std::chrono::microseconds(1000000 / fps);
+
+        double cpu0 = CpuSeconds();
+        auto start = Clock::now();
+        for (auto next = start; frames < total; next += interval) {
+            // What the user does between two frames; the X server's work is not counted as ours
+            if (s.activity == Activity::Typing) {
+                XSetForeground(display, gc, (frames & 1) ? WhitePixel(display, screenIndex) : BlackPixel(display, screenIndex));
+                XFillRectangle(display, root, gc, 200 + (frames % 80) * 8, 300, 8, 16);
+            } else if (s.activity == Activity::Scrolling) {
+                XSetForeground(display, gc, 0x404040u + (unsigned)(frames * 0x010203) % 0xBFBFBF);
+                XFillRectangle(display, root, gc, 100, 80, width - 400, height - 200);
+            }
+            XSync(display, False);
+
+            auto t0 = Clock::now();
+            Frame screen;
+            if (!capture.AcquireFrame(screen)) break;
+            auto t1 = Clock::now();
+            Frame out = compositor.Begin(screen, screen.width, screen.height);
+            auto t2 = Clock::now();
+            codec.Encode(out, frames % (10 * fps) == 0, encoded);
+            auto t3 = Clock::now();
+            grab += t1 - t0;
+            compose += t2 - t1;
+            encode += t3 - t2;
+            bytes += encoded.size();
+            frames++;
+            std::this_thread::sleep_until(next + interval);
+        }
+        double wall = std::chrono::duration<double>(Clock::now() - start).count();
+        double cpu = CpuSeconds() - cpu0;
+        if (frames == 0) {
+            std::printf("%-10s no frames\n", s.name);
+            continue;
+        }
+        std::printf("%-10s %6.1f %6.1f %10.3f %10.3f %10.3f %8.2f\n", s.name, frames / wall, 100.0 * cpu / wall,
+                    Ms(grab) / frames, Ms(compose) / frames, Ms(encode) / frames, bytes / wall / 1e6);
+    }
+
+    XFreeGC(display, gc);
+    XCloseDisplay(display);
+    capture.Cleanup();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# FFmpeg CPU time for a master recording with a proxy (one process, as VideoEncoder runs it
+# for `proxy_height` in settings.ini), compared with the master alone and with the master
+# plus a second, independent recording at proxy size. The shared input pipe and the single
+# BGRA -> YUV conversion are what the one-process proxy saves over two recordings.
+#
+# Usage: bench/proxy_cpu.sh [seconds] [WxH] [fps] [proxy height]
+# Needs ffmpeg with libx264 on PATH (or $FFMPEG). Prints user+sys CPU seconds per setup.
+set -euo pipefail
+
+SECONDS_OF_VIDEO=${1:-20}
+SIZE=${2:-1920x1080}
+FPS=${3:-30}
+PROXY_HEIGHT=${4:-360}
+FFMPEG=${FFMPEG:-ffmpeg}
+
+if ! command -v "$FFMPEG" >/dev/null 2>&1; then
+    echo "ffmpeg not found (set FFMPEG=...)" >&2
+    exit 77
+fi
+
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# Synthetic BGRA frames and a tone stand in for the frame and audio pipes
+SOURCE=(-f lavfi -i "testsrc2=size=$SIZE:rate=$FPS,format=bgra" -f lavfi -i "sine=frequency=440:sample_rate=48000")
+EVEN="scale=trunc(iw/2)*2:trunc(ih/2)*2"
+MASTER=(-c:v libx264 -preset ultrafast -crf 23 -c:a aac -b:a 192k -pix_fmt yuv420p -t "$SECONDS_OF_VIDEO" -y)
+PROXY=(-c:v libx264 -preset veryfast -crf 28 -c:a aac -b:a 96k -pix_fmt yuv420p -t "$SECONDS_OF_VIDEO" -y)
+
+master_only() {
+    "$FFMPEG" -loglevel error -nostdin "${SOURCE[@]}" -map 0:v -map 1:a -vf "$EVEN" "${MASTER[@]}" "$OUT/master.mp4"
+}
+
+# VideoEncoder::Start with a proxy: convert once, split, downscale the second branch
+master_with_proxy() {
+    "$FFMPEG" -loglevel error -nostdin "${SOURCE[@]}" \
+        -filter_complex "[0:v]$EVEN,format=yuv420p,split=2[vmain][vsrc];[vsrc]scale=-2:$PROXY_HEIGHT:flags=bilinear[vproxy]" \
+        -map "[vmain]" -map 1:a "${MASTER[@]}" "$OUT/master.mp4" \
+        -map "[vproxy]" -map 1:a "${PROXY[@]}" "$OUT/proxy.mp4"
+}
+
+# Two recordings of the same source, each converting and encoding on its own
+two_recordings() {
+    master_only
+    "$FFMPEG" -loglevel error -nostdin "${SOURCE[@]}" -map 0:v -map 1:a \
+        -vf "scale=-2:$PROXY_HEIGHT:flags=bilinear" "${PROXY[@]}" "$OUT/proxy.mp4"
+}
+
+# Children's CPU (cutime + cstime) of this subshell around the run, in seconds
+cpu_of() {
+    local pid=$BASHPID start end
+    start=$(awk '{print $16 + $17}' /proc/$pid/stat)
+    "$@"
+    end=$(awk '{print $16 + $17}' /proc/$pid/stat)
+    awk -v a="$start" -v b="$end" -v hz="$(getconf CLK_TCK)" 'BEGIN { printf "%.2f\n", (b - a) / hz }'
+}
+
+# Relative change of $1 against $2, in percent
+percent() {
+    awk -v a="$1" -v b="$2" 'BEGIN { if (b > 0) printf "%+.1f", 100 * (a - b) / b; else print "n/a" }'
+}
+
+best_of_three() {
+    local best="" t
+    for rep in 1 2 3; do
+        t=$(cpu_of "$@")
+        if [ -z "$best" ] || awk -v t="$t" -v b="$best" 'BEGIN { exit !(t < b) }'; then best=$t; fi
+    done
+    echo "$best"
+}
+
+echo "$SIZE @ $FPS fps, $SECONDS_OF_VIDEO s of video, ${PROXY_HEIGHT}p proxy"
+master=$(best_of_three master_only)
+proxy=$(best_of_three master_with_proxy)
+two=$(best_of_three two_recordings)
+printf "%-28s %8s %12s\n" "setup" "cpu s" "vs master"
+for row in "master only:$master" "master + proxy (one encode):$proxy" "two recordings:$two"; do
+    name=${row%%:*}
+    t=${row##*:}
+    printf "%-28s %8s %11s%%\n" "$name" "$t" "$(percent "$t" "$master")"
+done
+echo "proxy overhead / second recording overhead: $(awk -v p="$proxy" -v m="$master" -v t="$two" 'BEGIN { if (t > m) printf "%.2f", (p - m) / (t - m); else print "n/a" }')"
@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+# SSIM of ROI quantization against plain encoding at the same bitrate, per screen region.
+# bench/RoiCorpus renders the synthetic scene with the ROI map off and on. Both are encoded
+# with x264 (ultrafast, as the recorder runs it), two-pass at the bitrate that the ROI stream
+# reaches at CRF 23. Each encode is then compared with the untouched frames, over the whole
+# frame and over the cursor area, the video area and the log pane.
+#
+# Usage: bench/roi_ssim.sh [path to RoiCorpus]   (default: _gate_build/bench/RoiCorpus)
+# Needs ffmpeg with libx264 on PATH (or $FFMPEG).
+set -euo pipefail
+
+CORPUS=${1:-_gate_build/bench/RoiCorpus}
+FFMPEG=${FFMPEG:-ffmpeg}
+
+if ! command -v "$FFMPEG" >/dev/null 2>&1; then
+    echo "ffmpeg not found (set FFMPEG=...)" >&2
+    exit 77
+fi
+if [ ! -x "$CORPUS" ]; then
+    echo "RoiCorpus not found at $CORPUS (build the bench targets first)" >&2
+    exit 1
+fi
+
+CORPUS=$(realpath "$CORPUS")
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+RAW=(-f rawvideo -pixel_format bgra -video_size 960x540 -framerate 30 -i -)
+X264=(-c:v libx264 -preset ultrafast -pix_fmt yuv420p)
+
+# Regions: name and crop=w:h:x:y (see Render() in RoiCorpus.cpp)
+REGIONS=("frame:960:540:0:0" "cursor area:720:150:220:44" "video:320:180:610:330" "log pane:200:480:10:20")
+
+encode_crf() { # mode output
+    "$CORPUS" "$1" | "$FFMPEG" -loglevel error -nostdin "${RAW[@]}" "${X264[@]}" -crf 23 -y "$2"
+}
+
+encode_bitrate() { # mode kbps output
+    (cd "$OUT" && "$CORPUS" "$1" | "$FFMPEG" -loglevel error -nostdin "${RAW[@]}" "${X264[@]}" -b:v "$2k" -pass 1 -passlogfile "$1" -f null -)
+    (cd "$OUT" && "$CORPUS" "$1" | "$FFMPEG" -loglevel error -nostdin "${RAW[@]}" "${X264[@]}" -b:v "$2k" -pass 2 -passlogfile "$1" -y "$3")
+}
+
+kbps_of() {
+    local bytes
+    bytes=$(stat -c %s "$1")
+    echo $((bytes * 8 / 30 / 1000))
+}
+
+ssim() { # encoded crop
+    "$CORPUS" off | "$FFMPEG" -nostdin -i "$1" "${RAW[@]}" \
+        -lavfi "[0:v]crop=$2,format=yuv420p[a];[1:v]crop=$2,format=yuv420p[b];[a][b]ssim" -f null - 2>&1 |
+        sed -n 's/.*All:\([0-9.]*\).*/\1/p' | tail -1
+}
+
+encode_crf roi "$OUT/roi_crf.mp4"
+target=$(kbps_of "$OUT/roi_crf.mp4")
+encode_crf off "$OUT/off_crf.mp4"
+echo "CRF 23: off $(kbps_of "$OUT/off_crf.mp4") kb/s, roi $target kb/s"
+echo "Two-pass, both at $target kb/s:"
+
+encode_bitrate off "$target" "$OUT/off.mp4"
+encode_bitrate roi "$target" "$OUT/roi.mp4"
+
+printf "%-6s %8s" "" "kb/s"
+for region in "${REGIONS[@]}"; do printf " %12s" "${region%%:*}"; done
+echo
+for mode in off roi; do
+    printf "%-6s %8s" "$mode" "$(kbps_of "$OUT/$mode.mp4")"
+    for region in "${REGIONS[@]}"; do printf " %12s" "$(ssim "$OUT/$mode.mp4" "${region#*:}")"; done
+    echo
+done
+"$CORPUS" roi --stats
@@ -0,0 +1,70 @@
+#!/usr/bin/env bash
+# FFmpeg CPU time for the recorder's encode with 0, 1 and 2 extra UDP stream sinks on
+# localhost (the tee setup VideoEncoder builds for `stream =` lines in settings.ini).
+# The encode happens once whatever the sink count, so the extra sinks should only add
+# muxing and socket writes: a few percent at most.
+#
+# Usage: bench/stream_sinks_cpu.sh [seconds] [WxH] [fps]
+# Needs ffmpeg with libx264 on PATH (or $FFMPEG). Prints user+sys CPU seconds per run.
+set -euo pipefail
+
+SECONDS_OF_VIDEO=${1:-20}
+SIZE=${2:-1920x1080}
+FPS=${3:-30}
+FFMPEG=${FFMPEG:-ffmpeg}
+
+if ! command -v "$FFMPEG" >/dev/null 2>&1; then
+    echo "ffmpeg not found (set FFMPEG=...)" >&2
+    exit 77
+fi
+
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# Relative change of $1 against $2, in percent
+percent() {
+    awk -v a="$1" -v b="$2" 'BEGIN { if (b > 0) printf "%+.1f", 100 * (a - b) / b; else print "n/a" }'
+}
+
+# Same options as VideoEncoder::Start and BuildTeeOutput (plain CRF 23 rate control), with a
+# synthetic BGRA source in place of the frame pipe. The source costs the same in every run,
+# so the differences are the sinks.
+run() {
+    local sinks=$1
+    local output="$OUT/out.mp4"
+    local args=()
+    if [ "$sinks" -gt 0 ]; then
+        local spec="[f=mp4:onfail=abort]$output"
+        for ((i = 0; i < sinks; ++i)); do
+            spec+="|[f=mpegts:onfail=ignore:use_fifo=1:fifo_options=drop_pkts_on_overflow=1\\\\:attempt_recovery=1\\\\:recover_any_error=1]udp://127.0.0.1:$((5000 + i))?pkt_size=1316"
+        done
+        args=(-flags +global_header -f tee "$spec")
+    else
+        args=("$output")
+    fi
+
+    local pid=$BASHPID start end
+    start=$(awk '{print $16 + $17}' /proc/$pid/stat)
+    "$FFMPEG" -loglevel error -nostdin \
+        -f lavfi -i "testsrc2=size=$SIZE:rate=$FPS,format=bgra" \
+        -f lavfi -i "sine=frequency=440:sample_rate=48000" \
+        -map 0:v -map 1:a -vf "scale=trunc(iw/2)*2:trunc(ih/2)*2" \
+        -c:v libx264 -preset ultrafast -crf 23 -c:a aac -b:a 192k -pix_fmt yuv420p -t "$SECONDS_OF_VIDEO" -y \
+        "${args[@]}"
+    end=$(awk '{print $16 + $17}' /proc/$pid/stat)
+    # Clock ticks of finished children (cutime + cstime) -> seconds
+    awk -v a="$start" -v b="$end" -v hz="$(getconf CLK_TCK)" 'BEGIN { printf "%.2f\n", (b - a) / hz }'
+}
+
+echo "$SIZE @ $FPS fps, $SECONDS_OF_VIDEO s of video, libx264 ultrafast"
+printf "%-6s %10s %10s\n" "sinks" "cpu s" "vs 0"
+base=""
+for sinks in 0 1 2; do
+    best=""
+    for rep in 1 2 3; do
+        t=$(run "$sinks")
+        if [ -z "$best" ] || awk -v t="$t" -v b="$best" 'BEGIN { exit !(t < b) }'; then best=$t; fi
+    done
+    [ -z "$base" ] && base=$best
+    printf "%-6s %10s %9s%%\n" "$sinks" "$best" "$(percent "$best" "$base")"
+done
@@ -9,7 +9,8 @@
 
 /**
  * AudioCapture uses Windows WASAPI to capture the default 
- * microphone/input device.
+ * microphone/input device, or the default output in loopback mode.
+ * Several instances can run side by side (e.g. mic + system).
  */
 class AudioCapture {
 public:
@@ -24,6 +25,12 @@ public:
 
     // Reads captured audio samples into the buffer
     bool GetAudioSamples(std::vector<int16_t>& outSamples);
+
+    // Reads captured audio as interleaved float in the device's native rate/channels
+    bool GetAudioSamples(std::vector<float>& outSamples);
+
+    int GetSampleRate() const { return m_pwfx ? (int)m_pwfx->nSamplesPerSec : 0; }
+    int GetChannels() const { return m_pwfx ? (int)m_pwfx->nChannels : 0; }
     
     void Stop();
     void Cleanup();
@@ -36,4 +43,6 @@ private:
     
     WAVEFORMATEX* m_pwfx = nullptr;
     bool m_initialized = false;
+    bool m_comInitialized = false;
+    bool m_isFloat = true;
 };
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * AudioResampler converts interleaved float audio between sample rates
+ * using a polyphase windowed-sinc filter (rational L/M ratio).
+ */
+class AudioResampler {
+public:
+    bool Configure(int inRate, int outRate, int channels, int tapsPerPhase = 32);
+    void Reset();
+
+    // Appends the resampled (interleaved) output for `frames` input frames
+    void Process(const float* interleaved, size_t frames, std::vector<float>& out);
+
+    bool IsPassthrough() const { return m_up == m_down; }
+
+private:
+    int m_channels = 0;
+    int m_taps = 0;
+    int m_up = 1;   // L
+    int m_down = 1; // M
+    int m_phase = 0;
+    size_t m_index = 0;
+
+    std::vector<float> m_coeffs;             // m_up phases x m_taps, time-reversed
+    std::vector<std::vector<float>> m_history; // Planar input, per channel
+};
+
+/**
+ * AudioMixer collects several capture sources, brings them to a common
+ * 48 kHz stereo format and mixes them with per-source gain.
+ * Sources may also be read back individually for multi-track output.
+ */
+class AudioMixer {
+public:
+    static constexpr int kOutputRate = 48000;
+    static constexpr int kOutputChannels = 2;
+
+    // Returns the source index
+    int AddSource(int sampleRate, int channels, float gain = 1.0f);
+    void SetGain(int source, float gain);
+    void Clear();
+
+    // Feed interleaved float samples in the source's native format
+    void PushSamples(int source, const float* interleaved, size_t frames);
+
+    // Produces exactly `frames` stereo frames, the gain-weighted sum of all sources clamped to
+    // [-1, 1]; sources that underrun are padded with silence
+    void Mix(size_t frames, std::vector<float>& out);
+
+    // Same as Mix() but for one source only (gain applied, clamped)
+    void ReadSource(int source, size_t frames, std::vector<float>& out);
+
+    // Drop everything buffered so far (e.g. while paused)
+    void Flush();
+
+    size_t GetSourceCount() const { return m_sources.size(); }
+
+private:
+    struct Source {
+        int channels = 0;
+        float gain = 1.0f;
+        AudioResampler resampler;
+        std::vector<float> scratch;
+        std::vector<float> fifo; // 48 kHz stereo, interleaved
+        size_t fifoRead = 0;
+    };
+
+    std::vector<Source> m_sources;
+    std::vector<float> m_pull;
+
+    void Pull(Source& src, size_t frames, std::vector<float>& out);
+    static void Clamp(std::vector<float>& samples);
+};
+
+// Dispatched by CpuDispatch; the scalar versions are the references
+namespace AudioKernels {
+    // dst[i] += src[i] * gain
+    void MixInto(float* dst, const float* src, size_t count, float gain);
+    void MixInto_Scalar(float* dst, const float* src, size_t count, float gain);
+    void MixInto_SSE2(float* dst, const float* src, size_t count, float gain);
+    void MixInto_AVX2(float* dst, const float* src, size_t count, float gain);
+
+    // Sum of a[i] * b[i] (SIMD levels sum in another order: not bit-exact)
+    float Dot(const float* a, const float* b, size_t count);
+    float Dot_Scalar(const float* a, const float* b, size_t count);
+    float Dot_SSE2(const float* a, const float* b, size_t count);
+    float Dot_AVX2(const float* a, const float* b, size_t count);
+
+    // 16-bit PCM to float in [-1, 1)
+    void S16ToFloat(const int16_t* src, float* dst, size_t count);
+    void S16ToFloat_Scalar(const int16_t* src, float* dst, size_t count);
+    void S16ToFloat_SSE2(const int16_t* src, float* dst, size_t count);
+    void S16ToFloat_AVX2(const int16_t* src, float* dst, size_t count);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "WebcamDevice.hpp"
+#include <memory>
+#include <mutex>
+#include <chrono>
+
+/**
+ * CameraService owns the single webcam session of the app and hands out
+ * subscriptions to it. The camera is opened by the first subscriber and
+ * closed when the last one leaves, so the UI preview keeps it warm across
+ * recordings and the recorder never has to reopen the device.
+ */
+class CameraService {
+public:
+    CameraService() = default;
+    ~CameraService();
+
+    // Returns nullptr if the camera could not be opened
+    std::shared_ptr<WebcamDevice::Subscriber> Subscribe(int outputHeight = 0, int maxFps = 0);
+    void Unsubscribe(std::shared_ptr<WebcamDevice::Subscriber>& subscriber);
+
+    bool IsRunning() const;
+
+private:
+    WebcamDevice m_device;
+    mutable std::mutex m_mutex;
+    int m_refCount = 0;
+};
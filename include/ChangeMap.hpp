@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Frame.hpp"
+
+/**
+ * ChangeMap finds which 16x16 tiles of a BGRA frame changed since the
+ * previous call by hashing every tile (one streaming read of the frame,
+ * no copy of it is kept) and comparing against the stored hashes.
+ * Used where the OS gives no dirty rects, so downstream stages can still
+ * skip untouched tiles.
+ */
+class ChangeMap {
+public:
+    static constexpr int kTileSize = 16;
+
+    // Hashes `frame` and marks tiles whose hash differs from the previous call.
+    // The first call, or one with a new frame size, marks every tile.
+    void Update(const Frame& frame);
+
+    // For a frame that arrived with OS damage relative to the one last passed in: re-hashes
+    // only the tiles `damage` touches, so the stored hashes stay those of the latest frame
+    // and a later Update() diffs against it rather than an older one. Marks the re-hashed
+    // tiles that changed. Falls back to Update() on a size change.
+    void Refresh(const Frame& frame, const std::vector<FrameRect>& damage);
+
+    // Exact variant for lossless consumers: marks the tiles whose pixels differ from
+    // `previous` (BGRA), comparing bytes rather than hashes. A size change marks every
+    // tile. Stored hashes aren't kept current, so don't mix it with Update() on one map.
+    void Diff(const Frame& frame, const Frame& previous);
+
+    int TilesX() const { return m_tilesX; }
+    int TilesY() const { return m_tilesY; }
+    bool IsChanged(int tx, int ty) const {
+        size_t i = (size_t)ty * m_tilesX + tx;
+        return (m_bits[i >> 6] >> (i & 63)) & 1;
+    }
+    size_t ChangedCount() const { return m_changed; }
+
+    // One bit per tile, row-major
+    const std::vector<uint64_t>& Bits() const { return m_bits; }
+
+    // Changed tiles as rects (horizontal runs merged), clipped to the frame
+    void ToRects(std::vector<FrameRect>& out) const;
+
+    void Reset();
+
+    /**
+     * Hashes one tile (w x h pixels, up to 16 x 16). Every pixel column keeps
+     * Fletcher sums (s1 += pixel, s2 += s1 down the rows), which no single
+     * changed pixel can leave equal, plus s3 += a non-linear 16-bit multiply
+     * mix of the pixel keyed with its row, so offsetting changes to several
+     * pixels don't cancel out either. The 48 sums are folded to 64 bits; all
+     * 16 rows are summed in registers.
+     * Dispatched by CpuDispatch; the scalar version is the bit-exact reference.
+     */
+    static uint64_t HashTile(const uint8_t* src, int stride, int w, int h);
+    static uint64_t HashTile_Scalar(const uint8_t* src, int stride, int w, int h);
+    static uint64_t HashTile_SSE2(const uint8_t* src, int stride, int w, int h);
+    static uint64_t HashTile_AVX2(const uint8_t* src, int stride, int w, int h);
+
+private:
+    bool Resize(const Frame& frame); // True if the size changed (all hashes dropped)
+    void HashTiles(const Frame& frame, int tx0, int ty0, int tx1, int ty1, bool force);
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    size_t m_changed = 0;
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint64_t> m_bits;
+};
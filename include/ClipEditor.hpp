@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * ClipEditor trims and splits finished recordings without re-encoding them.
+ * Cuts are stream copies that start on a keyframe. With frameAccurate set,
+ * only the partial GOP between the requested start and the next keyframe is
+ * re-encoded and joined to the copied remainder, so even hour-long files
+ * take seconds. Runs FFmpeg as a child process like VideoEncoder does; the
+ * same code runs on Windows and Linux.
+ */
+class ClipEditor {
+public:
+    // How a [start, end) cut is carried out, given the video's keyframe times
+    struct CutPlan {
+        double copyStart = 0.0;    // Keyframe the stream copy starts at
+        bool reencodeHead = false; // Re-encode [start, copyStart) and join it to the copy
+        bool reencodeAll = false;  // No keyframe inside the range: re-encode all of it
+    };
+
+    explicit ClipEditor(std::string ffmpegPath) : m_ffmpeg(std::move(ffmpegPath)) {}
+
+    // end < 0 keeps everything from `start` to the end of the file.
+    // Without frameAccurate the output starts on the last keyframe at or before `start`;
+    // with it, exactly on `start`.
+    bool Trim(const std::string& input, const std::string& output, double start, double end, bool frameAccurate);
+
+    // Two files: [0, at) and [at, end). Without frameAccurate both cut on the last keyframe
+    // at or before `at`, so no frame ends up in both.
+    bool Split(const std::string& input, double at, const std::string& firstOutput,
+               const std::string& secondOutput, bool frameAccurate);
+
+    // Presentation times (seconds) of the first video stream's keyframes, ascending.
+    // Reads packets only; nothing is decoded. Also reports the frame duration (seconds).
+    bool ListKeyframes(const std::string& input, std::vector<double>& times, double* frameDuration = nullptr);
+
+    static CutPlan Plan(const std::vector<double>& keyframes, double start, double end, bool frameAccurate);
+
+    const std::string& LastError() const { return m_error; }
+
+private:
+    std::string m_ffmpeg;
+    std::string m_error;
+
+    bool Run(const std::string& args, std::string* output = nullptr);
+};
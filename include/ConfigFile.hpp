@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * ConfigFile reads the optional settings file: one `key = value` per line,
+ * `#` starts a comment, blank lines are ignored and a key may repeat (the
+ * list getters return every value in file order; the others the last one).
+ * Keys are case-sensitive. Lines that can't be parsed, and values of the
+ * wrong type, are reported through Warnings() and otherwise ignored, so a
+ * typo never stops the recorder from starting.
+ */
+class ConfigFile {
+public:
+    // False if the file can't be read (a missing file is not an error for callers)
+    bool Load(const std::string& path);
+    void Parse(const std::string& text);
+
+    bool Has(const std::string& key) const;
+
+    // `fallback` when the key is absent or its value isn't of the type
+    std::string GetString(const std::string& key, const std::string& fallback = "") const;
+    bool GetBool(const std::string& key, bool fallback) const;   // true/false, yes/no, on/off, 1/0
+    int GetInt(const std::string& key, int fallback) const;
+    float GetFloat(const std::string& key, float fallback) const; // Decimal, e.g. 0.5
+    std::vector<std::string> GetAll(const std::string& key) const;
+
+    const std::vector<std::string>& Warnings() const { return m_warnings; }
+
+private:
+    std::vector<std::pair<std::string, std::string>> m_entries; // File order
+    mutable std::vector<std::string> m_warnings;
+};
@@ -4,7 +4,8 @@
 #include <string>
 #include <functional>
 #include <vector>
-#include "WebcamDevice.hpp"
+#include "CameraService.hpp"
+#include "PreviewSink.hpp"
 
 /**
  * Controller manages the Win32 UI window and user interactions.
@@ -15,7 +16,11 @@ public:
         int width = 0;
         int height = 0;
         bool recordAudio = true;
-        bool useSystemAudio = false; // false = Mic, true = System
+        bool useMicAudio = true;     // Narration
+        bool useSystemAudio = false; // Application sound (loopback), mixed with the mic if both are on
+        bool separateAudioTracks = false; // Mic and system as two tracks instead of one mix; settings.ini separate_audio_tracks
+        float micGain = 1.0f;     // Linear, applied before mixing; settings.ini mic_gain
+        float systemGain = 1.0f;  // settings.ini system_gain
         bool showHighlight = true;
         bool showLiveHighlight = true;
         bool showCursor = true;
@@ -25,6 +30,15 @@ public:
         bool useCustomArea = false;
         RECT customRegion = {0}; 
         POINT webcamPos = {0, 0}; // Screen coordinates of webcam preview
+        int webcamHeight = 0;     // PIP height in pixels (0 = 20% of the capture height)
+        bool spoolRecording = false; // Capture to a spool file now, encode the MP4 after stopping (weak CPUs); settings.ini spool_recording
+        std::vector<std::string> streamSinks; // Extra outputs of the same encode (e.g. rtmp://127.0.0.1/live/x); settings.ini stream
+        int proxyHeight = 0;      // Also write <name>_proxy.mp4 at this height (0 = off); settings.ini proxy_height
+        int seekIndexInterval = 10; // Seconds between seek index entries + forced keyframes (0 = no .idx sidecar)
+        bool roiQuantization = false; // Coarsen continuously changing areas away from the cursor (lower bitrate); settings.ini roi
+        bool adaptiveRateControl = true; // VBV cap, long GOP, scene-change keyframes (false = plain CRF 23)
+        int idlePauseSeconds = 0; // Stop encoding after this long without screen, cursor or audio activity (0 = off); settings.ini idle_pause
+        bool exportFrames = false; // Publish the output frames in shared memory for local tools (FrameExport); settings.ini export_frames
     };
 
     Controller();
@@ -37,14 +51,25 @@ public:
     std::string GetSavePath() const { return m_savePath; }
 
     // Callbacks to talk back to our recording engine
+    void SetOnPrepareCallback(std::function<void()> callback) { m_onPrepare = callback; } // Window shown or sources changed while idle: warm up
     void SetOnStartCallback(std::function<void()> callback) { m_onStart = callback; }
     void SetOnStopCallback(std::function<void()> callback) { m_onStop = callback; }
     void SetOnPauseCallback(std::function<bool(bool)> callback) { m_onPause = callback; } // Returns success
+    // Fired whenever a setting that may change mid-recording changes (highlight, cursor, webcam geometry)
+    void SetOnSettingsChangedCallback(std::function<void(const Settings&)> callback) { m_onSettingsChanged = callback; }
 
-    // Update the live preview from external source (e.g. RecordingThread)
-    void SetPreviewFrame(const std::vector<uint8_t>& frame, int w, int h);
     void SetWebcamEnabled(bool enabled);
 
+    // Any thread: the engine stopped a recording on its own (e.g. disk full); the UI returns to
+    // idle and shows `message`
+    void NotifyRecordingFailed(const std::string& message);
+
+    // Shared camera session (UI preview + recorder subscribe to the same device)
+    CameraService& GetCameraService() { return m_camera; }
+
+    // The recorder drops a throttled, downscaled copy of its output here for the live preview
+    PreviewSink& GetOutputPreview() { return m_outputPreview; }
+
     HWND GetWebcamPreviewWindow() const { return m_hwndWebcamPreview; }
     HWND GetWindowHandle() const { return m_hwnd; }
     bool IsRecording() const { return m_isRecording; }
@@ -62,6 +87,7 @@ private:
     HWND m_btnPause = nullptr; // New Pause Button
     HWND m_comboRes = nullptr;
     HWND m_checkAudio = nullptr;
+    HWND m_checkSystemAudio = nullptr;
     HWND m_checkHighlight = nullptr;
     HWND m_checkLiveHighlight = nullptr;
     HWND m_checkCursor = nullptr;
@@ -79,11 +105,13 @@ private:
     HWND m_btnShowFolder = nullptr;
     HWND m_labelSavePath = nullptr;
     HWND m_labelCaptureArea = nullptr;
+    HWND m_outputPreviewCtl = nullptr;
 
-    WebcamDevice m_webcamPreview;
-    std::vector<uint8_t> m_previewFrame;
-    int m_previewW = 0;
-    int m_previewH = 0;
+    CameraService m_camera;
+    std::shared_ptr<WebcamDevice::Subscriber> m_previewCamera;
+    WebcamDevice::FrameView m_previewView;   // Mapped from m_previewCamera, UI thread only
+    PreviewSink m_outputPreview;
+    PreviewSink::FrameView m_outputView;     // Mapped from m_outputPreview, UI thread only
 
     bool m_isRecording = false;
     bool m_isPaused = false;
@@ -93,11 +121,18 @@ private:
     DWORD m_pauseStartTime = 0;
     DWORD m_totalPausedTime = 0;
     Settings m_settings;
+    bool m_warm = false;       // m_onPrepare fired for m_warmSettings and no recording started since
+    Settings m_warmSettings;
 
+    std::function<void()> m_onPrepare;
     std::function<void()> m_onStart;
     std::function<void()> m_onStop;
     std::function<bool(bool)> m_onPause;
+    std::function<void(const Settings&)> m_onSettingsChanged;
 
+    void LoadConfig(); // Optional settings.ini in the save folder
+    void ReadControls(); // Control states -> m_settings
+    void Prewarm();      // While idle: m_onPrepare if the session settings differ from the warm ones
     void UpdateButtonState();
     void StartCountdown();
     void UpdateTimer();
@@ -105,6 +140,9 @@ private:
     void Relayout(int width, int height);
     void ToggleWebcamPreview(bool show);
     void CreateWebcamPreviewWindow();
+    void ToggleOutputPreview(bool show);
+    void SyncWebcamGeometry();   // Preview window rect -> webcamPos / webcamHeight
+    void PublishLiveSettings();
 
     void CreateCaptureIndicatorWindow();
     void ToggleCaptureIndicator(bool show, RECT region);
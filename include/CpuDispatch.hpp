@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// x86 builds compile every kernel variant; cpuid decides at runtime which ones run.
+// AVX2 variants are built for AVX2 per function, so the rest of the binary keeps its baseline;
+// they end with _mm256_zeroupper() (compilers don't add it for per-function targets) so the
+// SSE code running after them doesn't pay the AVX-SSE transition penalty.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSR_X86_SSE2 1
+#define SSR_X86_AVX2 1
+#if defined(__GNUC__)
+#define SSR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SSR_TARGET_AVX2
+#endif
+#endif
+
+/**
+ * CpuDispatch detects the CPU once and binds one function pointer per hot
+ * kernel: the pixel, tile and audio loops the recorder runs every frame or
+ * every packet. The owning modules keep their public entry points (e.g.
+ * PixelConvert::YuvRowToBGRA) and forward through the table, with the
+ * `_Scalar` variant as the reference every other level must match.
+ *
+ * SSR_FORCE_ISA=scalar|sse2|avx2 in the environment caps the level (it
+ * never goes above what the CPU supports), for benchmarks and A/B checks.
+ */
+namespace CpuDispatch {
+    enum class Isa { Scalar = 0, SSE2 = 1, AVX2 = 2 };
+
+    struct Kernels {
+        Isa isa;
+
+        // Pixels (BGRA rows)
+        void (*copyRow)(uint8_t* dst, const uint8_t* src, size_t bytes);              // Capture damage, overlay restore, PIP blit
+        void (*blendRow)(uint8_t* px, int count, uint32_t bgra);                      // Click highlight (alpha from `bgra`)
+        void (*cursorRow)(uint32_t* px, const uint8_t* shape, int count);             // Cursor bitmap (0 keep, 1 black, 2 white)
+        void (*scaleRow)(uint32_t* dst, const uint32_t* src, const int* xMap, int count); // Webcam nearest-neighbour scale
+        void (*yuvRowToBGRA)(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count);
+        void (*smooth2x2)(uint8_t* row0, uint8_t* row1, int pixels);                  // ROI pre-quantization
+        uint64_t (*hashTile)(const uint8_t* src, int stride, int w, int h);           // Change map
+        int (*runLength)(const uint32_t* px, int count, uint32_t value);              // Screen codec
+
+        // Audio
+        void (*s16ToFloat)(const int16_t* src, float* dst, size_t count);
+        void (*mixInto)(float* dst, const float* src, size_t count, float gain);
+        float (*dot)(const float* a, const float* b, size_t count);
+    };
+
+    // Bound on first use (thread-safe) from Detected(), capped by SSR_FORCE_ISA
+    const Kernels& Get();
+
+    Isa Detected(); // Best level the CPU and OS support
+
+    // Rebinds the table to `isa` (capped by Detected()); returns the level now active.
+    // Only while no other thread runs kernels: benchmarks and A/B checks.
+    Isa Force(Isa isa);
+
+    const char* Name(Isa isa);
+    bool Parse(const std::string& name, Isa& isa); // "scalar", "sse2", "avx2" (case-insensitive)
+
+    // "avx2 (detected avx2)", "sse2 (forced, detected avx2)", for the startup log
+    std::string Describe();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <chrono>
+
+/**
+ * EngineControl is the only channel between the UI and the recording
+ * engine. The UI posts commands; the engine thread blocks on them (with a
+ * deadline while it is pacing frames) and publishes its state, so an idle
+ * or paused engine sleeps in the kernel instead of polling flags.
+ */
+class EngineControl {
+public:
+    enum class State {
+        Idle,       // Nothing open; blocked waiting for a command
+        Warming,    // Devices and encoder being readied / ready, not recording yet
+        Recording,
+        Paused,     // No capture or encode work at all
+        Finalizing  // Flushing the encoder and releasing devices
+    };
+
+    enum class Command {
+        Prepare,  // Warm up ahead of Start; while warm, warm up again (sources changed)
+        Start,
+        Pause,
+        Resume,
+        Stop,
+        Shutdown
+    };
+
+    // Any thread
+    void Post(Command command);
+    State GetState() const { return m_state.load(std::memory_order_acquire); }
+
+    // --- Engine thread ---
+
+    // Blocks until a command is queued
+    Command WaitCommand();
+
+    // Blocks until a command is queued or `deadline` passes; returns false on timeout
+    bool WaitCommandUntil(std::chrono::steady_clock::time_point deadline, Command& out);
+
+    void SetState(State state);
+
+    // Blocks while the engine is in `state` (e.g. the audio worker while paused); returns the new state
+    State WaitWhileState(State state);
+    State WaitWhileState(State a, State b); // While in either (any thread, e.g. a transcode while a recording runs)
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_commandCv;
+    std::condition_variable m_stateCv;
+    std::deque<Command> m_commands;
+    std::atomic<State> m_state{ State::Idle };
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "PixelConvert.hpp"
+
+/**
+ * Rectangle in frame pixel coordinates.
+ */
+struct FrameRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool Empty() const { return width <= 0 || height <= 0; }
+    bool Intersects(const FrameRect& o) const {
+        return !Empty() && !o.Empty() && x < o.x + o.width && o.x < x + width && y < o.y + o.height && o.y < y + height;
+    }
+    FrameRect Intersect(const FrameRect& o) const;
+    FrameRect Union(const FrameRect& o) const; // Bounding box; empty rects are ignored
+};
+
+/**
+ * Frame is a non-owning view of an image: pointer, row stride, format,
+ * size, capture timestamp, sequence number and damage. Copying a Frame
+ * never copies pixels, and Crop() yields a sub-rect view of the same
+ * memory, so stages can hand frames along without repacking them.
+ */
+struct Frame {
+    uint8_t* data = nullptr;
+    int stride = 0;  // Bytes between the starts of two rows (may exceed width * 4)
+    int width = 0;
+    int height = 0;
+    PixelConvert::Format format = PixelConvert::Format::BGRA;
+    int64_t timestampUs = 0; // steady_clock time the pixels were captured
+    uint64_t sequence = 0;   // Changes whenever the pixels change; same sequence = same image
+
+    // Areas that changed since the previous sequence, in this frame's coordinates.
+    // nullptr = unknown (treat the whole frame as changed); owned by the producer.
+    const std::vector<FrameRect>* damage = nullptr;
+
+    // Packed BGRA view of a caller-owned buffer (resized to fit)
+    static Frame Wrap(std::vector<uint8_t>& pixels, int width, int height);
+
+    bool Empty() const { return !data || width <= 0 || height <= 0; }
+    bool IsPacked() const { return stride == width * 4; }
+    FrameRect Bounds() const { return { 0, 0, width, height }; }
+
+    uint8_t* Row(int y) const { return data + (size_t)y * stride; }
+    uint8_t* Pixel(int x, int y) const { return Row(y) + (size_t)x * 4; } // BGRA only
+
+    // Sub-rect view (BGRA only); clipped to the frame. Damage is not carried over.
+    Frame Crop(const FrameRect& rect) const;
+
+    // Copies pixels into `dst` (same size, BGRA), honouring both strides
+    void CopyTo(const Frame& dst) const;
+    void CopyRectTo(const Frame& dst, const FrameRect& rect) const;
+};
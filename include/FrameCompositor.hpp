@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Frame.hpp"
+
+/**
+ * FrameCompositor keeps the output frame in sync with the pristine screen
+ * image without recopying it every frame. Only what the capture reports as
+ * damaged is copied in, and the areas last frame's overlays (cursor,
+ * highlight, PIP) were drawn into are restored from the pristine image
+ * before this frame's overlays go on top, so overlay cost scales with
+ * overlay area rather than screen area.
+ */
+class FrameCompositor {
+public:
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t fullCopies = 0;
+        uint64_t bytesCopied = 0; // Damage + overlay restore traffic
+        uint64_t frameBytes = 0;  // What copying every frame in full would have cost
+    };
+
+    // Brings the output up to date with `screen` (pristine, read-only) and removes last
+    // frame's overlays. Returns the output (width x height) to draw this frame's overlays into.
+    Frame Begin(const Frame& screen, int width, int height);
+
+    // Area an overlay was drawn into this frame; restored from the pristine image next frame
+    void AddOverlay(const FrameRect& rect);
+
+    // Where this output differs from the previous one, overlays included (call after the
+    // overlays were added); nullptr = everywhere
+    const std::vector<FrameRect>* Damage();
+
+    Stats GetStats() const { return m_stats; }
+    void Reset();
+
+private:
+    std::vector<uint8_t> m_pixels;
+    Frame m_output;
+    uint64_t m_sequence = 0;           // Screen sequence the output currently reflects
+    std::vector<FrameRect> m_overlays; // Drawn last frame
+    std::vector<FrameRect> m_drawn;    // Drawn this frame
+    std::vector<FrameRect> m_changed;  // Copied from the screen this frame
+    std::vector<FrameRect> m_damage;
+    bool m_changedAll = true;
+    Stats m_stats;
+
+    void Copy(const Frame& screen, const FrameRect& rect);
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Frame.hpp"
+
+/**
+ * FrameExport publishes the composited output frames in shared memory
+ * (a named file mapping on Windows, POSIX shm elsewhere) so local tools
+ * can read them without capturing the screen again.
+ *
+ * The mapping holds a header and a ring of slots. Each slot is guarded by a
+ * seqlock: the writer makes the slot's sequence odd, copies the frame in,
+ * and makes it even again. Readers never take a lock and never stall the
+ * writer; they read the pixels in place and then check that the sequence
+ * didn't move. With kSlots slots a reader has kSlots - 1 frame intervals
+ * before the writer comes back around to the slot it is reading.
+ *
+ * A slot is brought up to date with the damage of the frames since it was
+ * last written rather than recopied, and nothing is copied at all while no
+ * reader has checked in during the last second.
+ */
+class FrameExport {
+public:
+    static constexpr char kMagic[8] = { 'S', 'S', 'R', 'F', 'R', 'A', 'M', 'E' };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kSlots = 3;
+    static constexpr int64_t kReaderTimeoutUs = 1000000;
+
+    struct alignas(64) SlotHeader {
+        std::atomic<uint64_t> seqlock; // Odd while the slot is being written
+        uint64_t frameNumber;          // Output frame index
+        int64_t timestampUs;           // steady_clock capture time
+        uint64_t captureSequence;      // Frame::sequence: equal = same screen image
+        int32_t width;
+        int32_t height;
+        int32_t stride;
+        int32_t format;                // PixelConvert::Format (always BGRA today)
+    };
+
+    struct alignas(64) Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t slotCount;
+        int32_t maxWidth;
+        int32_t maxHeight;
+        uint64_t slotBytes;                 // Pixel capacity of each slot
+        uint64_t pixelsOffset;              // From the start of the mapping to slot 0's pixels
+        std::atomic<uint64_t> published;    // Frames published so far; the newest is in slot (published - 1) % slotCount
+        std::atomic<int64_t> readerSeenUs;  // steady_clock time of the latest reader visit
+        std::atomic<uint32_t> closed;       // Writer went away; reopen to follow a new one
+        SlotHeader slots[kSlots];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+
+    struct Stats {
+        uint64_t published = 0;
+        uint64_t skipped = 0;    // No reader around
+        uint64_t fullCopies = 0; // Damage unknown or too large
+        uint64_t bytes = 0;      // Pixels copied into slots
+        uint64_t frameBytes = 0; // What copying every published frame in full would have cost
+        uint64_t publishUs = 0;
+    };
+
+    ~FrameExport();
+
+    // Creates (or takes over) the mapping `name`, sized for frames up to maxWidth x maxHeight
+    bool Open(const std::string& name, int maxWidth, int maxHeight);
+    void Close();
+
+    bool IsOpen() const { return m_header != nullptr; }
+    bool Fits(int width, int height) const {
+        return m_header && width <= m_header->maxWidth && height <= m_header->maxHeight;
+    }
+
+    // Writes `frame` (BGRA) into the next slot; a no-op while no reader is attached.
+    // frame.damage must be relative to the frame passed to the previous call.
+    bool Publish(const Frame& frame, uint64_t frameNumber);
+
+    Stats GetStats() const { return m_stats; }
+
+    static std::string DefaultName() { return "SimpleScreenRecorder.frames"; }
+    static int64_t NowUs(); // steady_clock, comparable across processes (QPC / CLOCK_MONOTONIC)
+
+private:
+    std::string m_name;
+    void* m_handle = nullptr; // Windows HANDLE (the POSIX fd is closed once mapped)
+    Header* m_header = nullptr;
+    uint64_t m_size = 0;
+    Stats m_stats;
+
+    // Damage each slot has missed since it was last written
+    std::vector<FrameRect> m_pending[kSlots];
+    uint64_t m_pendingArea[kSlots] = {};
+    bool m_pendingAll[kSlots] = {};
+
+    void AddDamage(const std::vector<FrameRect>* damage, const FrameRect& bounds);
+};
+
+/**
+ * Reader side of FrameExport. Acquire() hands out a view straight into the
+ * shared slot; check Valid() after using the pixels (a false result means
+ * the writer lapped the reader and the frame must be dropped). The mapping
+ * is opened read-write because check-ins are stored in the header.
+ */
+class FrameExportReader {
+public:
+    struct Token {
+        uint32_t slot = 0;
+        uint64_t seqlock = 0;
+        uint64_t published = 0;   // Publish count when acquired; pass as `after` to wait for a newer frame
+        uint64_t frameNumber = 0; // Output frame index within the recording
+    };
+
+    ~FrameExportReader();
+
+    bool Open(const std::string& name = FrameExport::DefaultName());
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    // Writer closed the export (the recorder may open a new one later)
+    bool WriterClosed() const { return m_header && m_header->closed.load(std::memory_order_acquire) != 0; }
+
+    // Newest frame if more than `after` frames were published (0 = any); never waits
+    bool Acquire(Frame& out, Token& token, uint64_t after = 0);
+
+    // True if the slot still holds the acquired frame, i.e. everything read from it was consistent
+    bool Valid(const Token& token) const;
+
+private:
+    void* m_handle = nullptr;
+    FrameExport::Header* m_header = nullptr;
+    uint64_t m_size = 0;
+};
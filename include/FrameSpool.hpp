@@ -0,0 +1,148 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include "Frame.hpp"
+#include "ScreenCodec.hpp"
+
+/**
+ * FrameSpool is the "capture now, encode later" sink. Frames go into a
+ * preallocated memory-mapped file as plain stores: a keyframe every ten
+ * seconds, otherwise only the 16x16 tiles that changed, both losslessly
+ * compressed with ScreenCodec, or a zero-byte repeat record. Audio tracks
+ * go to raw f32le side files. FrameSpoolReader replays the spool for the transcoder.
+ *
+ * Layout: a 4 KiB FileHeader, then 8-byte aligned records (RecordHeader +
+ * payload), then the frame index (one file offset per frame). A spool
+ * that was never finished has no index and is recovered by scanning.
+ */
+class FrameSpool {
+public:
+    enum RecordType : uint32_t {
+        Key = 1,    // ScreenCodec stream covering the whole frame
+        Delta = 2,  // ScreenCodec stream of the tiles changed since the previous frame
+        Repeat = 3  // Same image as the previous frame
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        int32_t fps;
+        int32_t targetWidth;  // Output scaling for the transcode (same meaning as VideoEncoder::Start)
+        int32_t targetHeight;
+        int32_t audioTracks;
+        uint32_t keyInterval;
+        uint64_t frameCount;
+        uint64_t indexOffset; // 0 = unfinished
+        uint64_t dataEnd;
+        uint32_t flags;       // Flags below, fixed when the recording started (version 3+)
+    };
+
+    enum Flags : uint32_t {
+        AdaptiveRateControl = 1 // Transcode with RateController::Offline instead of fixed CRF
+    };
+
+    struct RecordHeader {
+        uint32_t type;
+        uint32_t changedTiles; // 16x16 tiles that differ from the previous frame (rate control input)
+        uint64_t payloadBytes;
+        int64_t timestampUs;
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t keyFrames = 0;
+        uint64_t deltaFrames = 0;
+        uint64_t repeatFrames = 0;
+        uint64_t bytesWritten = 0; // Video records incl. headers
+        uint64_t rawBytes = 0;     // What uncompressed frames would have taken
+        uint64_t writeUs = 0;      // Time spent in WriteFrame (change map, compression, stores)
+    };
+
+    static constexpr char kMagic[8] = { 'S', 'S', 'R', 'S', 'P', 'O', 'O', 'L' };
+    static constexpr uint32_t kVersion = 3;
+    static constexpr uint32_t kOldestVersion = 2; // Read as having no flags set
+    static constexpr uint64_t kHeaderBytes = 4096;
+
+    FrameSpool() = default;
+    ~FrameSpool();
+
+    bool Create(const std::string& path, int width, int height, int fps,
+                int targetWidth = 0, int targetHeight = 0, int audioTracks = 0, uint32_t flags = 0);
+
+    // BGRA at the size passed to Create(); same contract as VideoEncoder::WriteFrame. Once it
+    // fails to grow the file (disk full) the spool is closed to frames: stop and Finish()
+    bool WriteFrame(const Frame& frame);
+
+    // Interleaved 48 kHz stereo float samples; safe to call from another thread than WriteFrame
+    bool WriteAudio(int track, const std::vector<float>& samples);
+
+    // Writes the index and trims the file to its content; every frame WriteFrame() accepted is kept
+    void Finish();
+
+    // Finish() and delete the spool and its audio files
+    void Discard();
+
+    bool IsOpen() const { return m_view != nullptr; }
+    Stats GetStats() const { return m_stats; }
+
+    static std::string AudioPath(const std::string& spoolPath, int track);
+
+private:
+    std::string m_path;
+    void* m_file = nullptr;    // Windows HANDLE
+    void* m_mapping = nullptr; // Windows HANDLE
+    uint8_t* m_view = nullptr;
+    uint64_t m_capacity = 0;
+    uint64_t m_used = 0;
+
+    FileHeader m_header = {};
+    std::vector<uint64_t> m_index;
+    std::vector<std::FILE*> m_audio;
+    ScreenCodec m_codec;
+    std::vector<uint8_t> m_encoded;
+    Stats m_stats;
+
+    bool Map(uint64_t capacity);
+    void Unmap();
+    uint8_t* Reserve(uint64_t bytes); // Grows the mapping as needed
+};
+
+/**
+ * Sequential reader for a spool file; reconstructs each frame into its own
+ * canvas. Works on unfinished spools (index rebuilt by scanning records).
+ */
+class FrameSpoolReader {
+public:
+    ~FrameSpoolReader();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const FrameSpool::FileHeader& Info() const { return m_header; }
+    size_t FrameCount() const { return m_index.size(); }
+
+    // Next frame as a view of the internal canvas; false at the end or on a damaged record
+    bool Next(Frame& out);
+
+    // Changed share (0..1) of every frame, from the record headers alone
+    void ChangedFractions(std::vector<float>& out) const;
+
+private:
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+    const uint8_t* m_view = nullptr;
+    uint64_t m_size = 0;
+
+    FrameSpool::FileHeader m_header = {};
+    std::vector<uint64_t> m_index;
+    size_t m_next = 0;
+    std::vector<uint8_t> m_pixels;
+    Frame m_canvas;
+
+    void Scan();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "Frame.hpp"
+#include "PlatformTypes.hpp"
+
+/**
+ * IdleDetector decides, once per frame slot, whether the recording is
+ * idle: no screen change larger than a caret blink, no cursor movement
+ * and audio below a silence threshold for `idleSeconds`. While idle the
+ * engine neither composites nor encodes. The first active frame resumes
+ * at once, after a short pre-roll of the held image (and held audio) so
+ * whatever started the activity isn't clipped. The pre-roll never covers
+ * more time than the idle period did, as the audio thread can't have held
+ * more audio than that.
+ *
+ * Update() runs on the engine thread; the audio thread reports its level
+ * and checks IsIdle() lock-free.
+ */
+class IdleDetector {
+public:
+    enum class Action {
+        Record, // Composite and encode as usual
+        Skip,   // Idle: capture for detection only
+        Resume  // Activity after idling: write ResumeFrames() of the last output first
+    };
+
+    struct Stats {
+        uint64_t idlePeriods = 0;
+        uint64_t skippedFrames = 0;
+    };
+
+    static constexpr double kPrerollSeconds = 0.5;
+    static constexpr float kSilenceRms = 0.003f; // About -50 dBFS
+    static constexpr int64_t kMinChangedPixels = 256; // One 16x16 tile: caret blinks, tray clocks
+
+    // idleSeconds <= 0 disables detection (Update() always returns Record)
+    void Configure(int fps, int idleSeconds);
+    void Reset();
+
+    // `screen` is this slot's capture (damage set for a new sequence), `screenChanged`
+    // whether its sequence differs from the previous slot's
+    Action Update(const Frame& screen, bool screenChanged, POINT mouse);
+
+    int PrerollFrames() const { return m_prerollFrames; }
+    // Pre-roll for the Resume just returned: PrerollFrames(), capped at the slots skipped
+    // in the idle period that ended, so video stays in step with the held audio
+    int ResumeFrames() const { return m_periodSkipped < m_prerollFrames ? (int)m_periodSkipped : m_prerollFrames; }
+    bool IsIdle() const { return m_idle.load(std::memory_order_acquire); }
+    void SetAudioLevel(float rms) { m_audioRms.store(rms, std::memory_order_relaxed); }
+    Stats GetStats() const { return m_stats; }
+
+private:
+    int64_t m_idleFrames = 0; // 0 = off
+    int m_prerollFrames = 0;
+    int64_t m_quietFrames = 0;
+    int64_t m_periodSkipped = 0; // Slots skipped in the current (or last) idle period
+    POINT m_lastMouse = { 0, 0 };
+    bool m_haveMouse = false;
+    std::atomic<bool> m_idle{ false };
+    std::atomic<float> m_audioRms{ 0.0f };
+    Stats m_stats;
+};
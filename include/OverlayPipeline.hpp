@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Frame.hpp"
+#include "PlatformTypes.hpp"
+
+class RoiMap;
+class FrameCompositor;
+
+/**
+ * OverlayPipeline draws the per-frame overlays into the composited output:
+ * ROI pre-quantization, then the click highlight, then the cursor. Every
+ * combination of enabled overlays is its own template instantiation, so the
+ * frame loop makes one call into straight-line code. The feature checks
+ * happen in Configure(): once at recording start and again only when the
+ * live settings change.
+ */
+class OverlayPipeline {
+public:
+    struct Features {
+        bool roi = false;
+        bool highlight = false;
+        bool cursor = false;
+    };
+
+    struct Input {
+        POINT mouse = { 0, 0 };                          // Output coordinates
+        const std::vector<FrameRect>* damage = nullptr;  // Screen damage this frame (nullptr = unknown)
+    };
+
+    OverlayPipeline();
+
+    // Selects the instantiation for `features`
+    void Configure(const Features& features);
+    Features GetFeatures() const { return m_features; }
+
+    // Draws into `out` and registers every area it touched with `compositor`
+    void Run(const Frame& out, const Input& input, RoiMap& roi, FrameCompositor& compositor) {
+        m_stage(*this, out, input, roi, compositor);
+    }
+
+private:
+    using Stage = void (*)(OverlayPipeline&, const Frame&, const Input&, RoiMap&, FrameCompositor&);
+
+    template <bool Roi, bool Highlight, bool Cursor>
+    static void RunStage(OverlayPipeline& self, const Frame& out, const Input& input, RoiMap& roi, FrameCompositor& compositor);
+
+    Features m_features;
+    Stage m_stage;
+    std::vector<FrameRect> m_touched; // ROI output, reused between frames
+};
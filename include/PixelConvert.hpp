@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * PixelConvert turns camera frames in their native layout into BGRA.
+ * Conversion is fused with the downscale: only the source pixels that
+ * land in the output are ever converted, so a full-size RGB image is
+ * never produced. Pure CPU code with no OS dependencies.
+ */
+class PixelConvert {
+public:
+    enum class Format {
+        BGRA, // 32-bit, also covers MF RGB32
+        NV12, // 8-bit Y plane followed by interleaved UV at half resolution
+        YUY2  // Packed Y0 U Y1 V
+    };
+
+    /**
+     * Converts `src` (srcW x srcH, `srcStride` bytes per Y/packed row) to
+     * BGRA at dstW x dstH using nearest-neighbour sampling. `src` is the top
+     * row; a negative stride walks a bottom-up image. For NV12, `uvPlane` is
+     * the start of the UV plane (same stride), which may sit after padding
+     * rows; nullptr means directly after srcH rows of Y.
+     */
+    static void ConvertScaled(const uint8_t* src, int srcStride, int srcW, int srcH, Format format,
+                              uint8_t* dst, int dstStride, int dstW, int dstH,
+                              const uint8_t* uvPlane = nullptr);
+
+    /**
+     * Converts `count` full-resolution Y/U/V samples to BGRA (BT.601, limited range).
+     * Dispatched by CpuDispatch; the scalar version is the bit-exact reference.
+     */
+    static void YuvRowToBGRA(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count);
+    static void YuvRowToBGRA_Scalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count);
+    static void YuvRowToBGRA_SSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count);
+    static void YuvRowToBGRA_AVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count);
+
+    /**
+     * dst[x] = src[xMap[x]] with alpha forced to 255 (one BGRA row of the scaler).
+     * Dispatched by CpuDispatch; the scalar version is the bit-exact reference.
+     */
+    static void ScaleRowBGRA(uint32_t* dst, const uint32_t* src, const int* xMap, int count);
+    static void ScaleRowBGRA_Scalar(uint32_t* dst, const uint32_t* src, const int* xMap, int count);
+    static void ScaleRowBGRA_AVX2(uint32_t* dst, const uint32_t* src, const int* xMap, int count);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * Minimal geometry types shared by the capture backends.
+ * On Windows these come straight from <windows.h>; elsewhere we
+ * provide layout-compatible stand-ins so the same headers compile.
+ */
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+typedef long LONG;
+
+struct POINT {
+    LONG x;
+    LONG y;
+};
+
+struct RECT {
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+};
+#endif
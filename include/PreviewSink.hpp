@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "TripleBuffer.hpp"
+
+/**
+ * PreviewSink is where the recording pipeline drops a small copy of what
+ * it is producing (e.g. the composited output) for the UI to show.
+ * The producer downscales at a throttled rate straight into a lock-free
+ * exchange slot; the UI maps the newest slot without copying or locking.
+ */
+class PreviewSink {
+public:
+    // BGRA, tightly packed; valid until the next AcquireFrame() call
+    struct FrameView {
+        const uint8_t* data = nullptr;
+        int width = 0;
+        int height = 0;
+        uint64_t sequence = 0;
+    };
+
+    // Frames are fit into maxWidth x maxHeight (aspect preserved) at no more than maxFps
+    void Configure(int maxWidth, int maxHeight, int maxFps);
+
+    // --- Producer (recording thread) ---
+
+    // Cheap check so the caller can skip work for frames that would be dropped anyway
+    bool WantsFrame() const;
+
+    // Downscales and publishes the frame if the rate allows; returns true if it was taken
+    bool Submit(const uint8_t* bgra, int stride, int width, int height);
+
+    // --- Consumer (UI thread) ---
+
+    bool HasNewFrame() const { return m_frames.HasNew(); }
+    bool AcquireFrame(FrameView& out);
+
+private:
+    struct Slot {
+        std::vector<uint8_t> pixels; // Reused, never shrinks
+        int width = 0;
+        int height = 0;
+    };
+
+    TripleBuffer<Slot> m_frames;
+    std::atomic<int> m_maxWidth{320};
+    std::atomic<int> m_maxHeight{180};
+    std::atomic<int> m_intervalMs{200};
+    std::chrono::steady_clock::time_point m_lastSubmit; // Producer-private
+};
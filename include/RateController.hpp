@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * RateController turns what the engine knows about screen changes into
+ * x264 settings. FFmpeg runs as a separate process fed over a pipe, so
+ * nothing can be changed per frame during a live encode. Live encodes
+ * therefore get settings sized for screen content: a VBV cap against
+ * scrolling bursts, a long GOP and x264's own scene-cut detection.
+ * Spool transcodes know every frame's changed-tile fraction up front, so
+ * they get keyframes forced exactly on scene changes (a large change the
+ * screen then settles on) and no scene-cut analysis in the encoder.
+ */
+class RateController {
+public:
+    struct Params {
+        int crf = 23;
+        int maxrateKbps = 0;  // VBV cap (0 = plain CRF)
+        int bufsizeKbps = 0;
+        int keyint = 0;       // Longest GOP in frames (0 = x264 default)
+        int minKeyint = 0;
+        int scenecut = -1;    // x264 scene-cut threshold (-1 = preset default, 0 = off)
+        std::vector<double> keyframeTimes; // Forced keyframes in seconds; replaces the interval grid
+
+        // "-crf ... [-maxrate ... -bufsize ...] [-x264-params ...]" + KeyframeArgs()
+        std::string EncoderArgs(int keyframeIntervalSeconds) const;
+
+        // "-force_key_frames ...": keyframeTimes, or without them one every
+        // `keyframeIntervalSeconds` (0 = none). Also used for outputs with their own quality.
+        std::string KeyframeArgs(int keyframeIntervalSeconds) const;
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t staticFrames = 0; // Nothing changed
+        uint64_t burstFrames = 0;  // Over kBurstFraction changed (scrolling, video, window drags)
+        uint64_t sceneChanges = 0;
+    };
+
+    static constexpr float kSceneChangeFraction = 0.5f; // Changed share of the frame that can start a scene
+    static constexpr float kSettledFraction = 0.02f;     // Mean change over the half second after it
+    static constexpr float kBurstFraction = 0.25f;
+    static constexpr size_t kMaxForcedKeyframes = 1500;  // Keeps the FFmpeg command line well under 32K chars
+
+    // -crf 23 and encoder defaults
+    static Params Fixed();
+
+    // Live encode: change statistics only exist after the fact, so these are sized from the format
+    static Params Live(int width, int height, int fps);
+
+    // Transcode with every frame's changed fraction known (0..1, one per output frame)
+    static Params Offline(int width, int height, int fps, const std::vector<float>& changed,
+                          int keyframeIntervalSeconds, Stats* stats = nullptr);
+
+    // Frames where a scene starts: at least kSceneChangeFraction changed, the following half
+    // second settles, and at least one second since the previous one
+    static std::vector<uint64_t> SceneChanges(const std::vector<float>& changed, int fps);
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Frame.hpp"
+#include "PlatformTypes.hpp"
+
+/**
+ * RoiMap rates every 16x16 macroblock of the output by how much a viewer
+ * cares about it:
+ * - Focus: near the cursor, in the click highlight, or freshly edited
+ *   (changed, but not for long: a typed character, a toggled control).
+ * - Coarse: changing continuously away from the cursor (video, animation,
+ *   scrolling another pane).
+ * - Normal: everything else.
+ *
+ * FFmpeg runs as a separate process fed raw frames, so a per-frame QP offset
+ * map can't reach x264. Instead Apply() pre-quantizes Coarse blocks (2x2
+ * averaging) in the frame about to be encoded; the encoder then spends
+ * little on them, and its CRF budget goes to the rest. Touched areas are
+ * handed back so the compositor restores them from the pristine screen next
+ * frame: a block that stops moving is sharp again one frame later.
+ */
+class RoiMap {
+public:
+    enum Level : int8_t {
+        Focus = -1,
+        Normal = 0,
+        Coarse = 1
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t blocks = 0;
+        uint64_t focusBlocks = 0;
+        uint64_t coarseBlocks = 0;
+        uint64_t workUs = 0; // Update() + Apply()
+    };
+
+    static constexpr int kBlockSize = 16;     // x264 macroblock
+    static constexpr int kFocusRadius = 96;   // Pixels around the cursor kept at full detail
+    static constexpr int kMotionFrames = 6;   // Consecutive changed frames before a block counts as motion
+
+    // Rates this frame's blocks. `damage` lists what changed since the previous frame
+    // (empty = nothing, nullptr = unknown: motion history restarts). `highlight` may be empty.
+    void Update(int width, int height, const std::vector<FrameRect>* damage, POINT cursor, const FrameRect& highlight);
+
+    Level At(int bx, int by) const { return (Level)m_levels[(size_t)by * m_blocksX + bx]; }
+    int BlocksX() const { return m_blocksX; }
+    int BlocksY() const { return m_blocksY; }
+
+    // Pre-quantizes the Coarse blocks of `frame` (BGRA, the size passed to Update()) and appends
+    // the areas it changed to `touched`
+    void Apply(const Frame& frame, std::vector<FrameRect>& touched);
+
+    Stats GetStats() const { return m_stats; }
+    void Reset();
+
+    // Replaces each 2x2 pixel quad of two rows with its average (`pixels` even).
+    // Dispatched by CpuDispatch; the scalar version is the reference.
+    static void Smooth2x2(uint8_t* row0, uint8_t* row1, int pixels);
+    static void Smooth2x2_Scalar(uint8_t* row0, uint8_t* row1, int pixels);
+    static void Smooth2x2_SSE2(uint8_t* row0, uint8_t* row1, int pixels);
+    static void Smooth2x2_AVX2(uint8_t* row0, uint8_t* row1, int pixels);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_blocksX = 0;
+    int m_blocksY = 0;
+    std::vector<uint8_t> m_runs;    // Consecutive frames each block changed in
+    std::vector<uint8_t> m_damaged; // This frame
+    std::vector<int8_t> m_levels;
+    Stats m_stats;
+};
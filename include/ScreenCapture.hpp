@@ -1,17 +1,25 @@
 #pragma once
 
-#include <windows.h>
+#include "PlatformTypes.hpp"
+#include "Frame.hpp"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#ifdef _WIN32
 #include <d3d11.h>
 #include <dxgi1_2.h>
 #include <wrl/client.h>
-#include <vector>
-#include <memory>
 
 using Microsoft::WRL::ComPtr;
+#endif
 
 /**
  * ScreenCapture manages the Windows Desktop Duplication API
  * to efficiently capture screen frames.
+ *
+ * On Linux the same interface is backed by X11: MIT-SHM for the
+ * pixel grab and XDamage to skip frames where nothing changed.
  */
 class ScreenCapture {
 public:
@@ -19,17 +27,22 @@ public:
     ~ScreenCapture();
 
     bool Initialize();
-    bool CaptureFrame(std::vector<uint8_t>& outBuffer, int& width, int& height);
+
+    /**
+     * Zero-copy: points `out` at the capture region inside the capture
+     * backend's own CPU-visible image (mapped staging texture / shared X
+     * image). The view is read-only and stays valid until the next call or
+     * Cleanup(). When the screen didn't change, the previous view is returned
+     * again with the same sequence number. Returns false if no frame is
+     * available yet.
+     */
+    bool AcquireFrame(Frame& out);
+
     void SetRegion(RECT r) { m_captureRect = r; }
     void Cleanup();
     POINT GetCaptureOrigin() const;
 
 private:
-    ComPtr<ID3D11Device> m_d3dDevice;
-    ComPtr<ID3D11DeviceContext> m_d3dContext;
-    ComPtr<IDXGIOutputDuplication> m_deskDupl;
-    
-    DXGI_OUTPUT_DESC m_outputDesc;
     bool m_initialized = false;
 
     bool SetupDevice();
@@ -38,6 +51,28 @@ private:
     RECT m_captureRect = {0}; // 0 = Fullscreen
     POINT m_lastOrigin = { 0, 0 };
 
+    Frame m_frame;                  // Current view handed out by AcquireFrame()
+    FrameRect m_region;             // Capture region (screen coordinates) m_frame was taken from
+    std::vector<FrameRect> m_damage; // Changed areas of the latest sequence, frame coordinates
+    uint64_t m_sequence = 0;
+
+#ifdef _WIN32
+    ComPtr<ID3D11Device> m_d3dDevice;
+    ComPtr<ID3D11DeviceContext> m_d3dContext;
+    ComPtr<IDXGIOutputDuplication> m_deskDupl;
+
+    DXGI_OUTPUT_DESC m_outputDesc;
+
+    // Region-sized staging texture, kept mapped between frames so the view stays valid;
+    // only unmapped while the next update is copied in
     ComPtr<ID3D11Texture2D> m_stagingTexture;
     D3D11_TEXTURE2D_DESC m_stagingDesc = { (UINT)0 };
+    D3D11_MAPPED_SUBRESOURCE m_mapped = {};
+    bool m_isMapped = false;
+    std::vector<uint8_t> m_metadata; // Move/dirty rects from the duplication API
+#else
+    // Xlib types stay out of the header (its macros clash with everything)
+    struct X11State;
+    std::unique_ptr<X11State> m_x11;
+#endif
 };
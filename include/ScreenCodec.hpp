@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include "Frame.hpp"
+#include "ChangeMap.hpp"
+
+/**
+ * ScreenCodec is a lossless intermediate codec for BGRA screen frames.
+ * Tiles unchanged since the previous frame are skipped; they're found by
+ * comparing bytes against a retained copy of that frame (ChangeMap::Diff),
+ * never by hash, so a skipped tile is always identical. The
+ * remaining tile runs are split into slices of similar size, and every
+ * slice is coded independently with QOI-style ops (index / diff / luma /
+ * run / literal) on its own worker thread. Flat colour, which dominates
+ * screen content, becomes long runs that are found four pixels at a time.
+ *
+ * Stream: StreamHeader, rectCount FrameRects, sliceCount SliceEntries,
+ * then the slice payloads back to back.
+ */
+class ScreenCodec {
+public:
+    struct StreamHeader {
+        uint32_t magic;
+        int32_t width;
+        int32_t height;
+        uint32_t rectCount;
+        uint32_t sliceCount;
+        uint32_t reserved;
+    };
+
+    struct SliceEntry {
+        uint32_t firstRect;
+        uint32_t rectCount;
+        uint32_t bytes;
+        uint32_t flags;
+    };
+
+    // Slice holds plain pixels: QOI ops would have been larger (noise, photos)
+    static constexpr uint32_t kSliceStored = 1;
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t inputBytes = 0;  // Changed-tile pixels handed to the coder
+        uint64_t outputBytes = 0;
+        uint64_t encodeUs = 0;    // Including the change map
+    };
+
+    static constexpr uint32_t kMagic = 0x31435353; // "SSC1"
+
+    ScreenCodec() = default;
+    ~ScreenCodec();
+    ScreenCodec(const ScreenCodec&) = delete;
+    ScreenCodec& operator=(const ScreenCodec&) = delete;
+
+    // Codes the tiles that changed since the previous call (every tile when `key`).
+    // Returns false, with `out` empty, when nothing changed.
+    bool Encode(const Frame& frame, bool key, std::vector<uint8_t>& out);
+
+    // Applies one Encode() output to `canvas`, which holds the previous decoded frame
+    static bool Decode(const uint8_t* data, size_t size, const Frame& canvas);
+
+    Stats GetStats() const { return m_stats; }
+    size_t LastChangedTiles() const { return m_changes.ChangedCount(); } // In the last Encode()'s frame
+    void Reset(); // Next Encode() starts from scratch (and codes every tile)
+
+    // Number of pixels from px[0] equal to `value` (at most `count`).
+    // Dispatched by CpuDispatch; the scalar version is the reference.
+    static int RunLength(const uint32_t* px, int count, uint32_t value);
+    static int RunLength_Scalar(const uint32_t* px, int count, uint32_t value);
+    static int RunLength_SSE2(const uint32_t* px, int count, uint32_t value);
+    static int RunLength_AVX2(const uint32_t* px, int count, uint32_t value);
+
+private:
+    ChangeMap m_changes;
+    std::vector<uint8_t> m_previous; // Last encoded frame, packed; empty until the first Encode()
+    int m_previousWidth = 0;
+    int m_previousHeight = 0;
+    std::vector<FrameRect> m_rects;
+    std::vector<SliceEntry> m_slices;
+    std::vector<std::vector<uint8_t>> m_sliceOut;
+    const Frame* m_frame = nullptr; // Frame being coded, for the workers
+    Stats m_stats;
+
+    // Slice workers (started on first use); slice 0 always runs on the caller
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    int m_jobSlices = 0;
+    int m_pending = 0;
+    bool m_quit = false;
+
+    void EncodeSlice(int slice);
+    void RunSlices(int count);
+    void WorkerLoop(int id, uint64_t generation); // Runs slice `id` of every later generation
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include "Frame.hpp"
+#include "ScreenCodec.hpp"
+
+/**
+ * SeekIndex writes a sidecar (<video>.idx) while recording: one entry
+ * every N seconds with the frame number, its time on the output timeline
+ * and a small thumbnail (160 px wide, ScreenCodec-compressed). The encoder
+ * forces a keyframe at the same times, so every entry is a seek point and
+ * tools can scrub without decoding the video.
+ *
+ * Layout: FileHeader, then Entry + thumbnail bytes per entry. entryCount
+ * is filled in by Finish(); readers of an unfinished sidecar scan entries.
+ */
+class SeekIndex {
+public:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t fps;
+        uint32_t intervalFrames;
+        int32_t thumbWidth;
+        int32_t thumbHeight;
+        uint32_t entryCount;
+    };
+
+    struct Entry {
+        uint64_t frameIndex;
+        int64_t timeUs;     // frameIndex / fps
+        uint32_t thumbBytes; // ScreenCodec keyframe stream
+        uint32_t reserved;
+    };
+
+    // One entry read back, with its thumbnail decoded
+    struct Thumbnail {
+        Entry entry = {};
+        std::vector<uint8_t> pixels; // BGRA, thumbWidth x thumbHeight, packed
+    };
+
+    struct Stats {
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t workUs = 0; // Thumbnail scaling + compression + writes
+    };
+
+    static constexpr char kMagic[8] = { 'S', 'S', 'R', 'I', 'N', 'D', 'E', 'X' };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr int kThumbWidth = 160;
+
+    ~SeekIndex();
+
+    bool Start(const std::string& path, int fps, int intervalSeconds, int sourceWidth, int sourceHeight);
+
+    // Whether AddFrame() would take this frame (every intervalFrames-th one)
+    bool WantsFrame(uint64_t frameIndex) const { return m_file && frameIndex % m_header.intervalFrames == 0; }
+
+    // Call once per output frame; only frames WantsFrame() accepts do any work. `frame` may be
+    // the output itself or a downscaled copy (the engine passes its preview-scale frame);
+    // at thumbnail size it is compressed as-is.
+    void AddFrame(uint64_t frameIndex, const Frame& frame);
+
+    void Finish();
+
+    bool IsOpen() const { return m_file != nullptr; }
+    Stats GetStats() const { return m_stats; }
+
+    static std::string PathFor(const std::string& videoPath) { return videoPath + ".idx"; }
+
+    // Entry spacing recorded in an existing sidecar, in seconds (0 = missing or unreadable)
+    static int ReadIntervalSeconds(const std::string& path);
+
+    // Reads a sidecar back. Entries of an unfinished one are found by scanning; a truncated
+    // last entry is dropped. False if the file is missing or not a sidecar.
+    static bool Read(const std::string& path, FileHeader& header, std::vector<Thumbnail>& entries);
+
+    // Thumbnail height for a source of the given size (width is always kThumbWidth)
+    static int ThumbHeight(int sourceWidth, int sourceHeight);
+
+private:
+    std::FILE* m_file = nullptr;
+    FileHeader m_header = {};
+    std::vector<uint8_t> m_thumb;
+    std::vector<uint8_t> m_encoded;
+    ScreenCodec m_codec;
+    Stats m_stats;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * SnapshotStore publishes immutable, versioned copies of a value
+ * (read-copy-update). Readers take the current snapshot with one atomic
+ * load and keep using it for as long as they hold the pointer; writers
+ * never modify a published snapshot, they swap in a new one.
+ *
+ * std::atomic<std::shared_ptr> is not lock-free on libstdc++ or MSVC
+ * (is_lock_free() is false): both guard the pointer and reference count
+ * with a short internal spinlock. A Load() can therefore wait for a
+ * concurrent Publish() or Load() for the length of a pointer swap and a
+ * count update, never for the copy of T. That is fine for the engine's
+ * one Load() per frame, not for a hard real-time thread.
+ */
+template <typename T>
+class SnapshotStore {
+public:
+    struct Snapshot {
+        T value;
+        uint64_t version = 0; // Increments with every Publish()
+    };
+    using Ptr = std::shared_ptr<const Snapshot>;
+
+    SnapshotStore() : m_current(std::make_shared<const Snapshot>()) {}
+
+    // Any thread
+    Ptr Load() const { return m_current.load(std::memory_order_acquire); }
+
+    // Writers are serialized among themselves; readers only contend with the final swap
+    void Publish(const T& value) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        uint64_t version = m_current.load(std::memory_order_relaxed)->version + 1;
+        m_current.store(std::make_shared<const Snapshot>(Snapshot{ value, version }), std::memory_order_release);
+    }
+
+    // Copies the current value, lets `mutate` edit the copy, publishes it
+    template <typename F>
+    void Update(F&& mutate) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        Ptr current = m_current.load(std::memory_order_relaxed);
+        T value = current->value;
+        mutate(value);
+        m_current.store(std::make_shared<const Snapshot>(Snapshot{ value, current->version + 1 }), std::memory_order_release);
+    }
+
+private:
+    std::atomic<Ptr> m_current;
+    std::mutex m_writeMutex;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * TripleBuffer is a lock-free single-producer / single-consumer exchange
+ * of the latest value. The producer always has a private slot to fill, the
+ * consumer always has a private slot to read, and the third slot is swapped
+ * atomically between them. Neither side ever waits or copies.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // --- Producer side ---
+
+    // Slot owned by the producer until Publish()
+    T& WriteBuffer() { return m_slots[m_write]; }
+
+    // Hands the write slot to the consumer; the previous unread value (if any) is recycled
+    void Publish() {
+        m_sequence[m_write] = ++m_published;
+        uint8_t prev = m_middle.exchange(m_write | kFresh, std::memory_order_acq_rel);
+        m_write = prev & kIndexMask;
+        m_publishedCount.store(m_published, std::memory_order_relaxed);
+    }
+
+    // --- Consumer side ---
+
+    // Swaps in the newest published value; returns false if nothing new arrived
+    bool Update() {
+        if (!HasNew()) return false;
+        uint8_t prev = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = prev & kIndexMask;
+        return true;
+    }
+
+    // Lock-free peek: has the producer published since the last Update()?
+    bool HasNew() const { return (m_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+
+    // Slot owned by the consumer until the next Update()
+    const T& ReadBuffer() const { return m_slots[m_read]; }
+
+    // Sequence number of ReadBuffer() (0 = nothing received yet)
+    uint64_t ReadSequence() const { return m_sequence[m_read]; }
+
+    // Forget all values; only call while neither side is active
+    void Reset() {
+        for (int i = 0; i < 3; ++i) {
+            m_slots[i] = T{};
+            m_sequence[i] = 0;
+        }
+        m_write = 0;
+        m_read = 1;
+        m_middle.store(2, std::memory_order_release);
+    }
+
+    // Total values published so far (readable from any thread)
+    uint64_t PublishedCount() const { return m_publishedCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T m_slots[3] = {};
+    uint64_t m_sequence[3] = { 0, 0, 0 };
+
+    uint8_t m_write = 0;                 // Producer-private
+    uint8_t m_read = 1;                  // Consumer-private
+    std::atomic<uint8_t> m_middle{ 2 };  // Shared slot index + fresh flag
+
+    uint64_t m_published = 0;            // Producer-private counter
+    std::atomic<uint64_t> m_publishedCount{ 0 };
+};
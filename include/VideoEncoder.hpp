@@ -1,13 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <cstdio>
 #include <vector>
 #include <cstdint>
+#include "Frame.hpp"
+#include "RateController.hpp"
 
 /**
  * VideoEncoder handles the live piping of raw pixel data
  * into FFmpeg to produce an MP4 file.
+ * Audio can either be captured by FFmpeg itself (audioDeviceName) or
+ * fed in-process as 48 kHz stereo float PCM tracks through named pipes,
+ * or read from raw PCM files of the same format (spool transcodes).
+ * One encode can fan out to extra stream sinks next to the file, and a
+ * downscaled proxy file can be encoded alongside it.
  */
 class VideoEncoder {
 public:
@@ -16,15 +24,76 @@ public:
     
     bool Start(const std::string& outputPath, int sourceWidth, int sourceHeight, int fps, 
                const std::string& audioDeviceName = "", bool isSystemAudio = false,
-               int targetWidth = 0, int targetHeight = 0);
-    bool WriteFrame(const std::vector<uint8_t>& bgraData);
+               int targetWidth = 0, int targetHeight = 0, int pcmAudioTracks = 0,
+               const std::vector<std::string>& pcmAudioFiles = {});
+    // Extra outputs (rtmp://, srt://, udp://, pipes, files) fed from the same encode as the
+    // file; each gets its own queue so a slow or dead sink never stalls the file. Call before Start().
+    void SetStreamSinks(const std::vector<std::string>& urls) { m_streamSinks = urls; }
+
+    // Also writes a low-resolution proxy `height` pixels tall to `path` from the same
+    // capture and colour conversion (empty path or height <= 0 = off). Call before Start().
+    void SetProxyOutput(const std::string& path, int height) { m_proxyPath = path; m_proxyHeight = height; }
+
+    // Forces a keyframe every `seconds` of output time in the file and the proxy, so the
+    // seek index sidecar points at frames a player can start decoding from (0 = encoder default)
+    void SetKeyframeInterval(int seconds) { m_keyframeInterval = seconds; }
+
+    // x264 rate control and GOP settings for the main output (default: RateController::Fixed()).
+    // Forced keyframe times, if any, replace the interval grid in the file and the proxy.
+    void SetRateControl(const RateController::Params& params) { m_rate = params; }
+
+    // BGRA at the size passed to Start(); strided views are packed on the way out
+    bool WriteFrame(const Frame& frame);
+
+    // Interleaved 48 kHz stereo float samples for the given PCM track.
+    // The first call blocks until FFmpeg has opened the track's pipe.
+    bool WriteAudio(int track, const std::vector<float>& samples);
+
+    // Unblocks a WriteAudio() stuck waiting for FFmpeg; call before joining the audio thread
+    void ReleaseAudioWaiters();
     void Finish();
 
+    // After Finish(): blocks until FFmpeg has written the file; true if it exited cleanly
+    bool WaitForExit();
+
+    // CPU time (user + kernel) FFmpeg has used so far, in seconds
+    double GetEncoderCpuSeconds() const;
+
+    // Size of the encoded video for Start()'s source and target sizes, computed as FFmpeg's
+    // scale filter does (a target <= 0 keeps the aspect ratio, rounded to an even size)
+    static void OutputSize(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight,
+                           int& outWidth, int& outHeight);
+
+    // Resolves the FFmpeg executable ahead of time so Start() does no filesystem probing
+    static void Prewarm();
+
+    // FFmpeg executable used for encodes (also by ClipEditor)
+    static std::string FindFFmpeg(); // Cached result of LocateFFmpeg()
+
 private:
+    struct AudioPipe {
+        void* handle = nullptr; // Windows HANDLE (named pipe server end)
+        std::string name;
+        void* dummyClient = nullptr; // Only used to unblock a pending connect
+        // Set by the audio thread once FFmpeg has connected (release), read by
+        // ReleaseAudioWaiters() on the engine thread (acquire)
+        std::atomic<bool> connected{ false };
+    };
+
     void* m_ffmpegPipe = nullptr; // Windows HANDLE
+    void* m_process = nullptr;    // Windows HANDLE
+    std::vector<AudioPipe> m_audioPipes;
+    std::vector<uint8_t> m_packed; // Repacking buffer for strided frames
+    std::vector<std::string> m_streamSinks;
+    std::string m_proxyPath;
+    int m_proxyHeight = 0;
+    int m_keyframeInterval = 0;
+    RateController::Params m_rate;
     int m_width = 0;
     int m_height = 0;
     bool m_isRunning = false;
 
-    std::string FindFFmpeg();
+    static std::string LocateFFmpeg();
+    std::string BuildTeeOutput(const std::string& outputPath) const;
+    void CloseAudioPipes();
 };
@@ -1,12 +1,13 @@
 #pragma once
 
-#define NOMINMAX
-#include <windows.h>
 #include <vector>
 #include <cstdint>
+#include "Frame.hpp"
+#include "PlatformTypes.hpp"
 
 /**
  * VisualEffects provides functions to draw on raw video frames.
+ * Frames are BGRA views and may be strided or cropped.
  */
 class VisualEffects {
 public:
@@ -15,22 +16,41 @@ public:
     };
 
     /**
-     * Draws a semi-transparent circle at the given position
+     * Draws a semi-transparent circle at the given position.
+     * Returns the area touched (for overlay restore).
      */
-    static void DrawHighlight(std::vector<uint8_t>& bgraData, int width, int height, POINT mousePos, int radius, Color color);
+    static FrameRect DrawHighlight(const Frame& frame, POINT mousePos, int radius, Color color);
 
     /**
-     * Draws a professional cursor shape
+     * Draws a professional cursor shape.
+     * Returns the area touched (for overlay restore).
      */
-    static void DrawCursor(std::vector<uint8_t>& bgraData, int width, int height, POINT mousePos);
+    static FrameRect DrawCursor(const Frame& frame, POINT mousePos);
 
     /**
-     * Gets the current mouse position relative to the screen
+     * Blends `count` BGRA pixels toward the colour in `bgra` (b | g << 8 | r << 16 | a << 24),
+     * its alpha byte being the opacity; the pixels' own alpha is kept.
+     * Dispatched by CpuDispatch; the scalar version is the bit-exact reference.
+     */
+    static void BlendRow(uint8_t* px, int count, uint32_t bgra);
+    static void BlendRow_Scalar(uint8_t* px, int count, uint32_t bgra);
+    static void BlendRow_SSE2(uint8_t* px, int count, uint32_t bgra);
+    static void BlendRow_AVX2(uint8_t* px, int count, uint32_t bgra);
+
+    /**
+     * One row of the cursor bitmap: shape 0 keeps the pixel, 1 paints it black, 2 white.
+     * Rows are 12 pixels, so every level uses the branch-free scalar loop.
+     */
+    static void CursorRow(uint32_t* px, const uint8_t* shape, int count);
+    static void CursorRow_Scalar(uint32_t* px, const uint8_t* shape, int count);
+
+    /**
+     * Gets the current mouse position relative to the screen ((0, 0) outside Windows)
      */
     static POINT GetMousePosition();
 
     /**
-     * Checks if the left mouse button is currently pressed
+     * Checks if the left mouse button is currently pressed (always false outside Windows)
      */
     static bool IsLeftClicked();
 };
@@ -6,23 +6,86 @@
 #include <vector>
 #include <wrl/client.h>
 #include <thread>
-#include <mutex>
 #include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "TripleBuffer.hpp"
+#include "PixelConvert.hpp"
 
 using Microsoft::WRL::ComPtr;
 
 class WebcamDevice {
+    struct FrameSlot {
+        std::vector<uint8_t> pixels; // Reused across frames, never shrinks
+        int width = 0;
+        int height = 0;
+    };
+
 public:
+    // Zero-copy view of a camera frame (BGRA, tightly packed)
+    struct FrameView {
+        const uint8_t* data = nullptr;
+        int width = 0;
+        int height = 0;
+        uint64_t sequence = 0; // Increments with every frame delivered to this subscriber
+    };
+
+    struct Stats {
+        uint64_t framesPublished = 0; // Delivered by the camera thread
+        uint64_t framesConsumed = 0;  // Picked up by AcquireFrame()
+        uint64_t framesCopied = 0;    // Full copies made by GetFrame()
+    };
+
+    /**
+     * One consumer of the camera (UI preview, recorder compositor, ...).
+     * Each subscriber gets frames at its own size and rate through its own
+     * lock-free triple buffer, so consumers never contend with each other
+     * or with the camera thread.
+     */
+    class Subscriber {
+    public:
+        // Frames are delivered scaled to this height (aspect preserved); 0 = native size.
+        // Conversion from the camera's native format happens at this size, never at full res.
+        void SetOutputHeight(int height) { m_outputHeight = height; }
+
+        // Lock-free: points `out` at the newest frame without copying.
+        // The view stays valid until the next AcquireFrame()/GetFrame() call.
+        // Returns false until the first frame arrives.
+        bool AcquireFrame(FrameView& out);
+
+        // Copying variant for consumers that keep the pixels around
+        bool GetFrame(std::vector<uint8_t>& outBuffer, int& width, int& height);
+
+        // Lock-free check whether a frame newer than the last acquired one is waiting
+        bool HasNewFrame() const { return m_frames.HasNew(); }
+
+        Stats GetStats() const;
+
+    private:
+        friend class WebcamDevice;
+
+        TripleBuffer<FrameSlot> m_frames;
+        std::atomic<int> m_outputHeight{0};
+        std::chrono::steady_clock::duration m_minInterval{0};
+        std::chrono::steady_clock::time_point m_lastDelivery;
+        std::atomic<uint64_t> m_framesConsumed{0};
+        std::atomic<uint64_t> m_framesCopied{0};
+    };
+
     WebcamDevice();
     ~WebcamDevice();
 
     bool Initialize(int deviceIndex = 0);
     void Start();
     void Stop();
-    
-    // Reads the latest frame into BGRA buffer
-    // Returns true if a new frame was acquired
-    bool GetFrame(std::vector<uint8_t>& outBuffer, int& width, int& height);
+
+    // maxFps = 0 delivers every camera frame
+    std::shared_ptr<Subscriber> Subscribe(int outputHeight = 0, int maxFps = 0);
+    void Unsubscribe(const std::shared_ptr<Subscriber>& subscriber);
+
+    bool IsStreaming() const { return m_isStreaming; }
 
     void Cleanup();
 
@@ -30,15 +93,23 @@ private:
     ComPtr<IMFSourceReader> m_pReader;
     bool m_initialized = false;
     bool m_isStreaming = false;
-    int m_width = 0;
+    int m_width = 0;  // Native camera size (display aperture)
     int m_height = 0;
+    int m_planeHeight = 0;  // Rows allocated per plane (MF_MT_FRAME_SIZE; may exceed m_height)
+    LONG m_defaultStride = 0; // MF_MT_DEFAULT_STRIDE, for buffers without IMF2DBuffer
+    PixelConvert::Format m_format = PixelConvert::Format::BGRA;
+
+    // Only the camera thread and (un)subscribe take this; consumers never do
+    std::mutex m_subscribersMutex;
+    std::vector<std::shared_ptr<Subscriber>> m_subscribers;
 
-    std::vector<uint8_t> m_lastFrame; // Cache last frame for steady composite
-    std::mutex m_frameMutex;
     std::thread m_worker;
     std::atomic<bool> m_stopWorker{false};
     
     void CaptureLoop();
+    // `scan0` is the top row, `srcStride` the pitch (negative for bottom-up RGB32)
+    void Deliver(const uint8_t* scan0, int srcStride);
     bool SetupSourceReader(IMFMediaSource* pSource);
     HRESULT NormalizeFormat(IMFMediaType* pType);
+    void DeliverBuffer(IMFMediaBuffer* pBuffer);
 };
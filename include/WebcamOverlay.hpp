@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Frame.hpp"
+
+/**
+ * WebcamOverlay keeps the picture-in-picture tile already scaled to its
+ * on-screen size. The tile is only rebuilt when a new camera frame arrives
+ * or the target geometry changes; every other recorder frame is a plain blit.
+ * A camera frame that was delivered at the PIP size is blitted in place,
+ * without any scaling or copy.
+ */
+class WebcamOverlay {
+public:
+    struct Stats {
+        uint64_t rescales = 0; // Tile rebuilds
+        uint64_t inPlace = 0;  // Camera frames used as delivered (already at the PIP size)
+        uint64_t blits = 0;    // Composited frames
+    };
+
+    // PIP width for a `sourceW` x `sourceH` picture shown `targetH` tall (aspect kept, rounded
+    // down). WebcamDevice delivers at this size too, so the two always agree to the pixel.
+    static int TileWidth(int sourceW, int sourceH, int targetH);
+
+    // Rebuilds the cached tile if `sequence` or the target height differ from the cached ones.
+    // If the frame is already TileWidth() x `targetH`, it is used in place: `webBuf` must then
+    // stay valid until the next Update() (a subscriber's AcquireFrame() view does).
+    void Update(const uint8_t* webBuf, int wW, int wH, uint64_t sequence, int targetH);
+
+    // Copies the cached tile into the frame at (x, y), clipped to the frame; returns the area covered
+    FrameRect Blit(const Frame& dst, int x, int y);
+
+    bool HasTile() const { return m_pixels != nullptr; }
+    int GetWidth() const { return m_tileW; }
+    int GetHeight() const { return m_tileH; }
+
+    Stats GetStats() const { return m_stats; }
+    void Reset();
+
+private:
+    std::vector<uint8_t> m_tile;         // BGRA, opaque; scaled copies only
+    const uint8_t* m_pixels = nullptr;   // m_tile, or the camera frame used in place
+    int m_tileW = 0;
+    int m_tileH = 0;
+    uint64_t m_sequence = 0;
+    int m_sourceW = 0;
+    int m_sourceH = 0;
+    Stats m_stats;
+};
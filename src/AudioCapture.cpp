@@ -1,5 +1,8 @@
 #include "AudioCapture.hpp"
+#include "AudioMixer.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include <comdef.h>
 #include <functiondiscoverykeys_devpkey.h>
 
@@ -13,6 +16,7 @@ AudioCapture::~AudioCapture() {
 
 bool AudioCapture::Initialize(bool isLoopback) {
     HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    m_comInitialized = SUCCEEDED(hr);
     
     // 1. Get Device Enumerator
     hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, 
@@ -32,6 +36,9 @@ bool AudioCapture::Initialize(bool isLoopback) {
     hr = m_audioClient->GetMixFormat(&m_pwfx);
     if (FAILED(hr)) return false;
 
+    // Shared mode is almost always 32-bit float, but some drivers hand out 16-bit PCM
+    m_isFloat = (m_pwfx->wBitsPerSample == 32);
+
     // 5. Initialize Client (Add Loopback flag if needed)
     DWORD flags = isLoopback ? AUDCLNT_STREAMFLAGS_LOOPBACK : 0;
     hr = m_audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, 10000000, 0, m_pwfx, nullptr);
@@ -70,6 +77,44 @@ std::string AudioCapture::GetDeviceName() const {
     return name;
 }
 
+bool AudioCapture::GetAudioSamples(std::vector<float>& outSamples) {
+    outSamples.clear();
+    if (!m_captureClient) return false;
+
+    UINT32 packetLength = 0;
+    HRESULT hr = m_captureClient->GetNextPacketSize(&packetLength);
+    if (FAILED(hr)) return false;
+
+    int channels = m_pwfx->nChannels;
+
+    while (packetLength != 0) {
+        BYTE* pData;
+        UINT32 numFramesAvailable;
+        DWORD flags;
+
+        hr = m_captureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr);
+        if (FAILED(hr)) break;
+
+        size_t base = outSamples.size();
+        size_t count = (size_t)numFramesAvailable * channels;
+        outSamples.resize(base + count);
+
+        if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
+            std::fill(outSamples.begin() + base, outSamples.end(), 0.0f);
+        } else if (m_isFloat) {
+            memcpy(outSamples.data() + base, pData, count * sizeof(float));
+        } else {
+            AudioKernels::S16ToFloat((const int16_t*)pData, outSamples.data() + base, count);
+        }
+
+        hr = m_captureClient->ReleaseBuffer(numFramesAvailable);
+        hr = m_captureClient->GetNextPacketSize(&packetLength);
+        if (FAILED(hr)) break;
+    }
+
+    return !outSamples.empty();
+}
+
 bool AudioCapture::Start() {
     if (!m_initialized) return false;
     return SUCCEEDED(m_audioClient->Start());
@@ -119,10 +164,11 @@ void AudioCapture::Stop() {
 }
 
 void AudioCapture::Cleanup() {
-    if (m_captureClient) m_captureClient->Release();
-    if (m_audioClient) m_audioClient->Release();
-    if (m_device) m_device->Release();
-    if (m_enumerator) m_enumerator->Release();
-    if (m_pwfx) CoTaskMemFree(m_pwfx);
-    CoUninitialize();
+    if (m_captureClient) { m_captureClient->Release(); m_captureClient = nullptr; }
+    if (m_audioClient) { m_audioClient->Release(); m_audioClient = nullptr; }
+    if (m_device) { m_device->Release(); m_device = nullptr; }
+    if (m_enumerator) { m_enumerator->Release(); m_enumerator = nullptr; }
+    if (m_pwfx) { CoTaskMemFree(m_pwfx); m_pwfx = nullptr; }
+    if (m_comInitialized) { CoUninitialize(); m_comInitialized = false; }
+    m_initialized = false;
 }
@@ -0,0 +1,325 @@
+#include "AudioMixer.hpp"
+#include "CpuDispatch.hpp"
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+// --- Kernels ---
+
+void AudioKernels::MixInto(float* dst, const float* src, size_t count, float gain) {
+    CpuDispatch::Get().mixInto(dst, src, count, gain);
+}
+
+float AudioKernels::Dot(const float* a, const float* b, size_t count) {
+    return CpuDispatch::Get().dot(a, b, count);
+}
+
+void AudioKernels::S16ToFloat(const int16_t* src, float* dst, size_t count) {
+    CpuDispatch::Get().s16ToFloat(src, dst, count);
+}
+
+void AudioKernels::MixInto_Scalar(float* dst, const float* src, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) dst[i] += src[i] * gain;
+}
+
+float AudioKernels::Dot_Scalar(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+void AudioKernels::S16ToFloat_Scalar(const int16_t* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) dst[i] = src[i] / 32768.0f;
+}
+
+#ifdef SSR_X86_SSE2
+void AudioKernels::MixInto_SSE2(float* dst, const float* src, size_t count, float gain) {
+    size_t i = 0;
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= count; i += 8) {
+        __m128 d0 = _mm_loadu_ps(dst + i);
+        __m128 d1 = _mm_loadu_ps(dst + i + 4);
+        d0 = _mm_add_ps(d0, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        d1 = _mm_add_ps(d1, _mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+        _mm_storeu_ps(dst + i, d0);
+        _mm_storeu_ps(dst + i + 4, d1);
+    }
+    MixInto_Scalar(dst + i, src + i, count - i, gain);
+}
+
+float AudioKernels::Dot_SSE2(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < count; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Multiplying by 2^-15 is exact, so this matches the scalar division bit for bit
+void AudioKernels::S16ToFloat_SSE2(const int16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    S16ToFloat_Scalar(src + i, dst + i, count - i);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+// No FMA: a fused multiply-add would round differently from the scalar reference
+SSR_TARGET_AVX2
+void AudioKernels::MixInto_AVX2(float* dst, const float* src, size_t count, float gain) {
+    size_t i = 0;
+    __m256 g = _mm256_set1_ps(gain);
+    for (; i + 16 <= count; i += 16) {
+        __m256 d0 = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+        __m256 d1 = _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), g));
+        _mm256_storeu_ps(dst + i, d0);
+        _mm256_storeu_ps(dst + i + 8, d1);
+    }
+    _mm256_zeroupper();
+    MixInto_SSE2(dst + i, src + i, count - i, gain);
+}
+
+SSR_TARGET_AVX2
+float AudioKernels::Dot_AVX2(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum4);
+    _mm256_zeroupper();
+    float sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < count; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+SSR_TARGET_AVX2
+void AudioKernels::S16ToFloat_AVX2(const int16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+    for (; i + 16 <= count; i += 16) {
+        __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    _mm256_zeroupper();
+    S16ToFloat_SSE2(src + i, dst + i, count - i);
+}
+#endif
+
+// --- AudioResampler ---
+
+// Zeroth-order modified Bessel function (for the Kaiser window)
+static double BesselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum) break;
+    }
+    return sum;
+}
+
+bool AudioResampler::Configure(int inRate, int outRate, int channels, int tapsPerPhase) {
+    if (inRate <= 0 || outRate <= 0 || channels <= 0 || tapsPerPhase <= 0) return false;
+
+    int g = std::gcd(inRate, outRate);
+    m_up = outRate / g;
+    m_down = inRate / g;
+    m_channels = channels;
+    m_taps = tapsPerPhase;
+
+    m_coeffs.clear();
+    if (!IsPassthrough()) {
+        // Prototype low-pass at the upsampled rate, cut just below the lower Nyquist
+        const double pi = 3.14159265358979323846;
+        const double beta = 8.0;
+        int n = m_up * m_taps;
+        double center = (n - 1) / 2.0;
+        double fc = 0.5 / std::max(m_up, m_down) * 0.92;
+        double i0Beta = BesselI0(beta);
+
+        std::vector<double> proto(n);
+        for (int j = 0; j < n; ++j) {
+            double t = j - center;
+            double sinc = (t == 0.0) ? 1.0 : std::sin(2.0 * pi * fc * t) / (2.0 * pi * fc * t);
+            double r = t / (center + 1.0);
+            double window = BesselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0Beta;
+            proto[j] = 2.0 * fc * sinc * window;
+        }
+
+        // Split into phases, store time-reversed so the inner loop is a contiguous dot product.
+        // Each phase is normalized to unity DC gain.
+        m_coeffs.resize((size_t)m_up * m_taps);
+        for (int p = 0; p < m_up; ++p) {
+            double phaseSum = 0.0;
+            for (int k = 0; k < m_taps; ++k) phaseSum += proto[(size_t)k * m_up + p];
+            if (phaseSum == 0.0) phaseSum = 1.0;
+            for (int k = 0; k < m_taps; ++k) {
+                m_coeffs[(size_t)p * m_taps + (m_taps - 1 - k)] = (float)(proto[(size_t)k * m_up + p] / phaseSum);
+            }
+        }
+    }
+
+    Reset();
+    return true;
+}
+
+void AudioResampler::Reset() {
+    m_history.assign(m_channels, std::vector<float>(m_taps > 0 ? m_taps - 1 : 0, 0.0f));
+    m_index = m_taps > 0 ? m_taps - 1 : 0;
+    m_phase = 0;
+}
+
+void AudioResampler::Process(const float* interleaved, size_t frames, std::vector<float>& out) {
+    if (m_channels == 0 || frames == 0) return;
+
+    if (IsPassthrough()) {
+        out.insert(out.end(), interleaved, interleaved + frames * m_channels);
+        return;
+    }
+
+    for (int c = 0; c < m_channels; ++c) {
+        std::vector<float>& h = m_history[c];
+        size_t base = h.size();
+        h.resize(base + frames);
+        for (size_t i = 0; i < frames; ++i) h[base + i] = interleaved[i * m_channels + c];
+    }
+
+    size_t avail = m_history[0].size();
+    auto dot = CpuDispatch::Get().dot;
+    while (m_index < avail) {
+        const float* coeffs = &m_coeffs[(size_t)m_phase * m_taps];
+        size_t first = m_index + 1 - m_taps;
+        for (int c = 0; c < m_channels; ++c) {
+            out.push_back(dot(coeffs, &m_history[c][first], m_taps));
+        }
+
+        m_phase += m_down;
+        m_index += m_phase / m_up;
+        m_phase %= m_up;
+    }
+
+    // Keep only the taps-1 frames of history the next output still needs
+    size_t drop = std::min(m_index + 1 - m_taps, avail);
+    for (int c = 0; c < m_channels; ++c) {
+        m_history[c].erase(m_history[c].begin(), m_history[c].begin() + drop);
+    }
+    m_index -= drop;
+}
+
+// --- AudioMixer ---
+
+int AudioMixer::AddSource(int sampleRate, int channels, float gain) {
+    Source src;
+    src.channels = channels;
+    src.gain = gain;
+    src.resampler.Configure(sampleRate, kOutputRate, kOutputChannels);
+    m_sources.push_back(std::move(src));
+    return (int)m_sources.size() - 1;
+}
+
+void AudioMixer::SetGain(int source, float gain) {
+    if (source >= 0 && source < (int)m_sources.size()) m_sources[source].gain = gain;
+}
+
+void AudioMixer::Clear() {
+    m_sources.clear();
+}
+
+void AudioMixer::PushSamples(int source, const float* interleaved, size_t frames) {
+    if (source < 0 || source >= (int)m_sources.size() || frames == 0) return;
+    Source& src = m_sources[source];
+
+    // Bring to stereo first (mono is duplicated, extra channels beyond FL/FR are dropped)
+    src.scratch.resize(frames * kOutputChannels);
+    if (src.channels == 1) {
+        for (size_t i = 0; i < frames; ++i) {
+            src.scratch[i * 2] = src.scratch[i * 2 + 1] = interleaved[i];
+        }
+    } else {
+        for (size_t i = 0; i < frames; ++i) {
+            src.scratch[i * 2] = interleaved[i * src.channels];
+            src.scratch[i * 2 + 1] = interleaved[i * src.channels + 1];
+        }
+    }
+
+    src.resampler.Process(src.scratch.data(), frames, src.fifo);
+
+    // Bound latency to one second: a source running ahead of the mix clock loses its oldest audio
+    size_t maxSamples = (size_t)kOutputRate * kOutputChannels;
+    size_t buffered = src.fifo.size() - src.fifoRead;
+    if (buffered > maxSamples) src.fifoRead += buffered - maxSamples;
+
+    if (src.fifoRead > src.fifo.size() / 2) {
+        src.fifo.erase(src.fifo.begin(), src.fifo.begin() + src.fifoRead);
+        src.fifoRead = 0;
+    }
+}
+
+void AudioMixer::Pull(Source& src, size_t frames, std::vector<float>& out) {
+    size_t wanted = frames * kOutputChannels;
+    size_t buffered = src.fifo.size() - src.fifoRead;
+    size_t take = std::min(wanted, buffered);
+
+    out.resize(wanted);
+    std::copy(src.fifo.begin() + src.fifoRead, src.fifo.begin() + src.fifoRead + take, out.begin());
+    std::fill(out.begin() + take, out.end(), 0.0f);
+    src.fifoRead += take;
+}
+
+// Keeps the track within full scale: two loud sources or a gain above 1 clip here, not at
+// some later integer conversion
+void AudioMixer::Clamp(std::vector<float>& samples) {
+    for (float& v : samples) v = std::min(1.0f, std::max(-1.0f, v));
+}
+
+void AudioMixer::Mix(size_t frames, std::vector<float>& out) {
+    out.assign(frames * kOutputChannels, 0.0f);
+    for (Source& src : m_sources) {
+        Pull(src, frames, m_pull);
+        AudioKernels::MixInto(out.data(), m_pull.data(), out.size(), src.gain);
+    }
+    Clamp(out);
+}
+
+void AudioMixer::ReadSource(int source, size_t frames, std::vector<float>& out) {
+    out.assign(frames * kOutputChannels, 0.0f);
+    if (source < 0 || source >= (int)m_sources.size()) return;
+    Source& src = m_sources[source];
+    Pull(src, frames, m_pull);
+    AudioKernels::MixInto(out.data(), m_pull.data(), out.size(), src.gain);
+    Clamp(out);
+}
+
+void AudioMixer::Flush() {
+    for (Source& src : m_sources) {
+        src.fifo.clear();
+        src.fifoRead = 0;
+        src.resampler.Reset();
+    }
+}
@@ -0,0 +1,41 @@
+#include "CameraService.hpp"
+#include <iostream>
+
+CameraService::~CameraService() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_device.Cleanup();
+}
+
+std::shared_ptr<WebcamDevice::Subscriber> CameraService::Subscribe(int outputHeight, int maxFps) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_refCount == 0) {
+        auto openStart = std::chrono::steady_clock::now();
+        if (!m_device.Initialize(0)) return nullptr;
+        m_device.Start();
+
+        auto openMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - openStart);
+        std::cout << "Camera opened in " << openMs.count() << " ms" << std::endl;
+    }
+
+    m_refCount++;
+    return m_device.Subscribe(outputHeight, maxFps);
+}
+
+void CameraService::Unsubscribe(std::shared_ptr<WebcamDevice::Subscriber>& subscriber) {
+    if (!subscriber) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_device.Unsubscribe(subscriber);
+    subscriber.reset();
+
+    if (--m_refCount == 0) {
+        m_device.Stop();
+        m_device.Cleanup();
+    }
+}
+
+bool CameraService::IsRunning() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_refCount > 0;
+}
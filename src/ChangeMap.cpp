@@ -0,0 +1,258 @@
+#include "ChangeMap.hpp"
+#include "CpuDispatch.hpp"
+#include <cstring>
+#include <algorithm>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+// Per-pixel mix for the non-linear sum: each 16-bit half becomes lo16(x * kMulLo) ^ hi16(x * kMulHi),
+// after the pixel is keyed with its row. The high half of a product doesn't move linearly with x,
+// so changes that cancel in the plain sums (+3 in one column and -1 four columns over, a
+// (+d, -2d, +d) vertical profile, pixels swapped between rows) don't cancel here.
+// SSE2 has both 16-bit multiplies, so every level computes it exactly the same way.
+static constexpr uint32_t kMulLo = 0x9E37;
+static constexpr uint32_t kMulHi = 0x7F4B;
+static constexpr uint32_t kRowKey = 0x9E3779B9u;
+
+static inline uint32_t MixHalf(uint32_t x) {
+    return ((x * kMulLo) & 0xFFFF) ^ ((x * kMulHi) >> 16);
+}
+
+static inline uint32_t Mix(uint32_t px, uint32_t key) {
+    uint32_t x = px ^ key;
+    return MixHalf(x & 0xFFFF) | MixHalf(x >> 16) << 16;
+}
+
+// Lane l of column group g (pixel column g * 4 + l) is weighted by 2g+1 and the four
+// groups summed, separately for s1, s2 and s3. Odd weights keep every single-pixel change
+// visible in s1; the 12 remaining words are folded to 64 bits with FNV-1a.
+static uint64_t FoldLanes(const uint32_t s1[4], const uint32_t s2[4], const uint32_t s3[4]) {
+    uint64_t w[6] = {
+        s1[0] | (uint64_t)s1[1] << 32, s1[2] | (uint64_t)s1[3] << 32,
+        s2[0] | (uint64_t)s2[1] << 32, s2[2] | (uint64_t)s2[3] << 32,
+        s3[0] | (uint64_t)s3[1] << 32, s3[2] | (uint64_t)s3[3] << 32
+    };
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (int i = 0; i < 6; ++i) h = (h ^ w[i]) * 0x100000001b3ull;
+    return h;
+}
+
+uint64_t ChangeMap::HashTile_Scalar(const uint8_t* src, int stride, int w, int h) {
+    uint32_t sums[48] = {};
+    for (int y = 0; y < h; ++y) {
+        const uint32_t* row = (const uint32_t*)(src + (size_t)y * stride);
+        uint32_t key = kRowKey * (uint32_t)(y + 1);
+        // Columns past the right edge count as zero but still advance s2
+        for (int x = 0; x < kTileSize; ++x) {
+            sums[x] += x < w ? row[x] : 0;
+            sums[16 + x] += sums[x];
+            sums[32 + x] += x < w ? Mix(row[x], key) : 0;
+        }
+    }
+    uint32_t s[3][4];
+    for (int k = 0; k < 3; ++k) {
+        const uint32_t* c = sums + 16 * k;
+        for (int l = 0; l < 4; ++l) s[k][l] = c[l] + 3 * c[4 + l] + 5 * c[8 + l] + 7 * c[12 + l];
+    }
+    return FoldLanes(s[0], s[1], s[2]);
+}
+
+uint64_t ChangeMap::HashTile(const uint8_t* src, int stride, int w, int h) {
+    return CpuDispatch::Get().hashTile(src, stride, w, h);
+}
+
+#ifdef SSR_X86_SSE2
+// v*1 + x*3 + y*5 + z*7 per 32-bit lane (SSE2 has no 32-bit mullo)
+static inline __m128i Weight1357(__m128i v, __m128i x, __m128i y, __m128i z) {
+    __m128i r = _mm_add_epi32(v, _mm_add_epi32(x, _mm_slli_epi32(x, 1)));
+    r = _mm_add_epi32(r, _mm_add_epi32(y, _mm_slli_epi32(y, 2)));
+    return _mm_add_epi32(r, _mm_sub_epi32(_mm_slli_epi32(z, 3), z));
+}
+
+static inline __m128i Mix_SSE2(__m128i px, __m128i key) {
+    __m128i x = _mm_xor_si128(px, key);
+    return _mm_xor_si128(_mm_mullo_epi16(x, _mm_set1_epi16((short)kMulLo)), _mm_mulhi_epu16(x, _mm_set1_epi16((short)kMulHi)));
+}
+
+uint64_t ChangeMap::HashTile_SSE2(const uint8_t* src, int stride, int w, int h) {
+    if (w != kTileSize) return HashTile_Scalar(src, stride, w, h);
+    __m128i a0 = _mm_setzero_si128(), a1 = a0, a2 = a0, a3 = a0;
+    __m128i b0 = a0, b1 = a0, b2 = a0, b3 = a0;
+    __m128i c0 = a0, c1 = a0, c2 = a0, c3 = a0;
+    for (int y = 0; y < h; ++y) {
+        const __m128i* p = (const __m128i*)(src + (size_t)y * stride);
+        __m128i key = _mm_set1_epi32((int)(kRowKey * (uint32_t)(y + 1)));
+        __m128i p0 = _mm_loadu_si128(p + 0), p1 = _mm_loadu_si128(p + 1);
+        __m128i p2 = _mm_loadu_si128(p + 2), p3 = _mm_loadu_si128(p + 3);
+        a0 = _mm_add_epi32(a0, p0);
+        a1 = _mm_add_epi32(a1, p1);
+        a2 = _mm_add_epi32(a2, p2);
+        a3 = _mm_add_epi32(a3, p3);
+        b0 = _mm_add_epi32(b0, a0);
+        b1 = _mm_add_epi32(b1, a1);
+        b2 = _mm_add_epi32(b2, a2);
+        b3 = _mm_add_epi32(b3, a3);
+        c0 = _mm_add_epi32(c0, Mix_SSE2(p0, key));
+        c1 = _mm_add_epi32(c1, Mix_SSE2(p1, key));
+        c2 = _mm_add_epi32(c2, Mix_SSE2(p2, key));
+        c3 = _mm_add_epi32(c3, Mix_SSE2(p3, key));
+    }
+    alignas(16) uint32_t s1[4], s2[4], s3[4];
+    _mm_store_si128((__m128i*)s1, Weight1357(a0, a1, a2, a3));
+    _mm_store_si128((__m128i*)s2, Weight1357(b0, b1, b2, b3));
+    _mm_store_si128((__m128i*)s3, Weight1357(c0, c1, c2, c3));
+    return FoldLanes(s1, s2, s3);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+SSR_TARGET_AVX2
+static inline __m256i Mix_AVX2(__m256i px, __m256i key) {
+    __m256i x = _mm256_xor_si256(px, key);
+    return _mm256_xor_si256(_mm256_mullo_epi16(x, _mm256_set1_epi16((short)kMulLo)),
+                            _mm256_mulhi_epu16(x, _mm256_set1_epi16((short)kMulHi)));
+}
+
+// A tile row is two 256-bit loads; the column groups are split back out for the same weighting
+SSR_TARGET_AVX2
+uint64_t ChangeMap::HashTile_AVX2(const uint8_t* src, int stride, int w, int h) {
+    if (w != kTileSize) return HashTile_Scalar(src, stride, w, h);
+    __m256i a01 = _mm256_setzero_si256(), a23 = a01, b01 = a01, b23 = a01, c01 = a01, c23 = a01;
+    for (int y = 0; y < h; ++y) {
+        const __m256i* p = (const __m256i*)(src + (size_t)y * stride);
+        __m256i key = _mm256_set1_epi32((int)(kRowKey * (uint32_t)(y + 1)));
+        __m256i p01 = _mm256_loadu_si256(p + 0), p23 = _mm256_loadu_si256(p + 1);
+        a01 = _mm256_add_epi32(a01, p01);
+        a23 = _mm256_add_epi32(a23, p23);
+        b01 = _mm256_add_epi32(b01, a01);
+        b23 = _mm256_add_epi32(b23, a23);
+        c01 = _mm256_add_epi32(c01, Mix_AVX2(p01, key));
+        c23 = _mm256_add_epi32(c23, Mix_AVX2(p23, key));
+    }
+    alignas(16) uint32_t s1[4], s2[4], s3[4];
+    _mm_store_si128((__m128i*)s1, Weight1357(_mm256_castsi256_si128(a01), _mm256_extracti128_si256(a01, 1),
+                                             _mm256_castsi256_si128(a23), _mm256_extracti128_si256(a23, 1)));
+    _mm_store_si128((__m128i*)s2, Weight1357(_mm256_castsi256_si128(b01), _mm256_extracti128_si256(b01, 1),
+                                             _mm256_castsi256_si128(b23), _mm256_extracti128_si256(b23, 1)));
+    _mm_store_si128((__m128i*)s3, Weight1357(_mm256_castsi256_si128(c01), _mm256_extracti128_si256(c01, 1),
+                                             _mm256_castsi256_si128(c23), _mm256_extracti128_si256(c23, 1)));
+    _mm256_zeroupper();
+    return FoldLanes(s1, s2, s3);
+}
+#endif
+
+bool ChangeMap::Resize(const Frame& frame) {
+    if (frame.width == m_width && frame.height == m_height) return false;
+    m_width = frame.width;
+    m_height = frame.height;
+    m_tilesX = (m_width + kTileSize - 1) / kTileSize;
+    m_tilesY = (m_height + kTileSize - 1) / kTileSize;
+    m_hashes.assign((size_t)m_tilesX * m_tilesY, 0);
+    m_bits.assign(((size_t)m_tilesX * m_tilesY + 63) / 64, 0);
+    return true;
+}
+
+void ChangeMap::HashTiles(const Frame& frame, int tx0, int ty0, int tx1, int ty1, bool force) {
+    // One band of 16 rows at a time, left to right, so every row is read as a forward stream
+    auto hashTile = CpuDispatch::Get().hashTile;
+    for (int ty = ty0; ty < ty1; ++ty) {
+        int y = ty * kTileSize;
+        int h = m_height - y < kTileSize ? m_height - y : kTileSize;
+        for (int tx = tx0; tx < tx1; ++tx) {
+            int x = tx * kTileSize;
+            int w = m_width - x < kTileSize ? m_width - x : kTileSize;
+            uint64_t hash = hashTile(frame.Pixel(x, y), frame.stride, w, h);
+
+            size_t i = (size_t)ty * m_tilesX + tx;
+            uint64_t bit = 1ull << (i & 63);
+            if ((force || hash != m_hashes[i]) && !(m_bits[i >> 6] & bit)) {
+                m_bits[i >> 6] |= bit;
+                m_changed++;
+            }
+            m_hashes[i] = hash;
+        }
+    }
+}
+
+void ChangeMap::Update(const Frame& frame) {
+    if (frame.Empty() || frame.format != PixelConvert::Format::BGRA) return;
+
+    bool resized = Resize(frame);
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+    m_changed = 0;
+    HashTiles(frame, 0, 0, m_tilesX, m_tilesY, resized);
+}
+
+void ChangeMap::Refresh(const Frame& frame, const std::vector<FrameRect>& damage) {
+    if (frame.Empty() || frame.format != PixelConvert::Format::BGRA) return;
+    if (frame.width != m_width || frame.height != m_height) {
+        Update(frame);
+        return;
+    }
+
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+    m_changed = 0;
+    for (const FrameRect& d : damage) {
+        FrameRect r = d.Intersect(frame.Bounds());
+        if (r.Empty()) continue;
+        HashTiles(frame, r.x / kTileSize, r.y / kTileSize,
+                  (r.x + r.width + kTileSize - 1) / kTileSize, (r.y + r.height + kTileSize - 1) / kTileSize, false);
+    }
+}
+
+void ChangeMap::Diff(const Frame& frame, const Frame& previous) {
+    if (frame.Empty() || frame.format != PixelConvert::Format::BGRA) return;
+
+    bool resized = Resize(frame) || previous.width != frame.width || previous.height != frame.height;
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+    m_changed = 0;
+    if (resized) {
+        std::fill(m_bits.begin(), m_bits.end(), ~0ull);
+        m_changed = (size_t)m_tilesX * m_tilesY;
+        return;
+    }
+
+    // Row by row, so both frames are read as forward streams; a row equal in full
+    // (the common case) costs one memcmp, otherwise its tiles are compared one by one
+    size_t frameRow = (size_t)m_width * 4;
+    for (int y = 0; y < m_height; ++y) {
+        const uint8_t* a = frame.Row(y);
+        const uint8_t* b = previous.Row(y);
+        if (memcmp(a, b, frameRow) == 0) continue;
+        size_t base = (size_t)(y / kTileSize) * m_tilesX;
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            size_t i = base + tx;
+            uint64_t bit = 1ull << (i & 63);
+            if (m_bits[i >> 6] & bit) continue;
+            size_t x = (size_t)tx * kTileSize * 4;
+            if (memcmp(a + x, b + x, std::min((size_t)kTileSize * 4, frameRow - x)) != 0) {
+                m_bits[i >> 6] |= bit;
+                m_changed++;
+            }
+        }
+    }
+}
+
+void ChangeMap::ToRects(std::vector<FrameRect>& out) const {
+    out.clear();
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        int tx = 0;
+        while (tx < m_tilesX) {
+            if (!IsChanged(tx, ty)) { ++tx; continue; }
+            int start = tx;
+            while (tx < m_tilesX && IsChanged(tx, ty)) ++tx;
+            FrameRect r = { start * kTileSize, ty * kTileSize, (tx - start) * kTileSize, kTileSize };
+            out.push_back(r.Intersect({ 0, 0, m_width, m_height }));
+        }
+    }
+}
+
+void ChangeMap::Reset() {
+    m_width = m_height = 0;
+    m_tilesX = m_tilesY = 0;
+    m_changed = 0;
+    m_hashes.clear();
+    m_bits.clear();
+}
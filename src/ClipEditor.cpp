@@ -0,0 +1,195 @@
+#include "ClipEditor.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <locale>
+#include <sstream>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// Keyframes closer than this to a cut point count as on it (timestamps are exact in the
+// container time base; this only absorbs seconds typed by hand)
+static const double kCutTolerance = 0.0005;
+
+static std::string Seconds(double s) {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.setf(std::ios::fixed);
+    out.precision(6);
+    out << s;
+    return out.str();
+}
+
+static std::string Quote(const std::string& path) {
+    return "\"" + path + "\"";
+}
+
+bool ClipEditor::Run(const std::string& args, std::string* output) {
+    std::string cmd = Quote(m_ffmpeg) + " -hide_banner -nostdin -v error " + args;
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+    HANDLE hRead = NULL, hWrite = NULL;
+    if (output && !CreatePipe(&hRead, &hWrite, &sa, 0)) return false;
+    if (hRead) SetHandleInformation(hRead, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA si = { sizeof(STARTUPINFOA) };
+    si.dwFlags = STARTF_USESTDHANDLES | STARTF_USESHOWWINDOW;
+    si.hStdOutput = hWrite;
+    si.wShowWindow = SW_HIDE;
+
+    PROCESS_INFORMATION pi = { 0 };
+    BOOL started = CreateProcessA(NULL, (LPSTR)cmd.c_str(), NULL, NULL, TRUE, CREATE_NO_WINDOW, NULL, NULL, &si, &pi);
+    if (hWrite) CloseHandle(hWrite); // Child has its end; reads hit EOF when it exits
+    if (!started) {
+        if (hRead) CloseHandle(hRead);
+        m_error = "Could not start FFmpeg: " + m_ffmpeg;
+        return false;
+    }
+    CloseHandle(pi.hThread);
+
+    if (output) {
+        char buffer[65536];
+        DWORD got;
+        while (ReadFile(hRead, buffer, sizeof(buffer), &got, NULL) && got > 0) output->append(buffer, got);
+        CloseHandle(hRead);
+    }
+
+    DWORD exitCode = 1;
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    GetExitCodeProcess(pi.hProcess, &exitCode);
+    CloseHandle(pi.hProcess);
+    bool ok = exitCode == 0;
+#else
+    bool ok;
+    if (output) {
+        std::FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) {
+            m_error = "Could not start FFmpeg: " + m_ffmpeg;
+            return false;
+        }
+        char buffer[65536];
+        size_t got;
+        while ((got = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0) output->append(buffer, got);
+        ok = pclose(pipe) == 0;
+    } else {
+        ok = std::system(cmd.c_str()) == 0;
+    }
+#endif
+    if (!ok) m_error = "FFmpeg failed: " + args;
+    return ok;
+}
+
+bool ClipEditor::ListKeyframes(const std::string& input, std::vector<double>& times, double* frameDuration) {
+    // Drop every non-key packet of the copied stream and print what is left, one line per packet:
+    // "stream, dts, pts, duration, size, crc" in the "#tb 0: num/den" time base
+    std::string text;
+    times.clear();
+    if (!Run("-i " + Quote(input) + " -map 0:v:0 -c copy -bsf:v \"noise=drop=not(key)\" -f framecrc -", &text)) return false;
+
+    std::istringstream lines(text);
+    lines.imbue(std::locale::classic());
+    std::string line;
+    double timeBase = 0.0;
+    while (std::getline(lines, line)) {
+        long long num = 0, den = 0;
+        if (line.rfind("#tb 0:", 0) == 0) {
+            if (std::sscanf(line.c_str() + 6, " %lld/%lld", &num, &den) == 2 && den > 0) timeBase = (double)num / den;
+            continue;
+        }
+        if (line.empty() || line[0] == '#' || timeBase <= 0.0) continue;
+        long long stream, dts, pts, duration;
+        if (std::sscanf(line.c_str(), "%lld, %lld, %lld, %lld", &stream, &dts, &pts, &duration) == 4) {
+            times.push_back(pts * timeBase);
+            if (frameDuration && duration > 0) *frameDuration = duration * timeBase;
+        }
+    }
+    std::sort(times.begin(), times.end());
+    if (times.empty()) m_error = "No keyframes found in " + input;
+    return !times.empty();
+}
+
+ClipEditor::CutPlan ClipEditor::Plan(const std::vector<double>& keyframes, double start, double end, bool frameAccurate) {
+    CutPlan plan;
+    // Last keyframe at or before the start: where a plain copy begins
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), start + kCutTolerance);
+    plan.copyStart = after == keyframes.begin() ? 0.0 : *(after - 1);
+    if (!frameAccurate || start - plan.copyStart <= kCutTolerance) return plan;
+
+    // Off-keyframe start: re-encode up to the next keyframe, copy from there
+    if (after == keyframes.end() || (end >= 0.0 && *after >= end - kCutTolerance)) {
+        plan.reencodeAll = true;
+        plan.copyStart = start;
+    } else {
+        plan.reencodeHead = true;
+        plan.copyStart = *after;
+    }
+    return plan;
+}
+
+bool ClipEditor::Trim(const std::string& input, const std::string& output, double start, double end, bool frameAccurate) {
+    m_error.clear();
+    if (start < 0.0) start = 0.0;
+    if (end >= 0.0 && end <= start) {
+        m_error = "Empty range";
+        return false;
+    }
+    auto until = [end](double from) { return end >= 0.0 ? " -t " + Seconds(end - from) : std::string(); };
+
+    std::vector<double> keyframes;
+    double frameDuration = 0.0;
+    if (!ListKeyframes(input, keyframes, &frameDuration)) return false;
+    CutPlan plan = Plan(keyframes, start, end, frameAccurate);
+
+    // Same encoder family as the recording (VideoEncoder) so the joined stream stays uniform
+    const std::string encode = " -c:v libx264 -preset ultrafast -crf 18 -pix_fmt yuv420p";
+
+    if (!plan.reencodeHead && !plan.reencodeAll) {
+        return Run("-ss " + Seconds(plan.copyStart) + " -i " + Quote(input) + until(plan.copyStart) +
+                   " -map 0 -c copy -avoid_negative_ts make_zero -movflags +faststart -y " + Quote(output));
+    }
+
+    if (plan.reencodeAll) {
+        return Run("-ss " + Seconds(start) + " -i " + Quote(input) + until(start) +
+                   " -map 0:v:0 -map 0:a?" + encode + " -c:a copy -movflags +faststart -y " + Quote(output));
+    }
+
+    // Smart cut: [start, keyframe) re-encoded, [keyframe, end) copied, both as raw Annex B so the
+    // parameter sets travel in-band and the two parts join by plain concatenation. The joined
+    // stream has no timestamps; recordings are constant frame rate, so they are regenerated.
+    std::string head = output + ".part0.h264", tail = output + ".part1.h264";
+    if (frameDuration <= 0.0) {
+        m_error = "Unknown frame rate: " + input;
+        return false;
+    }
+
+    bool ok = Run("-ss " + Seconds(start) + " -i " + Quote(input) + " -t " + Seconds(plan.copyStart - start) +
+                  " -map 0:v:0" + encode + " -f h264 -y " + Quote(head)) &&
+              Run("-ss " + Seconds(plan.copyStart) + " -i " + Quote(input) + until(plan.copyStart) +
+                  " -map 0:v:0 -c copy -bsf:v h264_mp4toannexb -f h264 -y " + Quote(tail)) &&
+              Run("-r " + Seconds(1.0 / frameDuration) + " -f h264 -i " + Quote("concat:" + head + "|" + tail) +
+                  " -ss " + Seconds(start) + " -i " + Quote(input) + until(start) +
+                  " -map 0:v -map 1:a? -c copy -movflags +faststart -y " + Quote(output));
+    std::error_code ec;
+    std::filesystem::remove(head, ec);
+    std::filesystem::remove(tail, ec);
+    return ok;
+}
+
+bool ClipEditor::Split(const std::string& input, double at, const std::string& firstOutput,
+                       const std::string& secondOutput, bool frameAccurate) {
+    m_error.clear();
+    if (!frameAccurate) {
+        // The second part can only start on a keyframe: end the first part there too,
+        // or the frames between that keyframe and `at` would be in both files
+        std::vector<double> keyframes;
+        if (!ListKeyframes(input, keyframes)) return false;
+        at = Plan(keyframes, at, -1.0, false).copyStart;
+        if (at <= kCutTolerance) {
+            m_error = "No keyframe after the start before the split point (use --exact)";
+            return false;
+        }
+    }
+    return Trim(input, firstOutput, 0.0, at, frameAccurate) && Trim(input, secondOutput, at, -1.0, frameAccurate);
+}
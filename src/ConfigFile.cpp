@@ -0,0 +1,101 @@
+#include "ConfigFile.hpp"
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+static std::string Trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool ConfigFile::Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::stringstream text;
+    text << in.rdbuf();
+    Parse(text.str());
+    return true;
+}
+
+void ConfigFile::Parse(const std::string& text) {
+    m_entries.clear();
+    m_warnings.clear();
+    std::istringstream lines(text);
+    std::string line;
+    for (int number = 1; std::getline(lines, line); ++number) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        line = Trim(line);
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        std::string key = eq == std::string::npos ? "" : Trim(line.substr(0, eq));
+        if (key.empty()) {
+            m_warnings.push_back("line " + std::to_string(number) + ": expected key = value");
+            continue;
+        }
+        m_entries.emplace_back(key, Trim(line.substr(eq + 1)));
+    }
+}
+
+bool ConfigFile::Has(const std::string& key) const {
+    for (const auto& e : m_entries) {
+        if (e.first == key) return true;
+    }
+    return false;
+}
+
+std::string ConfigFile::GetString(const std::string& key, const std::string& fallback) const {
+    const std::string* value = nullptr;
+    for (const auto& e : m_entries) {
+        if (e.first == key) value = &e.second;
+    }
+    return value ? *value : fallback;
+}
+
+bool ConfigFile::GetBool(const std::string& key, bool fallback) const {
+    if (!Has(key)) return fallback;
+    std::string v = GetString(key);
+    if (v == "true" || v == "yes" || v == "on" || v == "1") return true;
+    if (v == "false" || v == "no" || v == "off" || v == "0") return false;
+    m_warnings.push_back(key + ": expected true or false, got \"" + v + "\"");
+    return fallback;
+}
+
+int ConfigFile::GetInt(const std::string& key, int fallback) const {
+    if (!Has(key)) return fallback;
+    std::string v = GetString(key);
+    char* end = nullptr;
+    errno = 0;
+    long n = std::strtol(v.c_str(), &end, 10);
+    if (v.empty() || *end != '\0' || errno == ERANGE || n < -2147483647L || n > 2147483647L) {
+        m_warnings.push_back(key + ": expected a whole number, got \"" + v + "\"");
+        return fallback;
+    }
+    return (int)n;
+}
+
+float ConfigFile::GetFloat(const std::string& key, float fallback) const {
+    if (!Has(key)) return fallback;
+    std::string v = GetString(key);
+    char* end = nullptr;
+    errno = 0;
+    float f = std::strtof(v.c_str(), &end);
+    if (v.empty() || *end != '\0' || errno == ERANGE || !std::isfinite(f)) {
+        m_warnings.push_back(key + ": expected a number, got \"" + v + "\"");
+        return fallback;
+    }
+    return f;
+}
+
+std::vector<std::string> ConfigFile::GetAll(const std::string& key) const {
+    std::vector<std::string> values;
+    for (const auto& e : m_entries) {
+        if (e.first == key) values.push_back(e.second);
+    }
+    return values;
+}
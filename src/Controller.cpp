@@ -2,6 +2,7 @@
 #include <objbase.h>
 #include <dwmapi.h> // For modern Windows attributes
 #include <vector>
+#include <algorithm>
 
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
@@ -10,10 +11,17 @@
 #include <uxtheme.h>
 #include <shlobj.h>
 #include <filesystem>
+#include <iostream>
+#include <memory>
 #include "RegionSelector.hpp"
+#include "ConfigFile.hpp"
 #include "resource.h"
 
+static constexpr UINT WM_RECORDING_FAILED = WM_APP + 1; // lParam: std::string* owned by the receiver
+
 Controller::Controller() {
+    m_outputPreview.Configure(160, 90, 5);
+
     char path[MAX_PATH];
     if (SHGetSpecialFolderPathA(NULL, path, CSIDL_MYVIDEO, TRUE)) {
         m_savePath = path;
@@ -23,6 +31,28 @@ Controller::Controller() {
     } else {
         m_savePath = ".";
     }
+
+    LoadConfig();
+}
+
+// Settings without a control in the window come from <save folder>\settings.ini
+void Controller::LoadConfig() {
+    std::string path = m_savePath + "\\settings.ini";
+    ConfigFile config;
+    if (!config.Load(path)) return;
+
+    m_settings.spoolRecording = config.GetBool("spool_recording", m_settings.spoolRecording);
+    if (config.Has("stream")) m_settings.streamSinks = config.GetAll("stream");
+    m_settings.proxyHeight = config.GetInt("proxy_height", m_settings.proxyHeight);
+    m_settings.idlePauseSeconds = config.GetInt("idle_pause", m_settings.idlePauseSeconds);
+    m_settings.roiQuantization = config.GetBool("roi", m_settings.roiQuantization);
+    m_settings.exportFrames = config.GetBool("export_frames", m_settings.exportFrames);
+    m_settings.separateAudioTracks = config.GetBool("separate_audio_tracks", m_settings.separateAudioTracks);
+    m_settings.micGain = std::max(0.0f, config.GetFloat("mic_gain", m_settings.micGain));
+    m_settings.systemGain = std::max(0.0f, config.GetFloat("system_gain", m_settings.systemGain));
+
+    for (const std::string& warning : config.Warnings()) std::cerr << path << ": " << warning << std::endl;
+    std::cout << "Settings loaded from " << path << std::endl;
 }
 
 Controller::~Controller() {}
@@ -101,6 +131,11 @@ bool Controller::Create() {
     SendMessage(m_checkAudio, BM_SETCHECK, BST_UNCHECKED, 0);
     SendMessage(m_checkAudio, WM_SETFONT, (WPARAM)hFont, TRUE);
 
+    y += 45;
+    m_checkSystemAudio = CreateWindow("BUTTON", "Include System Audio", WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX, margin, y, 300, 35, m_hwnd, (HMENU)17, NULL, NULL);
+    SendMessage(m_checkSystemAudio, BM_SETCHECK, BST_UNCHECKED, 0);
+    SendMessage(m_checkSystemAudio, WM_SETFONT, (WPARAM)hFont, TRUE);
+
     /*
     y += 45;
     m_checkWebcam = CreateWindow("BUTTON", "Record Webcam", WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX, margin, y, 300, 35, m_hwnd, (HMENU)12, NULL, NULL);
@@ -165,6 +200,9 @@ bool Controller::Create() {
     m_labelSavePath = CreateWindow("STATIC", m_savePath.c_str(), WS_VISIBLE | WS_CHILD | SS_LEFT | SS_ENDELLIPSIS, margin, y, 280, 30, m_hwnd, NULL, NULL, NULL);
     SendMessage(m_labelSavePath, WM_SETFONT, (WPARAM)hFont, TRUE);
 
+    // --- Live output preview (shown while recording, painted in WM_DRAWITEM) ---
+    m_outputPreviewCtl = CreateWindow("STATIC", "", WS_CHILD | SS_OWNERDRAW, 0, 0, 160, 90, m_hwnd, (HMENU)18, NULL, NULL);
+
     m_btnShowFolder = CreateWindow("BUTTON", "Show Folder", WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON, margin + 290, y - 5, 120, 40, m_hwnd, (HMENU)10, NULL, NULL);
     SendMessage(m_btnShowFolder, WM_SETFONT, (WPARAM)hFont, TRUE);
 
@@ -183,6 +221,9 @@ bool Controller::Create() {
     SendMessage(m_btnPause, WM_SETFONT, (WPARAM)hFont, TRUE);
 
     ShowWindow(m_hwnd, SW_SHOW);
+
+    // Warm up right away, so even the first recording starts without the cold start
+    Prewarm();
     return true;
 }
 
@@ -199,6 +240,59 @@ void Controller::UpdateButtonState() {
     InvalidateRect(m_btnStart, NULL, TRUE); // Force redraw to update color
 }
 
+void Controller::NotifyRecordingFailed(const std::string& message) {
+    std::string* owned = new std::string(message);
+    if (!PostMessage(m_hwnd, WM_RECORDING_FAILED, 0, (LPARAM)owned)) delete owned;
+}
+
+void Controller::ReadControls() {
+    m_settings.recordAudio = (SendMessage(m_checkAudio, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.useSystemAudio = (SendMessage(m_checkSystemAudio, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.showHighlight = (SendMessage(m_checkHighlight, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.showLiveHighlight = (SendMessage(m_checkLiveHighlight, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.showCursor = (SendMessage(m_checkCursor, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.useCountdown = (SendMessage(m_checkCountdown, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.useFloatingBar = (SendMessage(m_checkFloating, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_settings.useWebcam = (SendMessage(m_checkWebcam, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    
+    int areaSel = (int)SendMessage(m_comboArea, CB_GETCURSEL, 0, 0);
+    m_settings.useCustomArea = (areaSel == 1);
+
+    if (m_settings.useWebcam) {
+        SyncWebcamGeometry();
+    }
+
+    if (m_settings.useCustomArea) {
+        // Area is already selected via button, logic simplified
+    } else {
+        m_settings.customRegion = {0}; // Reset
+        int sel = (int)SendMessage(m_comboRes, CB_GETCURSEL, 0, 0);
+        if (sel == 0) { m_settings.width = 0; m_settings.height = 0; }
+        else if (sel == 1) { m_settings.width = -1; m_settings.height = 1080; }
+        else if (sel == 2) { m_settings.width = -1; m_settings.height = 720; }
+        else if (sel == 3) { m_settings.width = -1; m_settings.height = 480; }
+    }
+}
+
+// Session-level settings: the ones a warm engine has already acted on (devices, region, output size)
+static bool SameSession(const Controller::Settings& a, const Controller::Settings& b) {
+    return a.recordAudio == b.recordAudio && a.useMicAudio == b.useMicAudio && a.useSystemAudio == b.useSystemAudio &&
+           a.useWebcam == b.useWebcam && a.webcamHeight == b.webcamHeight && a.useCustomArea == b.useCustomArea &&
+           EqualRect(&a.customRegion, &b.customRegion) && a.width == b.width && a.height == b.height;
+}
+
+void Controller::Prewarm() {
+    if (m_isRecording || m_isCountingDown) return;
+    ReadControls();
+    if (m_warm && SameSession(m_warmSettings, m_settings)) return;
+
+    // The engine opens the devices and spawns the encoder now, so Start is just a state flip.
+    // A second Prepare makes it drop the warm session and warm up again with these settings.
+    m_warm = true;
+    m_warmSettings = m_settings;
+    if (m_onPrepare) m_onPrepare();
+}
+
 void Controller::StartCountdown() {
     m_isCountingDown = true;
     m_countdownValue = 3;
@@ -251,6 +345,7 @@ void Controller::SwitchToFloatingBar(bool floating) {
         ShowWindow(m_labelVideo, SW_HIDE);
         ShowWindow(m_comboRes, SW_HIDE);
         ShowWindow(m_checkAudio, SW_HIDE);
+        ShowWindow(m_checkSystemAudio, SW_HIDE);
         ShowWindow(m_checkCountdown, SW_HIDE);
         ShowWindow(m_checkFloating, SW_HIDE);
         // ShowWindow(m_checkWebcam, SW_HIDE);
@@ -263,6 +358,7 @@ void Controller::SwitchToFloatingBar(bool floating) {
         ShowWindow(m_btnShowFolder, SW_HIDE);
         ShowWindow(m_labelSavePath, SW_HIDE);
         ShowWindow(m_labelF9Hint, SW_HIDE);
+        ShowWindow(m_outputPreviewCtl, SW_HIDE);
 
         // Layout inside the floating bar (Compact horizontal)
         SetWindowPos(m_labelTimer, NULL, 15, 15, 120, 35, SWP_NOZORDER);
@@ -298,6 +394,7 @@ void Controller::SwitchToFloatingBar(bool floating) {
         ShowWindow(m_labelVideo, SW_SHOW);
         ShowWindow(m_comboRes, SW_SHOW);
         ShowWindow(m_checkAudio, SW_SHOW);
+        ShowWindow(m_checkSystemAudio, SW_SHOW);
         ShowWindow(m_checkCountdown, SW_SHOW);
         ShowWindow(m_checkFloating, SW_SHOW);
         // ShowWindow(m_checkWebcam, SW_SHOW);
@@ -310,6 +407,7 @@ void Controller::SwitchToFloatingBar(bool floating) {
         ShowWindow(m_btnShowFolder, SW_SHOW);
         ShowWindow(m_labelSavePath, SW_SHOW);
         ShowWindow(m_labelF9Hint, SW_SHOW);
+        if (m_isRecording) ShowWindow(m_outputPreviewCtl, SW_SHOW);
     }
 }
 
@@ -330,6 +428,8 @@ void Controller::Relayout(int width, int height) {
 
     y += 80;
     SetWindowPos(m_checkAudio, NULL, margin, y, 300, 35, SWP_NOZORDER);
+    y += 45;
+    SetWindowPos(m_checkSystemAudio, NULL, margin, y, 300, 35, SWP_NOZORDER);
     // y += 45;
     // SetWindowPos(m_checkWebcam, NULL, margin, y, 300, 35, SWP_NOZORDER);
 
@@ -356,6 +456,9 @@ void Controller::Relayout(int width, int height) {
     y += 85;
     SetWindowPos(m_labelF9Hint, NULL, (width - 400) / 2, y, 400, 30, SWP_NOZORDER);
 
+    y += 35;
+    SetWindowPos(m_outputPreviewCtl, NULL, (width - 160) / 2, y, 160, 90, SWP_NOZORDER);
+
     // Anchor Save Folder Section to the BOTTOM
     int bottomY = height - 60;
     SetWindowPos(m_labelSavePath, NULL, margin, bottomY + 5, 280, 30, SWP_NOZORDER);
@@ -395,6 +498,28 @@ LRESULT CALLBACK WebcamPreviewWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
             }
             break;
         }
+        case WM_MOVE:
+        case WM_SIZE: {
+            // Dragging or resizing the preview moves/resizes the PIP live, even mid-recording
+            if (pController && IsWindowVisible(hwnd)) {
+                pController->SyncWebcamGeometry();
+                pController->PublishLiveSettings();
+            }
+            break;
+        }
+        case WM_MOUSEWHEEL: {
+            // Scroll to resize the PIP (height 10%..50% of the screen; width follows the camera aspect)
+            RECT rc; GetWindowRect(hwnd, &rc);
+            int screenH = GetSystemMetrics(SM_CYSCREEN);
+            int curW = rc.right - rc.left;
+            int curH = rc.bottom - rc.top;
+            int newH = curH + (GET_WHEEL_DELTA_WPARAM(wParam) > 0 ? curH / 10 : -curH / 10);
+            if (newH < screenH / 10) newH = screenH / 10;
+            if (newH > screenH / 2) newH = screenH / 2;
+            int newW = curH > 0 ? curW * newH / curH : curW;
+            SetWindowPos(hwnd, NULL, rc.left, rc.top, newW, newH, SWP_NOZORDER | SWP_NOACTIVATE);
+            return 0;
+        }
         case WM_PAINT: {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
@@ -402,11 +527,12 @@ LRESULT CALLBACK WebcamPreviewWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
             pController = (Controller*)GetWindowLongPtr(hwnd, GWLP_USERDATA);
 
             RECT rc; GetClientRect(hwnd, &rc);
-            if (pController && !pController->m_previewFrame.empty()) {
+            const WebcamDevice::FrameView* view = pController ? &pController->m_previewView : nullptr;
+            if (view && view->data) {
                 BITMAPINFO bmi = {0};
                 bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-                bmi.bmiHeader.biWidth = pController->m_previewW;
-                bmi.bmiHeader.biHeight = -pController->m_previewH; // Top-down
+                bmi.bmiHeader.biWidth = view->width;
+                bmi.bmiHeader.biHeight = -view->height; // Top-down
                 bmi.bmiHeader.biPlanes = 1;
                 bmi.bmiHeader.biBitCount = 32;
                 bmi.bmiHeader.biCompression = BI_RGB;
@@ -415,8 +541,8 @@ LRESULT CALLBACK WebcamPreviewWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
                 SetBrushOrgEx(hdc, 0, 0, NULL);
 
                 StretchDIBits(hdc, 0, 0, rc.right, rc.bottom,
-                              0, 0, pController->m_previewW, pController->m_previewH,
-                              pController->m_previewFrame.data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+                              0, 0, view->width, view->height,
+                              view->data, &bmi, DIB_RGB_COLORS, SRCCOPY);
                 
                 // Draw Close Button (X) in top-right
                 HBRUSH btnBrush = CreateSolidBrush(RGB(229, 57, 53));
@@ -474,13 +600,6 @@ void Controller::CreateWebcamPreviewWindow() {
     SetWindowDisplayAffinity(m_hwndWebcamPreview, WDA_EXCLUDEFROMCAPTURE);
 }
 
-void Controller::SetPreviewFrame(const std::vector<uint8_t>& frame, int w, int h) {
-    m_previewFrame = frame;
-    m_previewW = w;
-    m_previewH = h;
-    if (m_hwndWebcamPreview) InvalidateRect(m_hwndWebcamPreview, NULL, FALSE);
-}
-
 void Controller::SetWebcamEnabled(bool enabled) {
     ToggleWebcamPreview(enabled);
 }
@@ -502,22 +621,44 @@ void Controller::ToggleWebcamPreview(bool show) {
         
         SetWindowPos(m_hwndWebcamPreview, HWND_TOPMOST, x, y, targetW, targetH, SWP_SHOWWINDOW);
 
-        // Only start the controller's camera if we are NOT recording
-        if (!m_isRecording) {
-            if (m_webcamPreview.Initialize(0)) {
-                m_webcamPreview.Start();
-                SetTimer(m_hwnd, 103, 33, NULL); // Preview timer (30fps)
-            }
+        // The preview's subscription keeps the shared camera session warm,
+        // including across recordings (the recorder subscribes alongside it)
+        if (!m_previewCamera) {
+            m_previewCamera = m_camera.Subscribe(targetH, 30);
+            if (m_previewCamera) SetTimer(m_hwnd, 103, 33, NULL); // Preview timer (30fps)
         }
         ShowWindow(m_hwndWebcamPreview, SW_SHOW);
     } else {
         KillTimer(m_hwnd, 103);
-        m_webcamPreview.Stop();
-        m_webcamPreview.Cleanup();
+        m_previewView = WebcamDevice::FrameView(); // Points into the subscription being dropped
+        m_camera.Unsubscribe(m_previewCamera);
         if (m_hwndWebcamPreview) ShowWindow(m_hwndWebcamPreview, SW_HIDE);
     }
 }
 
+void Controller::SyncWebcamGeometry() {
+    if (!m_hwndWebcamPreview) return;
+    RECT rc;
+    GetWindowRect(m_hwndWebcamPreview, &rc);
+    m_settings.webcamPos.x = rc.left;
+    m_settings.webcamPos.y = rc.top;
+    m_settings.webcamHeight = rc.bottom - rc.top;
+}
+
+void Controller::PublishLiveSettings() {
+    if (m_onSettingsChanged) m_onSettingsChanged(m_settings);
+}
+
+void Controller::ToggleOutputPreview(bool show) {
+    if (show) {
+        SetTimer(m_hwnd, 105, 200, NULL); // Output preview poll (matches the sink's 5 fps)
+        if (!m_isFloating) ShowWindow(m_outputPreviewCtl, SW_SHOW);
+    } else {
+        KillTimer(m_hwnd, 105);
+        ShowWindow(m_outputPreviewCtl, SW_HIDE);
+    }
+}
+
 // --- Capture Indicator Window (Shows a border around recording area) ---
 LRESULT CALLBACK CaptureIndicatorWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     Controller* pCtrl = (Controller*)GetWindowLongPtr(hwnd, GWLP_USERDATA);
@@ -850,6 +991,30 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 
             case WM_DRAWITEM: {
                 LPDRAWITEMSTRUCT pdis = (LPDRAWITEMSTRUCT)lParam;
+                if (pdis->CtlID == 18) { // Live output preview
+                    const PreviewSink::FrameView& view = pThis->m_outputView;
+                    RECT rc = pdis->rcItem;
+                    if (view.data) {
+                        BITMAPINFO bmi = {0};
+                        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+                        bmi.bmiHeader.biWidth = view.width;
+                        bmi.bmiHeader.biHeight = -view.height; // Top-down
+                        bmi.bmiHeader.biPlanes = 1;
+                        bmi.bmiHeader.biBitCount = 32;
+                        bmi.bmiHeader.biCompression = BI_RGB;
+
+                        SetStretchBltMode(pdis->hDC, HALFTONE);
+                        SetBrushOrgEx(pdis->hDC, 0, 0, NULL);
+                        StretchDIBits(pdis->hDC, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top,
+                                      0, 0, view.width, view.height,
+                                      view.data, &bmi, DIB_RGB_COLORS, SRCCOPY);
+                    } else {
+                        HBRUSH hBr = CreateSolidBrush(RGB(50, 50, 50));
+                        FillRect(pdis->hDC, &rc, hBr);
+                        DeleteObject(hBr);
+                    }
+                    return TRUE;
+                }
                 if (pdis->CtlID == 1 || pdis->CtlID == 9) { // m_btnStart or m_btnPause
                     HBRUSH hBrush;
                     bool isStop = (pdis->CtlID == 1 && pThis->m_isRecording);
@@ -920,40 +1085,8 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                         if (pThis->m_isCountingDown) break;
 
                         if (!pThis->m_isRecording) {
-                            // Preparation to start
-                            pThis->m_settings.recordAudio = (SendMessage(pThis->m_checkAudio, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.showHighlight = (SendMessage(pThis->m_checkHighlight, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.showLiveHighlight = (SendMessage(pThis->m_checkLiveHighlight, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.showCursor = (SendMessage(pThis->m_checkCursor, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.useCountdown = (SendMessage(pThis->m_checkCountdown, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.useFloatingBar = (SendMessage(pThis->m_checkFloating, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            pThis->m_settings.useWebcam = (SendMessage(pThis->m_checkWebcam, BM_GETCHECK, 0, 0) == BST_CHECKED);
-                            
-                            int areaSel = (int)SendMessage(pThis->m_comboArea, CB_GETCURSEL, 0, 0);
-                            pThis->m_settings.useCustomArea = (areaSel == 1);
-
-                            if (pThis->m_settings.useWebcam) {
-                                // Stop the UI's preview camera so the recording engine can take it
-                                pThis->m_webcamPreview.Stop();
-                                pThis->m_webcamPreview.Cleanup();
-                                KillTimer(hwnd, 103);
-                                
-                                RECT rc;
-                                GetWindowRect(pThis->m_hwndWebcamPreview, &rc);
-                                pThis->m_settings.webcamPos.x = rc.left;
-                                pThis->m_settings.webcamPos.y = rc.top;
-                            }
-
-                            if (pThis->m_settings.useCustomArea) {
-                                // Area is already selected via button, logic simplified
-                            } else {
-                                pThis->m_settings.customRegion = {0}; // Reset
-                                int sel = (int)SendMessage(pThis->m_comboRes, CB_GETCURSEL, 0, 0);
-                                if (sel == 0) { pThis->m_settings.width = 0; pThis->m_settings.height = 0; }
-                                else if (sel == 1) { pThis->m_settings.width = -1; pThis->m_settings.height = 1080; }
-                                else if (sel == 2) { pThis->m_settings.width = -1; pThis->m_settings.height = 720; }
-                                else if (sel == 3) { pThis->m_settings.width = -1; pThis->m_settings.height = 480; }
-                            }
+                            // Normally a no-op: the engine warmed up when these controls last changed
+                            pThis->Prewarm();
 
                             if (pThis->m_settings.useCountdown) {
                                 pThis->StartCountdown();
@@ -961,8 +1094,10 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                                 pThis->m_isRecording = true;
                                 pThis->m_startTime = GetTickCount();
                                 pThis->UpdateButtonState();
+                                pThis->m_warm = false;
                                 if (pThis->m_onStart) pThis->m_onStart();
                                 SetTimer(hwnd, 102, 1000, NULL); // Recording timer
+                                pThis->ToggleOutputPreview(true);
                                 if (pThis->m_settings.useFloatingBar) pThis->SwitchToFloatingBar(true);
                                 
                                 // Show the recording area indicator
@@ -978,6 +1113,7 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                             pThis->m_isPaused = false;
                             pThis->UpdateButtonState();
                             if (pThis->m_onStop) pThis->m_onStop();
+                            pThis->ToggleOutputPreview(false);
                             pThis->SwitchToFloatingBar(false);
                             
                             // Set color back to Green immediately
@@ -990,11 +1126,20 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                             if (pThis->m_settings.useWebcam) {
                                 pThis->ToggleWebcamPreview(true);
                             }
+
+                            // Warm up for the next one while the engine finalizes this one
+                            pThis->Prewarm();
                         }
                         break;
 
                     case 2: // Resolution Combo
                         // No longer resetting area here as they are separate sections
+                        if (HIWORD(wParam) == CBN_SELCHANGE) pThis->Prewarm();
+                        break;
+
+                    case 3:  // Record Audio Checkbox
+                    case 17: // System Audio Checkbox
+                        pThis->Prewarm();
                         break;
 
                     case 9: // Pause Button
@@ -1028,6 +1173,17 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 
                     case 12: // Webcam Checkbox
                         pThis->ToggleWebcamPreview(SendMessage(pThis->m_checkWebcam, BM_GETCHECK, 0, 0) == BST_CHECKED);
+                        pThis->Prewarm();
+                        break;
+
+                    case 6: // Highlight Checkbox (applies live while recording)
+                        pThis->m_settings.showHighlight = (SendMessage(pThis->m_checkHighlight, BM_GETCHECK, 0, 0) == BST_CHECKED);
+                        pThis->PublishLiveSettings();
+                        break;
+
+                    case 7: // Cursor Checkbox (applies live while recording)
+                        pThis->m_settings.showCursor = (SendMessage(pThis->m_checkCursor, BM_GETCHECK, 0, 0) == BST_CHECKED);
+                        pThis->PublishLiveSettings();
                         break;
 
                     case 16: // Live Highlight Checkbox
@@ -1062,12 +1218,20 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                                 pThis->m_settings.customRegion = { 0 };
                                 pThis->ToggleCaptureIndicator(false, { 0 });
                             }
+                            pThis->Prewarm(); // A new source: warm up for it
                         }
                         break;
                     }
                 }
                 break;
 
+            case WM_RECORDING_FAILED: {
+                std::unique_ptr<std::string> message((std::string*)lParam);
+                if (pThis->m_isRecording) SendMessage(hwnd, WM_COMMAND, 1, 0); // Same as pressing Stop
+                MessageBoxA(hwnd, message->c_str(), "Recording stopped", MB_OK | MB_ICONWARNING);
+                break;
+            }
+
             case WM_HOTKEY:
                 if (wParam == 1) { // F9
                     if (!pThis->m_isRecording) {
@@ -1090,8 +1254,10 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                         pThis->m_isRecording = true;
                         pThis->m_startTime = GetTickCount();
                         pThis->UpdateButtonState();
+                        pThis->m_warm = false;
                         if (pThis->m_onStart) pThis->m_onStart();
                         SetTimer(hwnd, 102, 1000, NULL); // Start recording timer
+                        pThis->ToggleOutputPreview(true);
                         if (pThis->m_settings.useFloatingBar) pThis->SwitchToFloatingBar(true);
 
                         // Show the mouse feedback overlay
@@ -1102,12 +1268,14 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                 } else if (wParam == 102) { // Recording timer
                     pThis->UpdateTimer();
                 } else if (wParam == 103) { // Webcam Preview timer
-                    if (pThis->m_webcamPreview.GetFrame(pThis->m_previewFrame, pThis->m_previewW, pThis->m_previewH)) {
+                    // Maps the newest preview-sized frame in place; WM_PAINT draws straight from it
+                    if (pThis->m_previewCamera && pThis->m_previewCamera->HasNewFrame() &&
+                        pThis->m_previewCamera->AcquireFrame(pThis->m_previewView)) {
                         // Dynamically adjust window aspect ratio to match camera
                         RECT rc; GetWindowRect(pThis->m_hwndWebcamPreview, &rc);
                         int curW = rc.right - rc.left;
                         int curH = rc.bottom - rc.top;
-                        int expectedW = (int)((float)pThis->m_previewW / pThis->m_previewH * curH);
+                        int expectedW = (int)((float)pThis->m_previewView.width / pThis->m_previewView.height * curH);
                         if (abs(curW - expectedW) > 5) {
                             int screenW = GetSystemMetrics(SM_CXSCREEN);
                             int screenH = GetSystemMetrics(SM_CYSCREEN);
@@ -1124,6 +1292,10 @@ LRESULT CALLBACK Controller::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
                         }
                         InvalidateRect(pThis->m_hwndWebcamPreview, NULL, FALSE);
                     }
+                } else if (wParam == 105) { // Output preview
+                    if (pThis->m_outputPreview.HasNewFrame() && pThis->m_outputPreview.AcquireFrame(pThis->m_outputView)) {
+                        InvalidateRect(pThis->m_outputPreviewCtl, NULL, FALSE);
+                    }
                 } else if (wParam == 104) { // Mouse Overlay update
                     if (pThis->m_hwndMouseOverlay && pThis->m_settings.showHighlight) {
                         POINT p; GetCursorPos(&p);
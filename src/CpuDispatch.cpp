@@ -0,0 +1,171 @@
+#include "CpuDispatch.hpp"
+#include "PixelConvert.hpp"
+#include "ChangeMap.hpp"
+#include "ScreenCodec.hpp"
+#include "RoiMap.hpp"
+#include "AudioMixer.hpp"
+#include "VisualEffects.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#if defined(SSR_X86_SSE2) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(SSR_X86_SSE2)
+#include <cpuid.h>
+#endif
+
+// Rows are contiguous bytes: the C runtime's memcpy already picks the widest moves the
+// CPU has (and ERMS / non-temporal stores for large copies), so every SIMD level uses it
+static void CopyRow_Scalar(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 4 <= bytes; i += 4) {
+        uint32_t v;
+        memcpy(&v, src + i, 4);
+        memcpy(dst + i, &v, 4);
+    }
+    for (; i < bytes; ++i) dst[i] = src[i];
+}
+
+#ifdef SSR_X86_SSE2
+static void CopyRow_Memcpy(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    memcpy(dst, src, bytes);
+}
+#endif
+
+static CpuDispatch::Isa DetectIsa() {
+#ifdef SSR_X86_SSE2
+    int leaf1[4] = {}, leaf7[4] = {};
+#ifdef _MSC_VER
+    __cpuid(leaf1, 1);
+    __cpuidex(leaf7, 7, 0);
+#else
+    unsigned a, b, c, d;
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+        leaf1[2] = (int)c;
+        leaf1[3] = (int)d;
+    }
+    if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) leaf7[1] = (int)b;
+#endif
+    bool avx2 = (leaf7[1] & (1 << 5)) != 0;
+    // The OS must also save the YMM registers on context switches (OSXSAVE + XCR0 bits 1-2)
+    bool osxsave = (leaf1[2] & (1 << 27)) != 0;
+    if (avx2 && osxsave) {
+#ifdef _MSC_VER
+        unsigned long long xcr0 = _xgetbv(0);
+#else
+        unsigned lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        unsigned long long xcr0 = ((unsigned long long)hi << 32) | lo;
+#endif
+        if ((xcr0 & 6) == 6) return CpuDispatch::Isa::AVX2;
+    }
+    return CpuDispatch::Isa::SSE2; // Baseline of every build that defines SSR_X86_SSE2
+#else
+    return CpuDispatch::Isa::Scalar;
+#endif
+}
+
+static void Bind(CpuDispatch::Kernels& k, CpuDispatch::Isa isa) {
+    using Isa = CpuDispatch::Isa;
+    k.isa = Isa::Scalar;
+    k.copyRow = CopyRow_Scalar;
+    k.blendRow = VisualEffects::BlendRow_Scalar;
+    k.cursorRow = VisualEffects::CursorRow_Scalar;
+    k.scaleRow = PixelConvert::ScaleRowBGRA_Scalar;
+    k.yuvRowToBGRA = PixelConvert::YuvRowToBGRA_Scalar;
+    k.smooth2x2 = RoiMap::Smooth2x2_Scalar;
+    k.hashTile = ChangeMap::HashTile_Scalar;
+    k.runLength = ScreenCodec::RunLength_Scalar;
+    k.s16ToFloat = AudioKernels::S16ToFloat_Scalar;
+    k.mixInto = AudioKernels::MixInto_Scalar;
+    k.dot = AudioKernels::Dot_Scalar;
+
+#ifdef SSR_X86_SSE2
+    if (isa >= Isa::SSE2) {
+        k.isa = Isa::SSE2;
+        k.copyRow = CopyRow_Memcpy;
+        k.blendRow = VisualEffects::BlendRow_SSE2;
+        k.yuvRowToBGRA = PixelConvert::YuvRowToBGRA_SSE2;
+        k.smooth2x2 = RoiMap::Smooth2x2_SSE2;
+        k.hashTile = ChangeMap::HashTile_SSE2;
+        k.runLength = ScreenCodec::RunLength_SSE2;
+        k.s16ToFloat = AudioKernels::S16ToFloat_SSE2;
+        k.mixInto = AudioKernels::MixInto_SSE2;
+        k.dot = AudioKernels::Dot_SSE2;
+    }
+#endif
+#ifdef SSR_X86_AVX2
+    if (isa >= Isa::AVX2) {
+        k.isa = Isa::AVX2;
+        k.blendRow = VisualEffects::BlendRow_AVX2;
+        k.scaleRow = PixelConvert::ScaleRowBGRA_AVX2;
+        k.yuvRowToBGRA = PixelConvert::YuvRowToBGRA_AVX2;
+        k.smooth2x2 = RoiMap::Smooth2x2_AVX2;
+        k.hashTile = ChangeMap::HashTile_AVX2;
+        k.runLength = ScreenCodec::RunLength_AVX2;
+        k.s16ToFloat = AudioKernels::S16ToFloat_AVX2;
+        k.mixInto = AudioKernels::MixInto_AVX2;
+        k.dot = AudioKernels::Dot_AVX2;
+    }
+#endif
+}
+
+static bool g_forced = false;
+
+static CpuDispatch::Kernels& Table() {
+    static CpuDispatch::Kernels kernels = [] {
+        CpuDispatch::Kernels k = {};
+        CpuDispatch::Isa isa = CpuDispatch::Detected();
+        CpuDispatch::Isa forced;
+        const char* env = std::getenv("SSR_FORCE_ISA");
+        if (env && CpuDispatch::Parse(env, forced)) {
+            g_forced = true;
+            if (forced < isa) isa = forced;
+        }
+        Bind(k, isa);
+        return k;
+    }();
+    return kernels;
+}
+
+const CpuDispatch::Kernels& CpuDispatch::Get() {
+    return Table();
+}
+
+CpuDispatch::Isa CpuDispatch::Detected() {
+    static const Isa detected = DetectIsa();
+    return detected;
+}
+
+CpuDispatch::Isa CpuDispatch::Force(Isa isa) {
+    Kernels& k = Table();
+    g_forced = true;
+    Bind(k, isa < Detected() ? isa : Detected());
+    return k.isa;
+}
+
+const char* CpuDispatch::Name(Isa isa) {
+    switch (isa) {
+    case Isa::SSE2: return "sse2";
+    case Isa::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+bool CpuDispatch::Parse(const std::string& name, Isa& isa) {
+    std::string lower;
+    for (char c : name) lower += (char)std::tolower((unsigned char)c);
+    for (Isa candidate : { Isa::Scalar, Isa::SSE2, Isa::AVX2 }) {
+        if (lower == Name(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string CpuDispatch::Describe() {
+    Isa active = Get().isa;
+    return std::string(Name(active)) + (g_forced ? " (forced, detected " : " (detected ") + Name(Detected()) + ")";
+}
@@ -0,0 +1,48 @@
+#include "EngineControl.hpp"
+
+void EngineControl::Post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.push_back(command);
+    }
+    m_commandCv.notify_one();
+}
+
+EngineControl::Command EngineControl::WaitCommand() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_commandCv.wait(lock, [this] { return !m_commands.empty(); });
+    Command command = m_commands.front();
+    m_commands.pop_front();
+    return command;
+}
+
+bool EngineControl::WaitCommandUntil(std::chrono::steady_clock::time_point deadline, Command& out) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_commandCv.wait_until(lock, deadline, [this] { return !m_commands.empty(); })) return false;
+    out = m_commands.front();
+    m_commands.pop_front();
+    return true;
+}
+
+void EngineControl::SetState(State state) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.store(state, std::memory_order_release);
+    }
+    m_stateCv.notify_all();
+}
+
+EngineControl::State EngineControl::WaitWhileState(State state) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stateCv.wait(lock, [&] { return m_state.load(std::memory_order_relaxed) != state; });
+    return m_state.load(std::memory_order_relaxed);
+}
+
+EngineControl::State EngineControl::WaitWhileState(State a, State b) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stateCv.wait(lock, [&] {
+        State s = m_state.load(std::memory_order_relaxed);
+        return s != a && s != b;
+    });
+    return m_state.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,67 @@
+#include "Frame.hpp"
+#include "CpuDispatch.hpp"
+#include <algorithm>
+#include <cstring>
+
+FrameRect FrameRect::Intersect(const FrameRect& o) const {
+    int x0 = std::max(x, o.x);
+    int y0 = std::max(y, o.y);
+    int x1 = std::min(x + width, o.x + o.width);
+    int y1 = std::min(y + height, o.y + o.height);
+    if (x1 <= x0 || y1 <= y0) return {};
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+FrameRect FrameRect::Union(const FrameRect& o) const {
+    if (Empty()) return o;
+    if (o.Empty()) return *this;
+    int x0 = std::min(x, o.x);
+    int y0 = std::min(y, o.y);
+    int x1 = std::max(x + width, o.x + o.width);
+    int y1 = std::max(y + height, o.y + o.height);
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+Frame Frame::Wrap(std::vector<uint8_t>& pixels, int width, int height) {
+    pixels.resize((size_t)width * height * 4);
+    Frame frame;
+    frame.data = pixels.data();
+    frame.stride = width * 4;
+    frame.width = width;
+    frame.height = height;
+    return frame;
+}
+
+Frame Frame::Crop(const FrameRect& rect) const {
+    FrameRect r = rect.Intersect(Bounds());
+    Frame view = *this;
+    view.damage = nullptr;
+    if (r.Empty()) {
+        view.data = nullptr;
+        view.width = view.height = 0;
+        return view;
+    }
+    view.data = Pixel(r.x, r.y);
+    view.width = r.width;
+    view.height = r.height;
+    return view;
+}
+
+void Frame::CopyTo(const Frame& dst) const {
+    if (Empty() || dst.Empty() || dst.width != width || dst.height != height) return;
+    if (IsPacked() && dst.IsPacked()) {
+        CpuDispatch::Get().copyRow(dst.data, data, (size_t)stride * height);
+        return;
+    }
+    CopyRectTo(dst, Bounds());
+}
+
+void Frame::CopyRectTo(const Frame& dst, const FrameRect& rect) const {
+    FrameRect r = rect.Intersect(Bounds()).Intersect(dst.Bounds());
+    if (r.Empty()) return;
+    size_t rowBytes = (size_t)r.width * 4;
+    auto copyRow = CpuDispatch::Get().copyRow;
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        copyRow(dst.Pixel(r.x, y), Pixel(r.x, y), rowBytes);
+    }
+}
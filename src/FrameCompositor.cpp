@@ -0,0 +1,74 @@
+#include "FrameCompositor.hpp"
+
+void FrameCompositor::Copy(const Frame& screen, const FrameRect& rect) {
+    FrameRect r = rect.Intersect(m_output.Bounds());
+    if (r.Empty()) return;
+    screen.CopyRectTo(m_output, r);
+    m_changed.push_back(r);
+    m_stats.bytesCopied += (uint64_t)r.width * r.height * 4;
+}
+
+Frame FrameCompositor::Begin(const Frame& screen, int width, int height) {
+    // Last frame's overlays become this frame's restore list
+    m_overlays.swap(m_drawn);
+    m_drawn.clear();
+    m_changed.clear();
+
+    bool resized = m_output.width != width || m_output.height != height;
+    if (resized) {
+        m_output = Frame::Wrap(m_pixels, width, height);
+        m_sequence = 0;
+        m_overlays.clear();
+    }
+    m_changedAll = resized;
+
+    m_stats.frames++;
+    m_stats.frameBytes += (uint64_t)width * height * 4;
+
+    // A screen image of another size can't be composited; keep showing the last good one
+    // (its overlays stay queued for restore)
+    if (screen.Empty() || screen.width != width || screen.height != height) {
+        m_drawn.swap(m_overlays);
+        return m_output;
+    }
+
+    if (screen.sequence != m_sequence) {
+        // Damage is relative to the previous sequence; anything else needs a full refresh
+        bool contiguous = m_sequence != 0 && screen.sequence == m_sequence + 1;
+        if (contiguous && screen.damage) {
+            for (const FrameRect& r : *screen.damage) Copy(screen, r);
+        } else {
+            screen.CopyTo(m_output);
+            m_stats.bytesCopied += (uint64_t)width * height * 4;
+            m_stats.fullCopies++;
+            m_changedAll = true;
+            m_overlays.clear(); // Already gone
+        }
+        m_sequence = screen.sequence;
+    }
+
+    for (const FrameRect& r : m_overlays) Copy(screen, r);
+    m_overlays.clear();
+    return m_output;
+}
+
+void FrameCompositor::AddOverlay(const FrameRect& rect) {
+    if (!rect.Empty()) m_drawn.push_back(rect);
+}
+
+const std::vector<FrameRect>* FrameCompositor::Damage() {
+    if (m_changedAll) return nullptr;
+    m_damage.assign(m_changed.begin(), m_changed.end());
+    m_damage.insert(m_damage.end(), m_drawn.begin(), m_drawn.end());
+    return &m_damage;
+}
+
+void FrameCompositor::Reset() {
+    m_output = Frame();
+    m_sequence = 0;
+    m_overlays.clear();
+    m_drawn.clear();
+    m_changed.clear();
+    m_changedAll = true;
+    m_stats = Stats();
+}
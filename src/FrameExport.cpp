@@ -0,0 +1,301 @@
+#include "FrameExport.hpp"
+#include <chrono>
+#include <cstring>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+static uint64_t HeaderBytes() { return AlignUp(sizeof(FrameExport::Header), 4096); }
+
+// Maps an existing export (or creates one of `size` bytes when `create`); returns the view and its size
+static void* MapShared(const std::string& name, bool create, uint64_t& size, void*& handle) {
+#ifdef _WIN32
+    std::string objectName = "Local\\" + name;
+    HANDLE mapping = create
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, objectName.c_str())
+        : OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, objectName.c_str());
+    if (!mapping) return nullptr;
+    // A reader still holding the previous export keeps the object alive; it is reused if large enough
+    bool existed = create && GetLastError() == ERROR_ALREADY_EXISTS;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info = {};
+    if (view && VirtualQuery(view, &info, sizeof(info))) {
+        if ((!create || existed) && (uint64_t)info.RegionSize < size) {
+            UnmapViewOfFile(view);
+            view = nullptr;
+        } else if (!create || existed) {
+            size = (uint64_t)info.RegionSize;
+        }
+    }
+    if (!view) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+    handle = (void*)mapping;
+    return view;
+#else
+    std::string objectName = "/" + name;
+    int fd;
+    if (create) {
+        // A fresh object: readers of a previous one see it closed and reopen by name
+        shm_unlink(objectName.c_str());
+        fd = shm_open(objectName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0 && ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            shm_unlink(objectName.c_str());
+            return nullptr;
+        }
+    } else {
+        fd = shm_open(objectName.c_str(), O_RDWR, 0);
+        struct stat st;
+        if (fd >= 0 && (fstat(fd, &st) != 0 || (uint64_t)st.st_size < size)) {
+            close(fd);
+            return nullptr;
+        }
+        if (fd >= 0) size = (uint64_t)st.st_size;
+    }
+    if (fd < 0) return nullptr;
+    void* view = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    handle = nullptr;
+    return view == MAP_FAILED ? nullptr : view;
+#endif
+}
+
+static void UnmapShared(void* view, uint64_t size, void* handle) {
+#ifdef _WIN32
+    (void)size;
+    if (view) UnmapViewOfFile(view);
+    if (handle) CloseHandle((HANDLE)handle);
+#else
+    (void)handle;
+    if (view) munmap(view, (size_t)size);
+#endif
+}
+
+int64_t FrameExport::NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// --- FrameExport ---
+
+FrameExport::~FrameExport() {
+    Close();
+}
+
+bool FrameExport::Open(const std::string& name, int maxWidth, int maxHeight) {
+    Close();
+    if (name.empty() || maxWidth <= 0 || maxHeight <= 0) return false;
+
+    uint64_t slotBytes = AlignUp((uint64_t)maxWidth * maxHeight * 4, 4096);
+    uint64_t size = HeaderBytes() + slotBytes * kSlots;
+    void* view = MapShared(name, true, size, m_handle);
+    if (!view) return false;
+
+    m_header = (Header*)view;
+    m_size = size;
+    m_name = name;
+
+    // A reused mapping keeps its slot sequences (tokens held by readers stay comparable)
+    // and its publish counter; everything else is rewritten
+    m_header->version = kVersion;
+    m_header->slotCount = kSlots;
+    m_header->maxWidth = maxWidth;
+    m_header->maxHeight = maxHeight;
+    m_header->slotBytes = slotBytes;
+    m_header->pixelsOffset = HeaderBytes();
+    m_header->closed.store(0, std::memory_order_relaxed);
+    for (SlotHeader& slot : m_header->slots) {
+        uint64_t seq = slot.seqlock.load(std::memory_order_relaxed);
+        if (seq & 1) slot.seqlock.store(seq + 1, std::memory_order_relaxed);
+    }
+    // The magic goes last: readers that see it also see the rest of the header
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, kMagic, sizeof(kMagic));
+
+    AddDamage(nullptr, FrameRect{});
+    m_stats = Stats();
+    return true;
+}
+
+void FrameExport::Close() {
+    if (!m_header) return;
+    m_header->closed.store(1, std::memory_order_release);
+    UnmapShared(m_header, m_size, m_handle);
+#ifndef _WIN32
+    shm_unlink(("/" + m_name).c_str());
+#endif
+    m_header = nullptr;
+    m_handle = nullptr;
+    m_size = 0;
+}
+
+void FrameExport::AddDamage(const std::vector<FrameRect>* damage, const FrameRect& bounds) {
+    // Past half the frame one memcpy beats many row copies
+    uint64_t limit = (uint64_t)bounds.width * bounds.height / 2;
+    for (uint32_t k = 0; k < kSlots; ++k) {
+        if (!damage) {
+            m_pendingAll[k] = true;
+            m_pending[k].clear();
+            continue;
+        }
+        if (m_pendingAll[k]) continue;
+        for (const FrameRect& rect : *damage) {
+            FrameRect r = rect.Intersect(bounds);
+            if (r.Empty()) continue;
+            m_pending[k].push_back(r);
+            m_pendingArea[k] += (uint64_t)r.width * r.height;
+        }
+        if (m_pendingArea[k] > limit) {
+            m_pendingAll[k] = true;
+            m_pending[k].clear();
+        }
+    }
+}
+
+bool FrameExport::Publish(const Frame& frame, uint64_t frameNumber) {
+    if (!m_header || frame.Empty() || frame.format != PixelConvert::Format::BGRA || !Fits(frame.width, frame.height)) return false;
+
+    // Copying 8-33 MB per frame for nobody is wasted bandwidth
+    if (NowUs() - m_header->readerSeenUs.load(std::memory_order_relaxed) > kReaderTimeoutUs) {
+        AddDamage(nullptr, frame.Bounds()); // The chain of damage is broken
+        m_stats.skipped++;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t index = m_header->published.load(std::memory_order_relaxed);
+    uint32_t k = (uint32_t)(index % kSlots);
+    SlotHeader& slot = m_header->slots[k];
+    Frame pixels{ (uint8_t*)m_header + m_header->pixelsOffset + k * m_header->slotBytes, frame.width * 4, frame.width, frame.height };
+
+    // The slot holds the frame from kSlots publishes ago: it misses that much damage
+    AddDamage(frame.damage, frame.Bounds());
+    if (slot.width != frame.width || slot.height != frame.height) m_pendingAll[k] = true;
+
+    // Seqlock write: odd before the first store, even (one step further) after the last
+    uint64_t seq = slot.seqlock.load(std::memory_order_relaxed);
+    slot.seqlock.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.frameNumber = frameNumber;
+    slot.timestampUs = frame.timestampUs;
+    slot.captureSequence = frame.sequence;
+    slot.width = frame.width;
+    slot.height = frame.height;
+    slot.stride = pixels.stride;
+    slot.format = (int32_t)frame.format;
+    uint64_t copied = 0;
+    if (m_pendingAll[k]) {
+        frame.CopyTo(pixels);
+        copied = (uint64_t)frame.width * frame.height * 4;
+        m_stats.fullCopies++;
+    } else {
+        for (const FrameRect& r : m_pending[k]) frame.CopyRectTo(pixels, r);
+        copied = m_pendingArea[k] * 4;
+    }
+    m_pending[k].clear();
+    m_pendingArea[k] = 0;
+    m_pendingAll[k] = false;
+
+    slot.seqlock.store(seq + 2, std::memory_order_release);
+    m_header->published.store(index + 1, std::memory_order_release);
+
+    m_stats.published++;
+    m_stats.bytes += copied;
+    m_stats.frameBytes += (uint64_t)frame.width * frame.height * 4;
+    m_stats.publishUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// --- FrameExportReader ---
+
+FrameExportReader::~FrameExportReader() {
+    Close();
+}
+
+bool FrameExportReader::Open(const std::string& name) {
+    Close();
+    uint64_t size = HeaderBytes();
+    void* view = MapShared(name, false, size, m_handle);
+    if (!view) return false;
+
+    FrameExport::Header* header = (FrameExport::Header*)view;
+    bool valid = memcmp(header->magic, FrameExport::kMagic, sizeof(FrameExport::kMagic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && header->version == FrameExport::kVersion && header->slotCount == FrameExport::kSlots &&
+            header->pixelsOffset + header->slotBytes * FrameExport::kSlots <= size;
+    if (!valid) {
+        UnmapShared(view, size, m_handle);
+        m_handle = nullptr;
+        return false;
+    }
+    m_header = header;
+    m_size = size;
+    // Checking in here lets the writer start publishing before the first Acquire()
+    m_header->readerSeenUs.store(FrameExport::NowUs(), std::memory_order_relaxed);
+    return true;
+}
+
+void FrameExportReader::Close() {
+    if (!m_header) return;
+    UnmapShared(m_header, m_size, m_handle);
+    m_header = nullptr;
+    m_handle = nullptr;
+    m_size = 0;
+}
+
+bool FrameExportReader::Acquire(Frame& out, Token& token, uint64_t after) {
+    if (!m_header) return false;
+    m_header->readerSeenUs.store(FrameExport::NowUs(), std::memory_order_relaxed);
+
+    uint64_t published = m_header->published.load(std::memory_order_acquire);
+    if (published == 0 || published <= after) return false;
+
+    uint32_t index = (uint32_t)((published - 1) % FrameExport::kSlots);
+    const FrameExport::SlotHeader& slot = m_header->slots[index];
+    uint64_t seq = slot.seqlock.load(std::memory_order_acquire);
+    if (seq & 1) return false; // Lapped while looking; the next call finds a newer frame
+
+    FrameExport::SlotHeader info;
+    info.frameNumber = slot.frameNumber;
+    info.timestampUs = slot.timestampUs;
+    info.captureSequence = slot.captureSequence;
+    info.width = slot.width;
+    info.height = slot.height;
+    info.stride = slot.stride;
+    info.format = slot.format;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seqlock.load(std::memory_order_relaxed) != seq) return false;
+    if (info.width <= 0 || info.height <= 0 || info.width > m_header->maxWidth || info.height > m_header->maxHeight) return false;
+
+    out = Frame();
+    out.data = (uint8_t*)m_header + m_header->pixelsOffset + index * m_header->slotBytes;
+    out.stride = info.stride;
+    out.width = info.width;
+    out.height = info.height;
+    out.format = (PixelConvert::Format)info.format;
+    out.timestampUs = info.timestampUs;
+    out.sequence = info.captureSequence;
+
+    token.slot = index;
+    token.seqlock = seq;
+    token.published = published;
+    token.frameNumber = info.frameNumber;
+    return true;
+}
+
+bool FrameExportReader::Valid(const Token& token) const {
+    if (!m_header || token.slot >= FrameExport::kSlots) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return m_header->slots[token.slot].seqlock.load(std::memory_order_relaxed) == token.seqlock;
+}
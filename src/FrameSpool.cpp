@@ -0,0 +1,304 @@
+#include "FrameSpool.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <Windows.h>
+
+static uint64_t Align8(uint64_t v) { return (v + 7) & ~7ull; }
+
+// --- FrameSpool ---
+
+FrameSpool::~FrameSpool() {
+    Finish();
+}
+
+std::string FrameSpool::AudioPath(const std::string& spoolPath, int track) {
+    return spoolPath + ".a" + std::to_string(track);
+}
+
+bool FrameSpool::Map(uint64_t capacity) {
+    // Extending the file first makes the mapping size the file size; new pages read as zero
+    LARGE_INTEGER size;
+    size.QuadPart = (LONGLONG)capacity;
+    if (!SetFilePointerEx((HANDLE)m_file, size, NULL, FILE_BEGIN) || !SetEndOfFile((HANDLE)m_file)) return false;
+
+    HANDLE mapping = CreateFileMappingA((HANDLE)m_file, NULL, PAGE_READWRITE, 0, 0, NULL);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = (void*)mapping;
+    m_view = (uint8_t*)view;
+    m_capacity = capacity;
+    return true;
+}
+
+void FrameSpool::Unmap() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    m_view = nullptr;
+    m_mapping = nullptr;
+}
+
+uint8_t* FrameSpool::Reserve(uint64_t bytes) {
+    if (m_used + bytes > m_capacity) {
+        // Grow by half again (rare: the initial size covers a second of raw frames)
+        uint64_t capacity = m_capacity + m_capacity / 2;
+        if (capacity < m_used + bytes) capacity = m_used + bytes;
+        capacity = (capacity + 0xFFFF) & ~0xFFFFull;
+        Unmap();
+        if (!Map(capacity)) return nullptr;
+    }
+    uint8_t* p = m_view + m_used;
+    m_used += Align8(bytes);
+    return p;
+}
+
+bool FrameSpool::Create(const std::string& path, int width, int height, int fps,
+                        int targetWidth, int targetHeight, int audioTracks, uint32_t flags) {
+    if (m_view || width <= 0 || height <= 0 || fps <= 0) return false;
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m_file = (void*)file;
+    m_path = path;
+
+    // Preallocate one second of raw frames (at least 64 MB) so the mapping rarely has to grow
+    uint64_t frameBytes = (uint64_t)width * height * 4;
+    uint64_t initial = frameBytes * fps;
+    if (initial < (64ull << 20)) initial = 64ull << 20;
+    if (!Map(kHeaderBytes + initial)) {
+        CloseHandle(file);
+        m_file = nullptr;
+        return false;
+    }
+
+    for (int t = 0; t < audioTracks; ++t) {
+        std::FILE* f = std::fopen(AudioPath(path, t).c_str(), "wb");
+        if (!f) {
+            Discard();
+            return false;
+        }
+        m_audio.push_back(f);
+    }
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, kMagic, sizeof(kMagic));
+    m_header.version = kVersion;
+    m_header.width = width;
+    m_header.height = height;
+    m_header.fps = fps;
+    m_header.targetWidth = targetWidth;
+    m_header.targetHeight = targetHeight;
+    m_header.audioTracks = audioTracks;
+    m_header.keyInterval = (uint32_t)fps * 10;
+    m_header.flags = flags;
+    memcpy(m_view, &m_header, sizeof(m_header));
+
+    m_used = kHeaderBytes;
+    m_header.dataEnd = m_used;
+    m_index.clear();
+    m_codec.Reset();
+    m_stats = Stats();
+    return true;
+}
+
+bool FrameSpool::WriteFrame(const Frame& frame) {
+    if (!m_view) return false;
+    if (frame.Empty() || frame.width != m_header.width || frame.height != m_header.height) return false;
+    auto start = std::chrono::steady_clock::now();
+
+    // The codec's change map stays current on every frame, so each delta is against the previous one
+    bool key = m_index.size() % m_header.keyInterval == 0;
+    bool changed = m_codec.Encode(frame, key, m_encoded);
+    uint64_t frameBytes = (uint64_t)frame.width * frame.height * 4;
+
+    RecordHeader rec = {};
+    rec.type = !changed ? Repeat : (key ? Key : Delta);
+    rec.changedTiles = changed ? (uint32_t)m_codec.LastChangedTiles() : 0;
+    rec.payloadBytes = changed ? m_encoded.size() : 0;
+    rec.timestampUs = frame.timestampUs;
+
+    uint64_t offset = m_used;
+    uint8_t* p = Reserve(sizeof(RecordHeader) + rec.payloadBytes);
+    if (!p) return false;
+
+    // Plain sequential stores into the mapping; the OS writes the pages back in the background
+    memcpy(p, &rec, sizeof(rec));
+    if (rec.payloadBytes) memcpy(p + sizeof(rec), m_encoded.data(), rec.payloadBytes);
+    if (rec.type == Key) m_stats.keyFrames++;
+    else if (rec.type == Delta) m_stats.deltaFrames++;
+    else m_stats.repeatFrames++;
+
+    m_index.push_back(offset);
+    m_header.dataEnd = m_used; // Finish() never trims below this, even if the mapping is lost later
+    m_stats.frames++;
+    m_stats.bytesWritten += m_used - offset;
+    m_stats.rawBytes += frameBytes;
+    m_stats.writeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+bool FrameSpool::WriteAudio(int track, const std::vector<float>& samples) {
+    if (track < 0 || track >= (int)m_audio.size()) return false;
+    if (samples.empty()) return true;
+    return std::fwrite(samples.data(), sizeof(float), samples.size(), m_audio[track]) == samples.size();
+}
+
+void FrameSpool::Finish() {
+    for (std::FILE* f : m_audio) std::fclose(f);
+    m_audio.clear();
+    if (!m_file) return;
+
+    // m_header.dataEnd is the end of the last complete record. The index goes after it if the
+    // mapping can still take it; if growing the mapping failed (disk full), the spool ends there
+    // and the reader rebuilds the index by scanning.
+    m_header.frameCount = m_index.size();
+    if (m_view) {
+        uint8_t* index = Reserve(m_index.size() * sizeof(uint64_t));
+        if (index) {
+            memcpy(index, m_index.data(), m_index.size() * sizeof(uint64_t));
+            m_header.indexOffset = m_header.dataEnd;
+        }
+    }
+    if (m_view) {
+        memcpy(m_view, &m_header, sizeof(m_header));
+    } else {
+        LARGE_INTEGER start = {};
+        DWORD written;
+        if (SetFilePointerEx((HANDLE)m_file, start, NULL, FILE_BEGIN)) {
+            WriteFile((HANDLE)m_file, &m_header, sizeof(m_header), &written, NULL);
+        }
+    }
+    Unmap();
+
+    // Drop the unused preallocation (never anything that was written)
+    LARGE_INTEGER size;
+    size.QuadPart = (LONGLONG)(m_header.indexOffset ? m_used : m_header.dataEnd);
+    if (SetFilePointerEx((HANDLE)m_file, size, NULL, FILE_BEGIN)) SetEndOfFile((HANDLE)m_file);
+    CloseHandle((HANDLE)m_file);
+    m_file = nullptr;
+}
+
+void FrameSpool::Discard() {
+    if (!m_file) return;
+    int tracks = (int)m_audio.size();
+    Finish();
+    std::error_code ec;
+    std::filesystem::remove(m_path, ec);
+    for (int t = 0; t < tracks; ++t) std::filesystem::remove(AudioPath(m_path, t), ec);
+}
+
+// --- FrameSpoolReader ---
+
+FrameSpoolReader::~FrameSpoolReader() {
+    Close();
+}
+
+bool FrameSpoolReader::Open(const std::string& path) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m_file = (void*)file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart < FrameSpool::kHeaderBytes) {
+        Close();
+        return false;
+    }
+    m_size = (uint64_t)size.QuadPart;
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    m_mapping = (void*)mapping;
+    m_view = mapping ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!m_view) {
+        Close();
+        return false;
+    }
+
+    memcpy(&m_header, m_view, sizeof(m_header));
+    if (memcmp(m_header.magic, FrameSpool::kMagic, sizeof(FrameSpool::kMagic)) != 0 ||
+        m_header.version < FrameSpool::kOldestVersion || m_header.version > FrameSpool::kVersion ||
+        m_header.width <= 0 || m_header.height <= 0 || m_header.fps <= 0) {
+        Close();
+        return false;
+    }
+    if (m_header.version < 3) m_header.flags = 0;
+
+    uint64_t indexBytes = m_header.frameCount * sizeof(uint64_t);
+    if (m_header.indexOffset != 0 && m_header.indexOffset + indexBytes <= m_size) {
+        m_index.resize(m_header.frameCount);
+        memcpy(m_index.data(), m_view + m_header.indexOffset, indexBytes);
+    } else {
+        Scan();
+    }
+
+    m_canvas = Frame::Wrap(m_pixels, m_header.width, m_header.height);
+    return true;
+}
+
+void FrameSpoolReader::Scan() {
+    // Unfinished spool: records are self-describing and the preallocated tail is zeros
+    m_index.clear();
+    uint64_t offset = FrameSpool::kHeaderBytes;
+    while (offset + sizeof(FrameSpool::RecordHeader) <= m_size) {
+        FrameSpool::RecordHeader rec;
+        memcpy(&rec, m_view + offset, sizeof(rec));
+        if (rec.type < FrameSpool::Key || rec.type > FrameSpool::Repeat) break;
+        uint64_t end = offset + sizeof(rec) + rec.payloadBytes;
+        if (end > m_size) break;
+        m_index.push_back(offset);
+        offset = Align8(end);
+    }
+}
+
+bool FrameSpoolReader::Next(Frame& out) {
+    if (!m_view || m_next >= m_index.size()) return false;
+    uint64_t offset = m_index[m_next];
+    if (offset + sizeof(FrameSpool::RecordHeader) > m_size) return false;
+
+    FrameSpool::RecordHeader rec;
+    memcpy(&rec, m_view + offset, sizeof(rec));
+    const uint8_t* p = m_view + offset + sizeof(rec);
+    if (offset + sizeof(rec) + rec.payloadBytes > m_size) return false;
+
+    if (rec.type == FrameSpool::Key || rec.type == FrameSpool::Delta) {
+        if (!ScreenCodec::Decode(p, (size_t)rec.payloadBytes, m_canvas)) return false;
+    } else if (rec.type != FrameSpool::Repeat) {
+        return false;
+    }
+
+    m_canvas.timestampUs = rec.timestampUs;
+    m_canvas.sequence = ++m_next;
+    out = m_canvas;
+    return true;
+}
+
+void FrameSpoolReader::ChangedFractions(std::vector<float>& out) const {
+    out.clear();
+    if (!m_view) return;
+    int tileSize = ChangeMap::kTileSize;
+    double tiles = (double)((m_header.width + tileSize - 1) / tileSize) * ((m_header.height + tileSize - 1) / tileSize);
+    out.reserve(m_index.size());
+    for (uint64_t offset : m_index) {
+        FrameSpool::RecordHeader rec = {};
+        if (offset + sizeof(rec) <= m_size) memcpy(&rec, m_view + offset, sizeof(rec));
+        out.push_back((float)(rec.changedTiles / tiles));
+    }
+}
+
+void FrameSpoolReader::Close() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    if (m_file) CloseHandle((HANDLE)m_file);
+    m_view = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_index.clear();
+    m_next = 0;
+}
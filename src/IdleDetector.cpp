@@ -0,0 +1,58 @@
+#include "IdleDetector.hpp"
+
+void IdleDetector::Configure(int fps, int idleSeconds) {
+    m_idleFrames = (idleSeconds > 0 && fps > 0) ? (int64_t)idleSeconds * fps : 0;
+    m_prerollFrames = (int)(kPrerollSeconds * fps + 0.5);
+    Reset();
+}
+
+void IdleDetector::Reset() {
+    m_quietFrames = 0;
+    m_periodSkipped = 0;
+    m_haveMouse = false;
+    m_idle.store(false, std::memory_order_release);
+    m_audioRms.store(0.0f, std::memory_order_relaxed);
+    m_stats = Stats();
+}
+
+IdleDetector::Action IdleDetector::Update(const Frame& screen, bool screenChanged, POINT mouse) {
+    if (m_idleFrames == 0) return Action::Record;
+
+    bool active = false;
+    if (screenChanged) {
+        if (!screen.damage) {
+            active = true; // Unknown extent
+        } else {
+            int64_t pixels = 0;
+            for (const FrameRect& r : *screen.damage) pixels += (int64_t)r.width * r.height;
+            active = pixels > kMinChangedPixels;
+        }
+    }
+    if (m_haveMouse && (mouse.x != m_lastMouse.x || mouse.y != m_lastMouse.y)) active = true;
+    m_lastMouse = mouse;
+    m_haveMouse = true;
+    if (m_audioRms.load(std::memory_order_relaxed) > kSilenceRms) active = true;
+
+    if (active) {
+        m_quietFrames = 0;
+        if (m_idle.load(std::memory_order_relaxed)) {
+            m_idle.store(false, std::memory_order_release);
+            return Action::Resume;
+        }
+        return Action::Record;
+    }
+
+    if (m_idle.load(std::memory_order_relaxed)) {
+        m_stats.skippedFrames++;
+        m_periodSkipped++;
+        return Action::Skip;
+    }
+    if (++m_quietFrames >= m_idleFrames) {
+        m_idle.store(true, std::memory_order_release);
+        m_stats.idlePeriods++;
+        m_stats.skippedFrames++;
+        m_periodSkipped = 1;
+        return Action::Skip;
+    }
+    return Action::Record;
+}
@@ -0,0 +1,48 @@
+#include "OverlayPipeline.hpp"
+#include "RoiMap.hpp"
+#include "FrameCompositor.hpp"
+#include "VisualEffects.hpp"
+
+template <bool Roi, bool Highlight, bool Cursor>
+void OverlayPipeline::RunStage(OverlayPipeline& self, const Frame& out, const Input& input, RoiMap& roi, FrameCompositor& compositor) {
+    // Only polled when the highlight is on: it is a system call
+    bool clicked = false;
+    if constexpr (Highlight) clicked = VisualEffects::IsLeftClicked();
+    int radius = clicked ? 30 : 25;
+
+    // Region of interest: areas changing continuously away from the cursor are coarsened
+    // before the overlays go on; the compositor restores them from the screen next frame
+    if constexpr (Roi) {
+        FrameRect highlight = Highlight
+            ? FrameRect{ (int)input.mouse.x - radius, (int)input.mouse.y - radius, 2 * radius, 2 * radius }
+            : FrameRect{};
+        roi.Update(out.width, out.height, input.damage, input.mouse, highlight);
+        self.m_touched.clear();
+        roi.Apply(out, self.m_touched);
+        for (const FrameRect& r : self.m_touched) compositor.AddOverlay(r);
+    }
+
+    if constexpr (Highlight) {
+        VisualEffects::Color color = clicked ? VisualEffects::Color{ 255, 0, 0, 150 } : VisualEffects::Color{ 255, 255, 0, 100 };
+        compositor.AddOverlay(VisualEffects::DrawHighlight(out, input.mouse, radius, color));
+    }
+    if constexpr (Cursor) {
+        compositor.AddOverlay(VisualEffects::DrawCursor(out, input.mouse));
+    }
+}
+
+OverlayPipeline::OverlayPipeline() {
+    Configure(Features());
+}
+
+void OverlayPipeline::Configure(const Features& features) {
+    // Indexed by roi << 2 | highlight << 1 | cursor
+    static const Stage kStages[8] = {
+        &RunStage<false, false, false>, &RunStage<false, false, true>,
+        &RunStage<false, true, false>,  &RunStage<false, true, true>,
+        &RunStage<true, false, false>,  &RunStage<true, false, true>,
+        &RunStage<true, true, false>,   &RunStage<true, true, true>,
+    };
+    m_features = features;
+    m_stage = kStages[(features.roi ? 4 : 0) | (features.highlight ? 2 : 0) | (features.cursor ? 1 : 0)];
+}
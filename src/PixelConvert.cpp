@@ -0,0 +1,190 @@
+#include "PixelConvert.hpp"
+#include "CpuDispatch.hpp"
+#include <cstddef>
+#include <vector>
+#include <cstring>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+// BT.601 limited range in 6-bit fixed point:
+// 1.164 -> 75, 1.596 -> 102, 0.391 -> 25, 0.813 -> 52, 2.018 -> 129
+static inline uint8_t Clamp8(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+void PixelConvert::YuvRowToBGRA_Scalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count) {
+    for (int i = 0; i < count; ++i) {
+        int c = y[i] - 16;
+        int d = u[i] - 128;
+        int e = v[i] - 128;
+        int yy = 75 * c;
+        dst[i * 4 + 0] = Clamp8((yy + 129 * d + 32) >> 6);
+        dst[i * 4 + 1] = Clamp8((yy - (25 * d + 52 * e) + 32) >> 6);
+        dst[i * 4 + 2] = Clamp8((yy + 102 * e + 32) >> 6);
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+void PixelConvert::YuvRowToBGRA(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count) {
+    CpuDispatch::Get().yuvRowToBGRA(y, u, v, dst, count);
+}
+
+#ifdef SSR_X86_SSE2
+void PixelConvert::YuvRowToBGRA_SSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count) {
+    int i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k16 = _mm_set1_epi16(16);
+    const __m128i k128 = _mm_set1_epi16(128);
+    const __m128i kY = _mm_set1_epi16(75);
+    const __m128i kRV = _mm_set1_epi16(102);
+    const __m128i kGU = _mm_set1_epi16(25);
+    const __m128i kGV = _mm_set1_epi16(52);
+    const __m128i kBU = _mm_set1_epi16(129);
+    const __m128i kRound = _mm_set1_epi16(32);
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(y + i)), zero), k16);
+        __m128i d = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + i)), zero), k128);
+        __m128i e = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v + i)), zero), k128);
+
+        // Saturating adds only clip values that clamp to 255 anyway, so this matches the scalar path
+        __m128i yy = _mm_mullo_epi16(c, kY);
+        __m128i r = _mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(e, kRV)), kRound);
+        __m128i g = _mm_adds_epi16(_mm_subs_epi16(yy, _mm_adds_epi16(_mm_mullo_epi16(d, kGU), _mm_mullo_epi16(e, kGV))), kRound);
+        __m128i b = _mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(d, kBU)), kRound);
+
+        __m128i r8 = _mm_packus_epi16(_mm_srai_epi16(r, 6), zero);
+        __m128i g8 = _mm_packus_epi16(_mm_srai_epi16(g, 6), zero);
+        __m128i b8 = _mm_packus_epi16(_mm_srai_epi16(b, 6), zero);
+
+        __m128i bg = _mm_unpacklo_epi8(b8, g8);
+        __m128i ra = _mm_unpacklo_epi8(r8, alpha);
+        _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i*)(dst + i * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+    if (i < count) YuvRowToBGRA_Scalar(y + i, u + i, v + i, dst + i * 4, count - i);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+// Same arithmetic as the SSE2 version, 16 pixels per iteration
+SSR_TARGET_AVX2
+void PixelConvert::YuvRowToBGRA_AVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int count) {
+    int i = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k16 = _mm256_set1_epi16(16);
+    const __m256i k128 = _mm256_set1_epi16(128);
+    const __m256i kY = _mm256_set1_epi16(75);
+    const __m256i kRV = _mm256_set1_epi16(102);
+    const __m256i kGU = _mm256_set1_epi16(25);
+    const __m256i kGV = _mm256_set1_epi16(52);
+    const __m256i kBU = _mm256_set1_epi16(129);
+    const __m256i kRound = _mm256_set1_epi16(32);
+    const __m256i alpha = _mm256_set1_epi8((char)0xFF);
+
+    for (; i + 16 <= count; i += 16) {
+        __m256i c = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(y + i))), k16);
+        __m256i d = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(u + i))), k128);
+        __m256i e = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(v + i))), k128);
+
+        __m256i yy = _mm256_mullo_epi16(c, kY);
+        __m256i r = _mm256_adds_epi16(_mm256_adds_epi16(yy, _mm256_mullo_epi16(e, kRV)), kRound);
+        __m256i g = _mm256_adds_epi16(_mm256_subs_epi16(yy, _mm256_adds_epi16(_mm256_mullo_epi16(d, kGU), _mm256_mullo_epi16(e, kGV))), kRound);
+        __m256i b = _mm256_adds_epi16(_mm256_adds_epi16(yy, _mm256_mullo_epi16(d, kBU)), kRound);
+
+        // Packs and unpacks work per 128-bit lane: lane 0 ends up with pixels 0-7, lane 1 with 8-15
+        __m256i r8 = _mm256_packus_epi16(_mm256_srai_epi16(r, 6), zero);
+        __m256i g8 = _mm256_packus_epi16(_mm256_srai_epi16(g, 6), zero);
+        __m256i b8 = _mm256_packus_epi16(_mm256_srai_epi16(b, 6), zero);
+
+        __m256i bg = _mm256_unpacklo_epi8(b8, g8);
+        __m256i ra = _mm256_unpacklo_epi8(r8, alpha);
+        __m256i lo = _mm256_unpacklo_epi16(bg, ra); // Pixels 0-3 | 8-11
+        __m256i hi = _mm256_unpackhi_epi16(bg, ra); // Pixels 4-7 | 12-15
+        _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + i * 4 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    _mm256_zeroupper();
+    if (i < count) YuvRowToBGRA_SSE2(y + i, u + i, v + i, dst + i * 4, count - i);
+}
+#endif
+
+void PixelConvert::ScaleRowBGRA_Scalar(uint32_t* dst, const uint32_t* src, const int* xMap, int count) {
+    for (int x = 0; x < count; ++x) dst[x] = src[xMap[x]] | 0xFF000000u;
+}
+
+void PixelConvert::ScaleRowBGRA(uint32_t* dst, const uint32_t* src, const int* xMap, int count) {
+    CpuDispatch::Get().scaleRow(dst, src, xMap, count);
+}
+
+#ifdef SSR_X86_AVX2
+// SSE2 has no gather, so that level keeps the scalar loop
+SSR_TARGET_AVX2
+void PixelConvert::ScaleRowBGRA_AVX2(uint32_t* dst, const uint32_t* src, const int* xMap, int count) {
+    int x = 0;
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000u);
+    for (; x + 8 <= count; x += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(xMap + x));
+        __m256i px = _mm256_i32gather_epi32((const int*)src, idx, 4);
+        _mm256_storeu_si256((__m256i*)(dst + x), _mm256_or_si256(px, alpha));
+    }
+    _mm256_zeroupper();
+    if (x < count) ScaleRowBGRA_Scalar(dst + x, src, xMap + x, count - x);
+}
+#endif
+
+void PixelConvert::ConvertScaled(const uint8_t* src, int srcStride, int srcW, int srcH, Format format,
+                                 uint8_t* dst, int dstStride, int dstW, int dstH, const uint8_t* uvPlane) {
+    if (!src || !dst || srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0) return;
+
+    // Source column for every output column (nearest neighbour)
+    thread_local std::vector<int> xMap;
+    thread_local std::vector<uint8_t> yRow, uRow, vRow;
+    xMap.resize(dstW);
+    for (int x = 0; x < dstW; ++x) xMap[x] = (int)((int64_t)x * srcW / dstW);
+
+    if (format == Format::BGRA) {
+        auto scaleRow = CpuDispatch::Get().scaleRow;
+        for (int y = 0; y < dstH; ++y) {
+            int sy = (int)((int64_t)y * srcH / dstH);
+            scaleRow((uint32_t*)(dst + (size_t)y * dstStride), (const uint32_t*)(src + (ptrdiff_t)sy * srcStride), xMap.data(), dstW);
+        }
+        return;
+    }
+
+    yRow.resize(dstW);
+    uRow.resize(dstW);
+    vRow.resize(dstW);
+    auto yuvRowToBGRA = CpuDispatch::Get().yuvRowToBGRA;
+    if (format == Format::NV12 && !uvPlane) uvPlane = src + (ptrdiff_t)srcH * srcStride;
+
+    for (int y = 0; y < dstH; ++y) {
+        int sy = (int)((int64_t)y * srcH / dstH);
+
+        // Gather only the samples this output row needs, then convert them in bulk
+        if (format == Format::NV12) {
+            const uint8_t* yLine = src + (ptrdiff_t)sy * srcStride;
+            const uint8_t* uvLine = uvPlane + (ptrdiff_t)(sy / 2) * srcStride;
+            for (int x = 0; x < dstW; ++x) {
+                int sx = xMap[x];
+                yRow[x] = yLine[sx];
+                uRow[x] = uvLine[sx & ~1];
+                vRow[x] = uvLine[(sx & ~1) + 1];
+            }
+        } else { // YUY2
+            const uint8_t* row = src + (ptrdiff_t)sy * srcStride;
+            for (int x = 0; x < dstW; ++x) {
+                int sx = xMap[x];
+                const uint8_t* pair = row + (size_t)(sx & ~1) * 2;
+                yRow[x] = row[(size_t)sx * 2];
+                uRow[x] = pair[1];
+                vRow[x] = pair[3];
+            }
+        }
+
+        yuvRowToBGRA(yRow.data(), uRow.data(), vRow.data(), dst + (size_t)y * dstStride, dstW);
+    }
+}
@@ -0,0 +1,48 @@
+#include "PreviewSink.hpp"
+#include "PixelConvert.hpp"
+
+void PreviewSink::Configure(int maxWidth, int maxHeight, int maxFps) {
+    if (maxWidth > 0) m_maxWidth = maxWidth;
+    if (maxHeight > 0) m_maxHeight = maxHeight;
+    m_intervalMs = maxFps > 0 ? 1000 / maxFps : 0;
+}
+
+bool PreviewSink::WantsFrame() const {
+    auto interval = std::chrono::milliseconds(m_intervalMs.load());
+    return std::chrono::steady_clock::now() - m_lastSubmit >= interval;
+}
+
+bool PreviewSink::Submit(const uint8_t* bgra, int stride, int width, int height) {
+    if (!bgra || width <= 0 || height <= 0 || !WantsFrame()) return false;
+    m_lastSubmit = std::chrono::steady_clock::now();
+
+    // Fit into the preview box without upscaling
+    int maxW = m_maxWidth;
+    int maxH = m_maxHeight;
+    int outW = width;
+    int outH = height;
+    if (outW > maxW) { outH = (int)((int64_t)outH * maxW / outW); outW = maxW; }
+    if (outH > maxH) { outW = (int)((int64_t)outW * maxH / outH); outH = maxH; }
+    if (outW <= 0 || outH <= 0) return false;
+
+    Slot& slot = m_frames.WriteBuffer();
+    slot.pixels.resize((size_t)outW * outH * 4);
+    slot.width = outW;
+    slot.height = outH;
+    PixelConvert::ConvertScaled(bgra, stride, width, height, PixelConvert::Format::BGRA,
+                                slot.pixels.data(), outW * 4, outW, outH);
+    m_frames.Publish();
+    return true;
+}
+
+bool PreviewSink::AcquireFrame(FrameView& out) {
+    m_frames.Update();
+    const Slot& slot = m_frames.ReadBuffer();
+    if (slot.pixels.empty()) return false;
+
+    out.data = slot.pixels.data();
+    out.width = slot.width;
+    out.height = slot.height;
+    out.sequence = m_frames.ReadSequence();
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "RateController.hpp"
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <sstream>
+
+// VBV cap in bits per pixel per frame. Typing and static desktops stay far below it at
+// CRF 23; scrolling text at ultrafast otherwise peaks at several times this.
+static const double kCapBitsPerPixel = 0.1;
+static const int kBufferSeconds = 2;
+static const int kMaxGopSeconds = 20;
+
+std::string RateController::Params::EncoderArgs(int keyframeIntervalSeconds) const {
+    std::ostringstream args;
+    args.imbue(std::locale::classic());
+    args << " -crf " << crf;
+    if (maxrateKbps > 0) args << " -maxrate " << maxrateKbps << "k -bufsize " << bufsizeKbps << "k";
+
+    std::string x264;
+    auto add = [&x264](const std::string& kv) { x264 += (x264.empty() ? "" : ":") + kv; };
+    if (keyint > 0) add("keyint=" + std::to_string(keyint));
+    if (minKeyint > 0) add("min-keyint=" + std::to_string(minKeyint));
+    if (scenecut >= 0) add("scenecut=" + std::to_string(scenecut));
+    if (!x264.empty()) args << " -x264-params " << x264;
+    return args.str() + KeyframeArgs(keyframeIntervalSeconds);
+}
+
+std::string RateController::Params::KeyframeArgs(int keyframeIntervalSeconds) const {
+    std::ostringstream args;
+    args.imbue(std::locale::classic());
+    if (!keyframeTimes.empty()) {
+        args << " -force_key_frames ";
+        args.setf(std::ios::fixed);
+        args.precision(3);
+        for (size_t i = 0; i < keyframeTimes.size(); ++i) args << (i ? "," : "") << keyframeTimes[i];
+    } else if (keyframeIntervalSeconds > 0) {
+        // Keyframes on the seek index grid; the encoder's own GOP decisions stay in between
+        args << " -force_key_frames \"expr:gte(t,n_forced*" << keyframeIntervalSeconds << ")\"";
+    }
+    return args.str();
+}
+
+RateController::Params RateController::Fixed() {
+    return Params();
+}
+
+RateController::Params RateController::Live(int width, int height, int fps) {
+    Params p;
+    double capKbps = kCapBitsPerPixel * width * height * fps / 1000.0;
+    p.maxrateKbps = (int)capKbps;
+    p.bufsizeKbps = (int)(capKbps * kBufferSeconds);
+    p.keyint = kMaxGopSeconds * fps;
+    p.minKeyint = fps;
+    p.scenecut = 40; // x264's default threshold; the ultrafast preset turns it off
+    return p;
+}
+
+RateController::Params RateController::Offline(int width, int height, int fps, const std::vector<float>& changed,
+                                               int keyframeIntervalSeconds, Stats* stats) {
+    Params p = Live(width, height, fps);
+    p.scenecut = 0; // Decided here with real lookahead instead
+
+    std::vector<uint64_t> scenes = SceneChanges(changed, fps);
+    if (stats) {
+        *stats = Stats();
+        stats->frames = changed.size();
+        for (float c : changed) {
+            if (c <= 0.0f) stats->staticFrames++;
+            else if (c > kBurstFraction) stats->burstFrames++;
+        }
+        stats->sceneChanges = scenes.size();
+    }
+
+    // The seek index grid stays intact (its entries must be keyframes); scene changes within
+    // a second of a grid keyframe are left to it
+    std::vector<double> times;
+    double duration = (double)changed.size() / fps;
+    if (keyframeIntervalSeconds > 0) {
+        for (double t = 0.0; t < duration; t += keyframeIntervalSeconds) times.push_back(t);
+    }
+    size_t grid = times.size();
+    for (uint64_t f : scenes) {
+        double t = (double)f / fps;
+        double k = keyframeIntervalSeconds > 0 ? std::round(t / keyframeIntervalSeconds) * keyframeIntervalSeconds : -1e9;
+        if (std::fabs(t - k) >= 1.0) times.push_back(t);
+    }
+    std::inplace_merge(times.begin(), times.begin() + grid, times.end());
+    if (times.size() <= kMaxForcedKeyframes) p.keyframeTimes = times;
+    else p.scenecut = 40; // Too many for one command line: let x264 find them
+    return p;
+}
+
+std::vector<uint64_t> RateController::SceneChanges(const std::vector<float>& changed, int fps) {
+    std::vector<uint64_t> scenes;
+    size_t settle = (size_t)(fps > 1 ? fps / 2 : 1);
+    uint64_t last = 0;
+    for (size_t i = 1; i + settle < changed.size(); ++i) {
+        if (changed[i] < kSceneChangeFraction) continue;
+        if (!scenes.empty() && i - last < (uint64_t)fps) continue;
+
+        double after = 0.0;
+        for (size_t j = i + 1; j <= i + settle; ++j) after += changed[j];
+        if (after / settle > kSettledFraction) continue; // Still moving: scrolling, video
+
+        scenes.push_back(i);
+        last = i;
+    }
+    return scenes;
+}
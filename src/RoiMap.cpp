@@ -0,0 +1,145 @@
+#include "RoiMap.hpp"
+#include "CpuDispatch.hpp"
+#include <chrono>
+#include <cstring>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+void RoiMap::Smooth2x2_Scalar(uint8_t* row0, uint8_t* row1, int pixels) {
+    // Rounding matches _mm_avg_epu8: vertical pairs first, then the two columns
+    for (int x = 0; x + 1 < pixels; x += 2) {
+        uint8_t* a = row0 + x * 4;
+        uint8_t* b = row1 + x * 4;
+        for (int c = 0; c < 4; ++c) {
+            int left = (a[c] + b[c] + 1) >> 1;
+            int right = (a[4 + c] + b[4 + c] + 1) >> 1;
+            uint8_t v = (uint8_t)((left + right + 1) >> 1);
+            a[c] = a[4 + c] = b[c] = b[4 + c] = v;
+        }
+    }
+}
+
+void RoiMap::Smooth2x2(uint8_t* row0, uint8_t* row1, int pixels) {
+    CpuDispatch::Get().smooth2x2(row0, row1, pixels);
+}
+
+#ifdef SSR_X86_SSE2
+void RoiMap::Smooth2x2_SSE2(uint8_t* row0, uint8_t* row1, int pixels) {
+    int x = 0;
+    for (; x + 4 <= pixels; x += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 4));
+        __m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 4));
+        __m128i v = _mm_avg_epu8(a, b);
+        // Swap neighbouring pixels so each lane meets its pair
+        __m128i h = _mm_avg_epu8(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm_storeu_si128((__m128i*)(row0 + x * 4), h);
+        _mm_storeu_si128((__m128i*)(row1 + x * 4), h);
+    }
+    if (x < pixels) Smooth2x2_Scalar(row0 + x * 4, row1 + x * 4, pixels - x);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+// The pair swap stays within 128-bit lanes, so the SSE2 shuffle carries over unchanged
+SSR_TARGET_AVX2
+void RoiMap::Smooth2x2_AVX2(uint8_t* row0, uint8_t* row1, int pixels) {
+    int x = 0;
+    for (; x + 8 <= pixels; x += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + x * 4));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + x * 4));
+        __m256i v = _mm256_avg_epu8(a, b);
+        __m256i h = _mm256_avg_epu8(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm256_storeu_si256((__m256i*)(row0 + x * 4), h);
+        _mm256_storeu_si256((__m256i*)(row1 + x * 4), h);
+    }
+    _mm256_zeroupper();
+    if (x < pixels) Smooth2x2_SSE2(row0 + x * 4, row1 + x * 4, pixels - x);
+}
+#endif
+
+void RoiMap::Update(int width, int height, const std::vector<FrameRect>* damage, POINT cursor, const FrameRect& highlight) {
+    auto start = std::chrono::steady_clock::now();
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_blocksX = (width + kBlockSize - 1) / kBlockSize;
+        m_blocksY = (height + kBlockSize - 1) / kBlockSize;
+        m_runs.assign((size_t)m_blocksX * m_blocksY, 0);
+        m_levels.assign(m_runs.size(), Normal);
+    }
+    m_damaged.assign(m_runs.size(), 0);
+
+    FrameRect bounds = { 0, 0, width, height };
+    if (damage) {
+        for (const FrameRect& d : *damage) {
+            FrameRect r = d.Intersect(bounds);
+            if (r.Empty()) continue;
+            int bx1 = (r.x + r.width - 1) / kBlockSize, by1 = (r.y + r.height - 1) / kBlockSize;
+            for (int by = r.y / kBlockSize; by <= by1; ++by) {
+                memset(&m_damaged[(size_t)by * m_blocksX + r.x / kBlockSize], 1, bx1 - r.x / kBlockSize + 1);
+            }
+        }
+    }
+
+    // Cursor neighbourhood and click highlight, in blocks
+    FrameRect focus = FrameRect{ (int)cursor.x - kFocusRadius, (int)cursor.y - kFocusRadius, 2 * kFocusRadius, 2 * kFocusRadius }
+        .Union(highlight).Intersect(bounds);
+    int fx0 = focus.x / kBlockSize, fy0 = focus.y / kBlockSize;
+    int fx1 = focus.Empty() ? -1 : (focus.x + focus.width - 1) / kBlockSize;
+    int fy1 = focus.Empty() ? -1 : (focus.y + focus.height - 1) / kBlockSize;
+
+    for (int by = 0; by < m_blocksY; ++by) {
+        bool focusRow = by >= fy0 && by <= fy1;
+        for (int bx = 0; bx < m_blocksX; ++bx) {
+            size_t i = (size_t)by * m_blocksX + bx;
+            uint8_t& run = m_runs[i];
+            if (!damage) run = 0;
+            else if (!m_damaged[i]) run = 0;
+            else if (run < 255) run++;
+
+            int8_t level = Normal;
+            if ((focusRow && bx >= fx0 && bx <= fx1) || (run > 0 && run < kMotionFrames)) level = Focus;
+            else if (run >= kMotionFrames) level = Coarse;
+            m_levels[i] = level;
+            if (level == Focus) m_stats.focusBlocks++;
+            else if (level == Coarse) m_stats.coarseBlocks++;
+        }
+    }
+    m_stats.frames++;
+    m_stats.blocks += m_runs.size();
+    m_stats.workUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RoiMap::Apply(const Frame& frame, std::vector<FrameRect>& touched) {
+    if (frame.Empty() || frame.width != m_width || frame.height != m_height) return;
+    auto start = std::chrono::steady_clock::now();
+
+    FrameRect bounds = frame.Bounds();
+    for (int by = 0; by < m_blocksY; ++by) {
+        int bx = 0;
+        while (bx < m_blocksX) {
+            if (m_levels[(size_t)by * m_blocksX + bx] != Coarse) { ++bx; continue; }
+            int first = bx;
+            while (bx < m_blocksX && m_levels[(size_t)by * m_blocksX + bx] == Coarse) ++bx;
+
+            // One run of Coarse blocks; a trailing odd row or column is left as is
+            FrameRect r = FrameRect{ first * kBlockSize, by * kBlockSize, (bx - first) * kBlockSize, kBlockSize }.Intersect(bounds);
+            for (int y = 0; y + 1 < r.height; y += 2) {
+                Smooth2x2(frame.Pixel(r.x, r.y + y), frame.Pixel(r.x, r.y + y + 1), r.width & ~1);
+            }
+            touched.push_back(r);
+        }
+    }
+    m_stats.workUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RoiMap::Reset() {
+    m_width = m_height = 0;
+    m_blocksX = m_blocksY = 0;
+    m_runs.clear();
+    m_damaged.clear();
+    m_levels.clear();
+    m_stats = Stats();
+}
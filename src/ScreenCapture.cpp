@@ -1,5 +1,6 @@
 #include "ScreenCapture.hpp"
 #include <iostream>
+#include <chrono>
 
 ScreenCapture::ScreenCapture() : m_initialized(false) {}
 
@@ -66,15 +67,46 @@ bool ScreenCapture::SetupDuplication() {
     return true;
 }
 
-bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& outBuffer, int& width, int& height) {
+// Capture rect clamped to the output and aligned to 2 for encoding safety; empty rect = full screen
+static FrameRect ResolveRegion(const RECT& captureRect, int screenW, int screenH) {
+    FrameRect r = { 0, 0, screenW, screenH };
+    if (captureRect.right > 0 && captureRect.bottom > 0) {
+        r = FrameRect{ captureRect.left, captureRect.top,
+                       captureRect.right - captureRect.left, captureRect.bottom - captureRect.top }
+            .Intersect(FrameRect{ 0, 0, screenW, screenH });
+    }
+    r.width &= ~1;
+    r.height &= ~1;
+    return r;
+}
+
+bool ScreenCapture::AcquireFrame(Frame& out) {
     if (!m_initialized) return false;
 
     IDXGIResource* desktopResource = nullptr;
     DXGI_OUTDUPL_FRAME_INFO frameInfo;
+
+    const RECT& desktop = m_outputDesc.DesktopCoordinates;
+    FrameRect wanted = ResolveRegion(m_captureRect, desktop.right - desktop.left, desktop.bottom - desktop.top);
+    bool haveWanted = !m_frame.Empty() && wanted.x == m_region.x && wanted.y == m_region.y &&
+                      wanted.width == m_region.width && wanted.height == m_region.height;
     
-    // Acquiring the next frame
-    HRESULT hr = m_deskDupl->AcquireNextFrame(100, &frameInfo, &desktopResource);
-    if (FAILED(hr)) return false;
+    // Non-blocking: the engine paces itself, a timeout just means nothing changed
+    HRESULT hr = m_deskDupl->AcquireNextFrame(0, &frameInfo, &desktopResource);
+    bool fresh = false;
+    if (FAILED(hr) && (hr == DXGI_ERROR_ACCESS_LOST || !haveWanted)) {
+        // A new duplication always starts with the whole current desktop, which is the only
+        // way to get pixels for a new region (or after a mode switch) while the screen is static
+        m_deskDupl.Reset();
+        if (!SetupDuplication()) return false;
+        hr = m_deskDupl->AcquireNextFrame(500, &frameInfo, &desktopResource);
+        fresh = SUCCEEDED(hr);
+    }
+    if (FAILED(hr)) {
+        if (!haveWanted) return false;
+        out = m_frame;
+        return true;
+    }
 
     ComPtr<ID3D11Texture2D> desktopTexture;
     desktopResource->QueryInterface(__uuidof(ID3D11Texture2D), &desktopTexture);
@@ -82,83 +114,123 @@ bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& outBuffer, int& width, in
 
     D3D11_TEXTURE2D_DESC desc;
     desktopTexture->GetDesc(&desc);
-    
-    width = desc.Width;
-    height = desc.Height;
-
-    // Reuse or recreate staging texture only if size changes
-    if (!m_stagingTexture || m_stagingDesc.Width != desc.Width || m_stagingDesc.Height != desc.Height) {
-        m_stagingDesc = desc;
-        m_stagingDesc.Usage = D3D11_USAGE_STAGING;
-        m_stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-        m_stagingDesc.BindFlags = 0;
-        m_stagingDesc.MiscFlags = 0;
-        m_d3dDevice->CreateTexture2D(&m_stagingDesc, nullptr, &m_stagingTexture);
+
+    FrameRect region = ResolveRegion(m_captureRect, (int)desc.Width, (int)desc.Height);
+    if (region.Empty()) {
+        m_deskDupl->ReleaseFrame();
+        return false;
+    }
+
+    // Staging only holds the capture region; recreate when the region size changes
+    bool geometryChanged = fresh || !m_stagingTexture || region.x != m_region.x || region.y != m_region.y ||
+                           region.width != m_region.width || region.height != m_region.height;
+    if (geometryChanged) {
+        if (m_isMapped) {
+            m_d3dContext->Unmap(m_stagingTexture.Get(), 0);
+            m_isMapped = false;
+        }
+        m_frame = Frame();
+        if (!m_stagingTexture || (int)m_stagingDesc.Width != region.width || (int)m_stagingDesc.Height != region.height) {
+            m_stagingDesc = desc;
+            m_stagingDesc.Width = region.width;
+            m_stagingDesc.Height = region.height;
+            m_stagingDesc.Usage = D3D11_USAGE_STAGING;
+            m_stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            m_stagingDesc.BindFlags = 0;
+            m_stagingDesc.MiscFlags = 0;
+            m_stagingTexture.Reset();
+            m_d3dDevice->CreateTexture2D(&m_stagingDesc, nullptr, &m_stagingTexture);
+        }
+        m_region = region;
     }
 
-    m_d3dContext->CopyResource(m_stagingTexture.Get(), desktopTexture.Get());
+    // LastPresentTime == 0 means only the pointer moved; the desktop image is unchanged
+    bool imageUpdated = geometryChanged || frameInfo.LastPresentTime.QuadPart != 0;
+
+    // Damage from the OS: move destinations + dirty rects, clipped to the region.
+    // Unknown damage (no metadata) means a full copy.
+    bool fullCopy = geometryChanged;
+    m_damage.clear();
+    if (imageUpdated && !fullCopy) {
+        fullCopy = true;
+        if (frameInfo.TotalMetadataBufferSize > 0) {
+            m_metadata.resize(frameInfo.TotalMetadataBufferSize);
+            UINT moveBytes = 0;
+            UINT dirtyBytes = 0;
+            HRESULT hrMove = m_deskDupl->GetFrameMoveRects(frameInfo.TotalMetadataBufferSize,
+                                                           (DXGI_OUTDUPL_MOVE_RECT*)m_metadata.data(), &moveBytes);
+            HRESULT hrDirty = SUCCEEDED(hrMove) ? m_deskDupl->GetFrameDirtyRects(frameInfo.TotalMetadataBufferSize - moveBytes,
+                                                           (RECT*)(m_metadata.data() + moveBytes), &dirtyBytes) : hrMove;
+            if (SUCCEEDED(hrDirty)) {
+                auto addDamage = [&](const RECT& rc) {
+                    FrameRect r = FrameRect{ rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top }.Intersect(region);
+                    if (!r.Empty()) m_damage.push_back({ r.x - region.x, r.y - region.y, r.width, r.height });
+                };
+                const DXGI_OUTDUPL_MOVE_RECT* moves = (const DXGI_OUTDUPL_MOVE_RECT*)m_metadata.data();
+                for (UINT i = 0; i < moveBytes / sizeof(DXGI_OUTDUPL_MOVE_RECT); ++i) addDamage(moves[i].DestinationRect);
+                const RECT* dirty = (const RECT*)(m_metadata.data() + moveBytes);
+                for (UINT i = 0; i < dirtyBytes / sizeof(RECT); ++i) addDamage(dirty[i]);
+
+                // Many small rects cost more in copy calls than one full copy
+                fullCopy = m_damage.size() > 64;
+                if (m_damage.empty()) imageUpdated = false; // All changes were outside the region
+            }
+        }
+    }
 
-    D3D11_MAPPED_SUBRESOURCE mapped;
-    hr = m_d3dContext->Map(m_stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mapped);
-    
-    if (SUCCEEDED(hr)) {
-        // Copy the BGRA data to our buffer, respecting the capture region
-        
-        // Default to full screen if rect is empty
-        int capX = 0;
-        int capY = 0;
-        int capW = desc.Width;
-        int capH = desc.Height;
-
-        if (m_captureRect.right > 0 && m_captureRect.bottom > 0) {
-            capX = m_captureRect.left;
-            capY = m_captureRect.top;
-            capW = m_captureRect.right - m_captureRect.left;
-            capH = m_captureRect.bottom - m_captureRect.top;
-
-            // Clamp to screen bounds
-            if (capX < 0) capX = 0;
-            if (capY < 0) capY = 0;
-            if (capX + capW > (int)desc.Width) capW = (int)desc.Width - capX;
-            if (capY + capH > (int)desc.Height) capH = (int)desc.Height - capY;
+    if (imageUpdated && m_stagingTexture) {
+        if (m_isMapped) {
+            m_d3dContext->Unmap(m_stagingTexture.Get(), 0);
+            m_isMapped = false;
         }
 
-        // Update output dimensions
-        width = capW;
-        height = capH;
-        
-        // Align to 2 for encoding safety
-        if (width % 2 != 0) width--;
-        if (height % 2 != 0) height--;
-
-        size_t pixelSize = 4;
-        size_t rowPitch = mapped.RowPitch;
-        size_t outRowPitch = width * pixelSize;
-        size_t size = outRowPitch * height;
-        
-        outBuffer.resize(size);
-
-        uint8_t* srcPtr = (uint8_t*)mapped.pData + (capY * rowPitch) + (capX * pixelSize);
-        uint8_t* dstPtr = outBuffer.data();
-
-        for (int h = 0; h < height; ++h) {
-            memcpy(dstPtr, srcPtr, outRowPitch);
-            srcPtr += rowPitch;
-            dstPtr += outRowPitch;
+        // The staging texture keeps the previous image, so only changed areas are read back
+        if (fullCopy) {
+            D3D11_BOX box = { (UINT)region.x, (UINT)region.y, 0, (UINT)(region.x + region.width), (UINT)(region.y + region.height), 1 };
+            m_d3dContext->CopySubresourceRegion(m_stagingTexture.Get(), 0, 0, 0, 0, desktopTexture.Get(), 0, &box);
+        } else {
+            for (const FrameRect& r : m_damage) {
+                D3D11_BOX box = { (UINT)(region.x + r.x), (UINT)(region.y + r.y), 0,
+                                  (UINT)(region.x + r.x + r.width), (UINT)(region.y + r.y + r.height), 1 };
+                m_d3dContext->CopySubresourceRegion(m_stagingTexture.Get(), 0, r.x, r.y, 0, desktopTexture.Get(), 0, &box);
+            }
+        }
+
+        hr = m_d3dContext->Map(m_stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &m_mapped);
+        if (SUCCEEDED(hr)) {
+            m_isMapped = true;
+            m_frame.data = (uint8_t*)m_mapped.pData;
+            m_frame.stride = (int)m_mapped.RowPitch;
+            m_frame.width = region.width;
+            m_frame.height = region.height;
+            m_frame.format = PixelConvert::Format::BGRA;
+            m_frame.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            m_frame.sequence = ++m_sequence;
+            m_frame.damage = fullCopy ? nullptr : &m_damage;
+
+            // Store current origin for mouse coordinate mapping
+            m_lastOrigin.x = m_outputDesc.DesktopCoordinates.left + region.x;
+            m_lastOrigin.y = m_outputDesc.DesktopCoordinates.top + region.y;
+        } else {
+            m_frame = Frame();
         }
-        
-        m_d3dContext->Unmap(m_stagingTexture.Get(), 0);
-        
-        // Store current origin for mouse coordinate mapping
-        m_lastOrigin.x = m_outputDesc.DesktopCoordinates.left + capX;
-        m_lastOrigin.y = m_outputDesc.DesktopCoordinates.top + capY;
     }
 
     m_deskDupl->ReleaseFrame();
-    return SUCCEEDED(hr);
+
+    if (m_frame.Empty()) return false;
+    out = m_frame;
+    return true;
 }
 
 void ScreenCapture::Cleanup() {
+    if (m_isMapped) {
+        m_d3dContext->Unmap(m_stagingTexture.Get(), 0);
+        m_isMapped = false;
+    }
+    m_frame = Frame();
+    m_stagingTexture.Reset();
     m_deskDupl.Reset();
     m_d3dContext.Reset();
     m_d3dDevice.Reset();
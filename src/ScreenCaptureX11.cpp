@@ -0,0 +1,268 @@
+#include "ScreenCapture.hpp"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+
+struct ScreenCapture::X11State {
+    Display* display = nullptr;
+    Window root = 0;
+    int screenW = 0;
+    int screenH = 0;
+
+    // MIT-SHM image sized to the current capture region
+    bool hasShm = false;
+    XShmSegmentInfo shmInfo = {};
+    XImage* image = nullptr;
+
+    // XDamage tracks which parts of the root window changed since the last grab
+    bool hasDamage = false;
+    int damageEventBase = 0;
+    Damage damage = 0;
+    XserverRegion damageParts = 0;
+    bool forceGrab = true;
+
+    bool EnsureImage(int width, int height);
+    void ReleaseImage();
+};
+
+static int IgnoreXErrors(Display*, XErrorEvent*) { return 0; }
+
+// (Re)creates the shared image when the capture size changes
+bool ScreenCapture::X11State::EnsureImage(int width, int height) {
+    if (image && image->width == width && image->height == height) return true;
+
+    ReleaseImage();
+    if (!hasShm) return true; // XGetImage allocates per call
+
+    Visual* visual = DefaultVisual(display, DefaultScreen(display));
+    int depth = DefaultDepth(display, DefaultScreen(display));
+    image = XShmCreateImage(display, visual, depth, ZPixmap, nullptr, &shmInfo, width, height);
+    if (!image) return false;
+
+    shmInfo.shmid = shmget(IPC_PRIVATE, (size_t)image->bytes_per_line * height, IPC_CREAT | 0600);
+    if (shmInfo.shmid < 0) {
+        XDestroyImage(image);
+        image = nullptr;
+        return false;
+    }
+
+    void* addr = shmat(shmInfo.shmid, nullptr, 0);
+    if (addr == (void*)-1) {
+        shmctl(shmInfo.shmid, IPC_RMID, nullptr);
+        XDestroyImage(image);
+        image = nullptr;
+        hasShm = false;
+        std::cerr << "shmat failed, using XGetImage" << std::endl;
+        return true;
+    }
+    shmInfo.shmaddr = image->data = (char*)addr;
+    shmInfo.readOnly = False;
+
+    // Attach can fail asynchronously (e.g. X server in another IPC namespace)
+    XErrorHandler previous = XSetErrorHandler(IgnoreXErrors);
+    Bool attached = XShmAttach(display, &shmInfo);
+    XSync(display, False);
+    XSetErrorHandler(previous);
+
+    // Mark for removal now; the segment lives until both sides detach
+    shmctl(shmInfo.shmid, IPC_RMID, nullptr);
+
+    if (!attached) {
+        XDestroyImage(image);
+        shmdt(shmInfo.shmaddr);
+        image = nullptr;
+        hasShm = false;
+        std::cerr << "XShmAttach failed, using XGetImage" << std::endl;
+    }
+
+    forceGrab = true;
+    return true;
+}
+
+void ScreenCapture::X11State::ReleaseImage() {
+    if (!image) return;
+    if (hasShm) {
+        XShmDetach(display, &shmInfo);
+        XDestroyImage(image);
+        shmdt(shmInfo.shmaddr);
+    } else {
+        XDestroyImage(image);
+    }
+    image = nullptr;
+}
+
+ScreenCapture::ScreenCapture() : m_initialized(false), m_x11(std::make_unique<X11State>()) {}
+
+ScreenCapture::~ScreenCapture() {
+    Cleanup();
+}
+
+bool ScreenCapture::Initialize() {
+    if (!SetupDevice()) return false;
+    if (!SetupDuplication()) return false;
+
+    m_initialized = true;
+    return true;
+}
+
+bool ScreenCapture::SetupDevice() {
+    X11State& x = *m_x11;
+    x.display = XOpenDisplay(nullptr);
+    if (!x.display) {
+        std::cerr << "Failed to open X display" << std::endl;
+        return false;
+    }
+
+    x.root = DefaultRootWindow(x.display);
+    x.screenW = DisplayWidth(x.display, DefaultScreen(x.display));
+    x.screenH = DisplayHeight(x.display, DefaultScreen(x.display));
+
+    // MIT-SHM is unavailable on remote displays; fall back to XGetImage
+    x.hasShm = XShmQueryExtension(x.display) == True;
+    if (!x.hasShm) {
+        std::cerr << "MIT-SHM not available, using XGetImage" << std::endl;
+    }
+    return true;
+}
+
+bool ScreenCapture::SetupDuplication() {
+    X11State& x = *m_x11;
+
+    // Damage is read back through an XFixes region, so both extensions are needed (regions: XFixes 2.0)
+    int damageError = 0, fixesEvent = 0, fixesError = 0, fixesMajor = 0, fixesMinor = 0;
+    bool hasFixes = XFixesQueryExtension(x.display, &fixesEvent, &fixesError) &&
+                    XFixesQueryVersion(x.display, &fixesMajor, &fixesMinor) && fixesMajor >= 2;
+    if (hasFixes && XDamageQueryExtension(x.display, &x.damageEventBase, &damageError)) {
+        x.damage = XDamageCreate(x.display, x.root, XDamageReportNonEmpty);
+        x.damageParts = XFixesCreateRegion(x.display, nullptr, 0);
+        x.hasDamage = true;
+    } else {
+        std::cerr << "XDamage/XFixes not available, grabbing every frame" << std::endl;
+    }
+
+    x.forceGrab = true;
+    return true;
+}
+
+// Capture rect clamped to the screen and aligned to 2 for encoding safety; empty rect = full screen
+static FrameRect ResolveRegion(const RECT& captureRect, int screenW, int screenH) {
+    FrameRect r = { 0, 0, screenW, screenH };
+    if (captureRect.right > 0 && captureRect.bottom > 0) {
+        r = FrameRect{ (int)captureRect.left, (int)captureRect.top,
+                       (int)(captureRect.right - captureRect.left), (int)(captureRect.bottom - captureRect.top) }
+            .Intersect(FrameRect{ 0, 0, screenW, screenH });
+    }
+    r.width &= ~1;
+    r.height &= ~1;
+    return r;
+}
+
+bool ScreenCapture::AcquireFrame(Frame& out) {
+    if (!m_initialized) return false;
+    X11State& x = *m_x11;
+
+    FrameRect region = ResolveRegion(m_captureRect, x.screenW, x.screenH);
+    if (region.Empty()) return false;
+
+    bool geometryChanged = region.x != m_region.x || region.y != m_region.y ||
+                           region.width != m_region.width || region.height != m_region.height;
+    if (geometryChanged) {
+        m_frame = Frame();
+        x.forceGrab = true;
+    }
+
+    if (!x.EnsureImage(region.width, region.height)) return false;
+
+    // Drain damage notifications and collect what changed inside the region
+    m_damage.clear();
+    bool fullDamage = x.forceGrab || !x.hasDamage;
+    if (x.hasDamage) {
+        while (XPending(x.display)) {
+            XEvent ev;
+            XNextEvent(x.display, &ev);
+        }
+
+        XDamageSubtract(x.display, x.damage, None, x.damageParts);
+        int count = 0;
+        XRectangle* rects = XFixesFetchRegion(x.display, x.damageParts, &count);
+        for (int i = 0; i < count; ++i) {
+            FrameRect r = FrameRect{ rects[i].x, rects[i].y, rects[i].width, rects[i].height }.Intersect(region);
+            if (!r.Empty()) m_damage.push_back({ r.x - region.x, r.y - region.y, r.width, r.height });
+        }
+        if (rects) XFree(rects);
+
+        // Same semantics as DXGI: nothing new, the previous view is still current
+        if (!fullDamage && m_damage.empty() && !m_frame.Empty()) {
+            out = m_frame;
+            return true;
+        }
+    }
+
+    if (x.hasShm) {
+        if (!XShmGetImage(x.display, x.root, x.image, region.x, region.y, AllPlanes)) return false;
+    } else {
+        // Kept until the next grab so the view stays valid
+        if (x.image) XDestroyImage(x.image);
+        x.image = XGetImage(x.display, x.root, region.x, region.y, region.width, region.height, AllPlanes, ZPixmap);
+        if (!x.image) {
+            m_frame = Frame();
+            return false;
+        }
+    }
+
+    // 24/32-bit TrueColor ZPixmap is BGRX in memory, which is what the encoder expects
+    if (x.image->bits_per_pixel != 32) {
+        std::cerr << "Unsupported X11 pixel depth: " << x.image->bits_per_pixel << std::endl;
+        m_frame = Frame();
+        return false;
+    }
+
+    m_frame.data = (uint8_t*)x.image->data;
+    m_frame.stride = x.image->bytes_per_line;
+    m_frame.width = region.width;
+    m_frame.height = region.height;
+    m_frame.format = PixelConvert::Format::BGRA;
+    m_frame.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_frame.sequence = ++m_sequence;
+    m_frame.damage = fullDamage ? nullptr : &m_damage;
+    m_region = region;
+
+    x.forceGrab = false;
+
+    // Store current origin for mouse coordinate mapping
+    m_lastOrigin.x = region.x;
+    m_lastOrigin.y = region.y;
+
+    out = m_frame;
+    return true;
+}
+
+void ScreenCapture::Cleanup() {
+    if (!m_x11 || !m_x11->display) return;
+    X11State& x = *m_x11;
+
+    m_frame = Frame();
+    x.ReleaseImage();
+
+    if (x.hasDamage) {
+        XFixesDestroyRegion(x.display, x.damageParts);
+        XDamageDestroy(x.display, x.damage);
+        x.hasDamage = false;
+    }
+
+    XCloseDisplay(x.display);
+    x.display = nullptr;
+    m_initialized = false;
+}
+
+POINT ScreenCapture::GetCaptureOrigin() const {
+    return m_lastOrigin;
+}
@@ -0,0 +1,410 @@
+#include "ScreenCodec.hpp"
+#include "CpuDispatch.hpp"
+#include <chrono>
+#include <cstring>
+
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
+
+// QOI op tags (pixels are BGRA in memory: b | g << 8 | r << 16 | a << 24)
+static constexpr uint8_t kOpIndex = 0x00; // 00xxxxxx
+static constexpr uint8_t kOpDiff = 0x40;  // 01rrggbb, each -2..1
+static constexpr uint8_t kOpLuma = 0x80;  // 10gggggg, then rrrrbbbb relative to g
+static constexpr uint8_t kOpRun = 0xC0;   // 11xxxxxx, run of 1..62
+static constexpr uint8_t kOpRgb = 0xFE;
+static constexpr uint8_t kOpRgba = 0xFF;
+static constexpr int kMaxRun = 62;
+
+// Slices below this many pixels aren't worth a thread hand-off
+static constexpr uint64_t kMinSlicePixels = 128 * 1024;
+static constexpr int kMaxSlices = 8;
+
+static inline int Hash(uint32_t px) {
+    uint32_t b = px & 0xFF, g = (px >> 8) & 0xFF, r = (px >> 16) & 0xFF, a = px >> 24;
+    return (int)((r * 3 + g * 5 + b * 7 + a * 11) % 64);
+}
+
+// Coder state carried across the spans (rect rows) of one slice
+struct QoiState {
+    uint32_t prev = 0xFF000000u;
+    uint32_t index[64] = {};
+    int run = 0;
+    int (*runLength)(const uint32_t*, int, uint32_t) = CpuDispatch::Get().runLength; // Looked up once per slice
+};
+
+int ScreenCodec::RunLength_Scalar(const uint32_t* px, int count, uint32_t value) {
+    int n = 0;
+    while (n < count && px[n] == value) ++n;
+    return n;
+}
+
+int ScreenCodec::RunLength(const uint32_t* px, int count, uint32_t value) {
+    return CpuDispatch::Get().runLength(px, count, value);
+}
+
+#ifdef SSR_X86_SSE2
+int ScreenCodec::RunLength_SSE2(const uint32_t* px, int count, uint32_t value) {
+    int n = 0;
+    const __m128i v = _mm_set1_epi32((int)value);
+    for (; n + 4 <= count; n += 4) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(px + n)), v));
+        if (mask != 0xFFFF) {
+            // First differing pixel within the group
+            while (mask & 0xF) {
+                mask >>= 4;
+                ++n;
+            }
+            return n;
+        }
+    }
+    return n + RunLength_Scalar(px + n, count - n, value);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+SSR_TARGET_AVX2
+int ScreenCodec::RunLength_AVX2(const uint32_t* px, int count, uint32_t value) {
+    int n = 0;
+    const __m256i v = _mm256_set1_epi32((int)value);
+    for (; n + 8 <= count; n += 8) {
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(px + n)), v));
+        if (mask != 0xFFFFFFFFu) {
+            _mm256_zeroupper();
+            while (mask & 0xF) {
+                mask >>= 4;
+                ++n;
+            }
+            return n;
+        }
+    }
+    _mm256_zeroupper();
+    return n + RunLength_SSE2(px + n, count - n, value);
+}
+#endif
+
+// Worst case per pixel is one RGBA op; runs flush at most one byte per 62 pixels
+static constexpr size_t kMaxBytesPerPixel = 5;
+
+static inline uint8_t* FlushRun(QoiState& s, uint8_t* out) {
+    while (s.run > 0) {
+        int n = s.run < kMaxRun ? s.run : kMaxRun;
+        *out++ = (uint8_t)(kOpRun | (n - 1));
+        s.run -= n;
+    }
+    return out;
+}
+
+// Writes at most count * kMaxBytesPerPixel + (pending run) / kMaxRun + 1 bytes
+static uint8_t* EncodeSpan(QoiState& s, const uint32_t* px, int count, uint8_t* out) {
+    int i = 0;
+    while (i < count) {
+        uint32_t p = px[i];
+        if (p == s.prev) {
+            int n = s.runLength(px + i, count - i, p);
+            s.run += n;
+            i += n;
+            continue;
+        }
+        out = FlushRun(s, out);
+
+        int h = Hash(p);
+        if (s.index[h] == p) {
+            *out++ = (uint8_t)(kOpIndex | h);
+        } else {
+            s.index[h] = p;
+            if ((p >> 24) == (s.prev >> 24)) {
+                int8_t vr = (int8_t)(((p >> 16) & 0xFF) - ((s.prev >> 16) & 0xFF));
+                int8_t vg = (int8_t)(((p >> 8) & 0xFF) - ((s.prev >> 8) & 0xFF));
+                int8_t vb = (int8_t)((p & 0xFF) - (s.prev & 0xFF));
+                int8_t vgr = (int8_t)(vr - vg);
+                int8_t vgb = (int8_t)(vb - vg);
+                if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1) {
+                    *out++ = (uint8_t)(kOpDiff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                } else if (vgr >= -8 && vgr <= 7 && vg >= -32 && vg <= 31 && vgb >= -8 && vgb <= 7) {
+                    *out++ = (uint8_t)(kOpLuma | (vg + 32));
+                    *out++ = (uint8_t)((vgr + 8) << 4 | (vgb + 8));
+                } else {
+                    *out++ = kOpRgb;
+                    *out++ = (uint8_t)(p >> 16);
+                    *out++ = (uint8_t)(p >> 8);
+                    *out++ = (uint8_t)p;
+                }
+            } else {
+                *out++ = kOpRgba;
+                *out++ = (uint8_t)(p >> 16);
+                *out++ = (uint8_t)(p >> 8);
+                *out++ = (uint8_t)p;
+                *out++ = (uint8_t)(p >> 24);
+            }
+        }
+        s.prev = p;
+        ++i;
+    }
+    return out;
+}
+
+// Advances `pos`; false on a malformed stream
+static bool DecodeSpan(QoiState& s, const uint8_t* in, size_t size, size_t& pos, uint32_t* px, int count) {
+    int i = 0;
+    while (i < count) {
+        if (s.run > 0) {
+            int n = s.run < count - i ? s.run : count - i;
+            for (int k = 0; k < n; ++k) px[i + k] = s.prev;
+            s.run -= n;
+            i += n;
+            continue;
+        }
+        if (pos >= size) return false;
+        uint8_t op = in[pos++];
+        uint32_t p = s.prev;
+        if (op == kOpRgb) {
+            if (pos + 3 > size) return false;
+            p = (p & 0xFF000000u) | (uint32_t)in[pos] << 16 | (uint32_t)in[pos + 1] << 8 | in[pos + 2];
+            pos += 3;
+        } else if (op == kOpRgba) {
+            if (pos + 4 > size) return false;
+            p = (uint32_t)in[pos + 3] << 24 | (uint32_t)in[pos] << 16 | (uint32_t)in[pos + 1] << 8 | in[pos + 2];
+            pos += 4;
+        } else if ((op & 0xC0) == kOpIndex) {
+            p = s.index[op & 0x3F];
+        } else if ((op & 0xC0) == kOpDiff) {
+            uint32_t r = ((p >> 16) + ((op >> 4) & 3) - 2) & 0xFF;
+            uint32_t g = ((p >> 8) + ((op >> 2) & 3) - 2) & 0xFF;
+            uint32_t b = (p + (op & 3) - 2) & 0xFF;
+            p = (p & 0xFF000000u) | r << 16 | g << 8 | b;
+        } else if ((op & 0xC0) == kOpLuma) {
+            if (pos >= size) return false;
+            uint8_t rb = in[pos++];
+            int vg = (op & 0x3F) - 32;
+            uint32_t r = ((p >> 16) + vg + (rb >> 4) - 8) & 0xFF;
+            uint32_t g = ((p >> 8) + vg) & 0xFF;
+            uint32_t b = (p + vg + (rb & 0x0F) - 8) & 0xFF;
+            p = (p & 0xFF000000u) | r << 16 | g << 8 | b;
+        } else { // Run
+            s.run = (op & 0x3F) + 1;
+            continue;
+        }
+        s.index[Hash(p)] = p;
+        s.prev = p;
+        px[i++] = p;
+    }
+    return true;
+}
+
+// --- Encoder ---
+
+ScreenCodec::~ScreenCodec() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_workers) t.join();
+}
+
+void ScreenCodec::EncodeSlice(int slice) {
+    SliceEntry& e = m_slices[slice];
+    std::vector<uint8_t>& out = m_sliceOut[slice];
+
+    // Worst-case size up front so the coder writes through a plain pointer
+    // (the buffer is kept across frames, so this only allocates while it grows)
+    uint64_t pixels = 0;
+    for (uint32_t i = e.firstRect; i < e.firstRect + e.rectCount; ++i) pixels += (uint64_t)m_rects[i].width * m_rects[i].height;
+    size_t bound = (size_t)pixels * kMaxBytesPerPixel + (size_t)pixels / kMaxRun + 1;
+    if (out.size() < bound) out.resize(bound);
+
+    QoiState s;
+    uint8_t* p = out.data();
+    for (uint32_t i = e.firstRect; i < e.firstRect + e.rectCount; ++i) {
+        const FrameRect& r = m_rects[i];
+        for (int y = r.y; y < r.y + r.height; ++y) {
+            p = EncodeSpan(s, (const uint32_t*)m_frame->Pixel(r.x, y), r.width, p);
+        }
+    }
+    p = FlushRun(s, p);
+    e.bytes = (uint32_t)(p - out.data());
+    e.flags = 0;
+
+    if (e.bytes >= pixels * 4) {
+        p = out.data();
+        for (uint32_t i = e.firstRect; i < e.firstRect + e.rectCount; ++i) {
+            const FrameRect& r = m_rects[i];
+            size_t rowBytes = (size_t)r.width * 4;
+            for (int y = r.y; y < r.y + r.height; ++y, p += rowBytes) memcpy(p, m_frame->Pixel(r.x, y), rowBytes);
+        }
+        e.bytes = (uint32_t)(pixels * 4);
+        e.flags = kSliceStored;
+    }
+}
+
+void ScreenCodec::WorkerLoop(int id, uint64_t seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_quit || m_generation != seen; });
+            if (m_quit) return;
+            seen = m_generation;
+            if (id >= m_jobSlices) continue;
+        }
+        EncodeSlice(id);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0) m_done.notify_one();
+    }
+}
+
+void ScreenCodec::RunSlices(int count) {
+    if (count > 1) {
+        while ((int)m_workers.size() < count - 1) {
+            int id = (int)m_workers.size() + 1;
+            m_workers.emplace_back(&ScreenCodec::WorkerLoop, this, id, m_generation);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobSlices = count;
+            m_pending = count - 1;
+            m_generation++;
+        }
+        m_wake.notify_all();
+    }
+
+    EncodeSlice(0);
+
+    if (count > 1) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_pending == 0; });
+    }
+}
+
+bool ScreenCodec::Encode(const Frame& frame, bool key, std::vector<uint8_t>& out) {
+    out.clear();
+    if (frame.Empty() || frame.format != PixelConvert::Format::BGRA) return false;
+    auto start = std::chrono::steady_clock::now();
+
+    bool sameSize = frame.width == m_previousWidth && frame.height == m_previousHeight;
+    Frame previous = Frame::Wrap(m_previous, frame.width, frame.height);
+    m_changes.Diff(frame, sameSize ? previous : Frame());
+    m_previousWidth = frame.width;
+    m_previousHeight = frame.height;
+    if (key) {
+        // Every tile, one rect per tile row
+        m_rects.clear();
+        for (int y = 0; y < frame.height; y += ChangeMap::kTileSize) {
+            int h = frame.height - y < ChangeMap::kTileSize ? frame.height - y : ChangeMap::kTileSize;
+            m_rects.push_back({ 0, y, frame.width, h });
+        }
+    } else {
+        if (m_changes.ChangedCount() == 0) return false;
+        m_changes.ToRects(m_rects);
+    }
+
+    // Split the tile runs into slices of roughly equal pixel count
+    uint64_t pixels = 0;
+    for (const FrameRect& r : m_rects) pixels += (uint64_t)r.width * r.height;
+    int hw = (int)std::thread::hardware_concurrency();
+    int slices = (int)(pixels / kMinSlicePixels);
+    if (slices > hw) slices = hw;
+    if (slices > kMaxSlices) slices = kMaxSlices;
+    if (slices < 1) slices = 1;
+
+    m_slices.clear();
+    uint64_t target = (pixels + slices - 1) / slices;
+    uint64_t acc = 0;
+    SliceEntry current = {};
+    for (uint32_t i = 0; i < (uint32_t)m_rects.size(); ++i) {
+        current.rectCount++;
+        acc += (uint64_t)m_rects[i].width * m_rects[i].height;
+        if (acc >= target && (int)m_slices.size() < slices - 1) {
+            m_slices.push_back(current);
+            current = { i + 1, 0, 0, 0 };
+            acc = 0;
+        }
+    }
+    if (current.rectCount > 0) m_slices.push_back(current);
+
+    m_sliceOut.resize(m_slices.size());
+    m_frame = &frame;
+    RunSlices((int)m_slices.size());
+    m_frame = nullptr;
+
+    StreamHeader header = { kMagic, frame.width, frame.height, (uint32_t)m_rects.size(), (uint32_t)m_slices.size(), 0 };
+    size_t total = sizeof(header) + m_rects.size() * sizeof(FrameRect) + m_slices.size() * sizeof(SliceEntry);
+    for (const SliceEntry& e : m_slices) total += e.bytes;
+    out.resize(total);
+    uint8_t* p = out.data();
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    memcpy(p, m_rects.data(), m_rects.size() * sizeof(FrameRect));
+    p += m_rects.size() * sizeof(FrameRect);
+    memcpy(p, m_slices.data(), m_slices.size() * sizeof(SliceEntry));
+    p += m_slices.size() * sizeof(SliceEntry);
+    for (size_t i = 0; i < m_slices.size(); ++i) {
+        memcpy(p, m_sliceOut[i].data(), m_slices[i].bytes);
+        p += m_slices[i].bytes;
+    }
+
+    // The next frame is compared against this one: copy over only what changed
+    if (!sameSize || m_changes.ChangedCount() == (size_t)m_changes.TilesX() * m_changes.TilesY()) {
+        frame.CopyTo(previous);
+    } else {
+        if (key) m_changes.ToRects(m_rects);
+        for (const FrameRect& r : m_rects) frame.CopyRectTo(previous, r);
+    }
+
+    m_stats.frames++;
+    m_stats.inputBytes += pixels * 4;
+    m_stats.outputBytes += out.size();
+    m_stats.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void ScreenCodec::Reset() {
+    m_changes.Reset();
+    m_previous.clear();
+    m_previousWidth = m_previousHeight = 0;
+    m_stats = Stats();
+}
+
+// --- Decoder ---
+
+bool ScreenCodec::Decode(const uint8_t* data, size_t size, const Frame& canvas) {
+    StreamHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kMagic || header.width != canvas.width || header.height != canvas.height) return false;
+
+    size_t tables = (size_t)header.rectCount * sizeof(FrameRect) + (size_t)header.sliceCount * sizeof(SliceEntry);
+    if (size - sizeof(header) < tables) return false;
+    const FrameRect* rects = (const FrameRect*)(data + sizeof(header));
+    const SliceEntry* slices = (const SliceEntry*)(data + sizeof(header) + header.rectCount * sizeof(FrameRect));
+    const uint8_t* payload = data + sizeof(header) + tables;
+    size_t remaining = size - sizeof(header) - tables;
+
+    for (uint32_t si = 0; si < header.sliceCount; ++si) {
+        SliceEntry e;
+        memcpy(&e, &slices[si], sizeof(e));
+        if (e.bytes > remaining || e.firstRect + (uint64_t)e.rectCount > header.rectCount) return false;
+
+        QoiState s;
+        size_t pos = 0;
+        for (uint32_t i = e.firstRect; i < e.firstRect + e.rectCount; ++i) {
+            FrameRect r;
+            memcpy(&r, &rects[i], sizeof(r));
+            FrameRect clipped = r.Intersect(canvas.Bounds());
+            if (clipped.width != r.width || clipped.height != r.height) return false;
+            size_t rowBytes = (size_t)r.width * 4;
+            for (int y = r.y; y < r.y + r.height; ++y) {
+                if (e.flags & kSliceStored) {
+                    if (pos + rowBytes > e.bytes) return false;
+                    memcpy(canvas.Pixel(r.x, y), payload + pos, rowBytes);
+                    pos += rowBytes;
+                } else if (!DecodeSpan(s, payload, e.bytes, pos, (uint32_t*)canvas.Pixel(r.x, y), r.width)) {
+                    return false;
+                }
+            }
+        }
+        payload += e.bytes;
+        remaining -= e.bytes;
+    }
+    return true;
+}
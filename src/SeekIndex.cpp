@@ -0,0 +1,108 @@
+#include "SeekIndex.hpp"
+#include <chrono>
+#include <cstring>
+
+SeekIndex::~SeekIndex() {
+    Finish();
+}
+
+bool SeekIndex::Start(const std::string& path, int fps, int intervalSeconds, int sourceWidth, int sourceHeight) {
+    Finish();
+    if (fps <= 0 || intervalSeconds <= 0 || sourceWidth <= 0 || sourceHeight <= 0) return false;
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) return false;
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, kMagic, sizeof(kMagic));
+    m_header.version = kVersion;
+    m_header.fps = fps;
+    m_header.intervalFrames = (uint32_t)(fps * intervalSeconds);
+    m_header.thumbWidth = kThumbWidth;
+    m_header.thumbHeight = ThumbHeight(sourceWidth, sourceHeight);
+    std::fwrite(&m_header, sizeof(m_header), 1, m_file);
+
+    Frame::Wrap(m_thumb, m_header.thumbWidth, m_header.thumbHeight);
+    m_codec.Reset();
+    m_stats = Stats();
+    m_stats.bytes = sizeof(m_header);
+    return true;
+}
+
+void SeekIndex::AddFrame(uint64_t frameIndex, const Frame& frame) {
+    if (!WantsFrame(frameIndex) || frame.Empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    // Nearest-neighbour gather of only the thumbnail's pixels (nothing to do for a frame
+    // already at thumbnail size), then a lossless keyframe
+    Frame thumb = frame;
+    if (frame.width != m_header.thumbWidth || frame.height != m_header.thumbHeight || frame.format != PixelConvert::Format::BGRA) {
+        thumb = Frame::Wrap(m_thumb, m_header.thumbWidth, m_header.thumbHeight);
+        PixelConvert::ConvertScaled(frame.data, frame.stride, frame.width, frame.height, frame.format,
+                                    thumb.data, thumb.stride, thumb.width, thumb.height);
+    }
+    m_codec.Encode(thumb, true, m_encoded);
+
+    Entry entry = {};
+    entry.frameIndex = frameIndex;
+    entry.timeUs = (int64_t)(frameIndex * 1000000 / m_header.fps);
+    entry.thumbBytes = (uint32_t)m_encoded.size();
+    std::fwrite(&entry, sizeof(entry), 1, m_file);
+    std::fwrite(m_encoded.data(), 1, m_encoded.size(), m_file);
+
+    m_header.entryCount++;
+    m_stats.entries++;
+    m_stats.bytes += sizeof(entry) + m_encoded.size();
+    m_stats.workUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SeekIndex::Finish() {
+    if (!m_file) return;
+    std::fseek(m_file, 0, SEEK_SET);
+    std::fwrite(&m_header, sizeof(m_header), 1, m_file);
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+int SeekIndex::ReadIntervalSeconds(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    FileHeader header = {};
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1;
+    std::fclose(f);
+    if (!ok || memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.fps <= 0) return 0;
+    return (int)(header.intervalFrames / (uint32_t)header.fps);
+}
+
+int SeekIndex::ThumbHeight(int sourceWidth, int sourceHeight) {
+    if (sourceWidth <= 0 || sourceHeight <= 0) return 1;
+    int height = (int)((int64_t)sourceHeight * kThumbWidth / sourceWidth);
+    return height < 1 ? 1 : height;
+}
+
+bool SeekIndex::Read(const std::string& path, FileHeader& header, std::vector<Thumbnail>& entries) {
+    entries.clear();
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    header = {};
+    if (std::fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kVersion || header.fps <= 0 || header.thumbWidth <= 0 || header.thumbHeight <= 0) {
+        std::fclose(f);
+        return false;
+    }
+
+    // entryCount is 0 until Finish(): scan to the end of the file instead of trusting it
+    std::vector<uint8_t> encoded;
+    Thumbnail thumb;
+    while (std::fread(&thumb.entry, sizeof(thumb.entry), 1, f) == 1) {
+        // A keyframe of the thumbnail can't be larger than a few times its raw size
+        if (thumb.entry.thumbBytes > (uint64_t)header.thumbWidth * header.thumbHeight * 8 + 4096) break;
+        encoded.resize(thumb.entry.thumbBytes);
+        if (std::fread(encoded.data(), 1, encoded.size(), f) != encoded.size()) break;
+        Frame canvas = Frame::Wrap(thumb.pixels, header.thumbWidth, header.thumbHeight);
+        if (!ScreenCodec::Decode(encoded.data(), encoded.size(), canvas)) break;
+        entries.push_back(thumb);
+    }
+    std::fclose(f);
+    return true;
+}
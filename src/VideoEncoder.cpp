@@ -1,4 +1,5 @@
 #include "VideoEncoder.hpp"
+#include "AudioMixer.hpp"
 #include <iostream>
 #include <sstream>
 #include <filesystem>
@@ -8,9 +9,34 @@ VideoEncoder::VideoEncoder() : m_ffmpegPipe(nullptr), m_isRunning(false), m_widt
 
 VideoEncoder::~VideoEncoder() {
     Finish();
+    if (m_process) CloseHandle((HANDLE)m_process);
+}
+
+void VideoEncoder::OutputSize(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight,
+                              int& outWidth, int& outHeight) {
+    if ((targetWidth <= 0 && targetHeight <= 0) || sourceWidth <= 0 || sourceHeight <= 0) {
+        outWidth = sourceWidth / 2 * 2; // scale=trunc(iw/2)*2:trunc(ih/2)*2
+        outHeight = sourceHeight / 2 * 2;
+        return;
+    }
+    // -2: av_rescale(other, in, in_other * 2) * 2, rounding to nearest
+    outWidth = targetWidth > 0 ? targetWidth
+        : (int)(((int64_t)targetHeight * sourceWidth + sourceHeight) / (2 * (int64_t)sourceHeight) * 2);
+    outHeight = targetHeight > 0 ? targetHeight
+        : (int)(((int64_t)targetWidth * sourceHeight + sourceWidth) / (2 * (int64_t)sourceWidth) * 2);
+}
+
+void VideoEncoder::Prewarm() {
+    FindFFmpeg();
 }
 
 std::string VideoEncoder::FindFFmpeg() {
+    // Probed once per process; the install location doesn't move while we run
+    static const std::string path = LocateFFmpeg();
+    return path;
+}
+
+std::string VideoEncoder::LocateFFmpeg() {
     // 1. Check same directory as the executable (for portable distribution)
     char exePath[MAX_PATH];
     if (GetModuleFileNameA(NULL, exePath, MAX_PATH)) {
@@ -37,12 +63,32 @@ std::string VideoEncoder::FindFFmpeg() {
 
 bool VideoEncoder::Start(const std::string& outputPath, int sourceWidth, int sourceHeight, int fps, 
                          const std::string& audioDeviceName, bool isSystemAudio, 
-                         int targetWidth, int targetHeight) {
+                         int targetWidth, int targetHeight, int pcmAudioTracks,
+                         const std::vector<std::string>& pcmAudioFiles) {
     if (m_isRunning) return false;
+    if (m_process) {
+        CloseHandle((HANDLE)m_process);
+        m_process = nullptr;
+    }
 
     m_width = sourceWidth;
     m_height = sourceHeight;
 
+    // In-process audio: one named pipe per PCM track, opened by FFmpeg as extra inputs.
+    // Built in place: AudioPipe holds an atomic and can't be copied
+    m_audioPipes = std::vector<AudioPipe>(pcmAudioTracks > 0 ? pcmAudioTracks : 0);
+    for (int t = 0; t < pcmAudioTracks; ++t) {
+        AudioPipe& pipe = m_audioPipes[t];
+        pipe.name = "\\\\.\\pipe\\SimpleScreenRecorder_" + std::to_string(GetCurrentProcessId()) + "_audio" + std::to_string(t);
+        HANDLE hPipe = CreateNamedPipeA(pipe.name.c_str(), PIPE_ACCESS_OUTBOUND, PIPE_TYPE_BYTE | PIPE_WAIT,
+                                        1, 1 << 20, 0, 0, NULL);
+        if (hPipe == INVALID_HANDLE_VALUE) {
+            CloseAudioPipes();
+            return false;
+        }
+        pipe.handle = (void*)hPipe;
+    }
+
     std::string ffmpegPath = FindFFmpeg();
     
     // BUILD THE FFMPEG COMMAND
@@ -54,28 +100,81 @@ bool VideoEncoder::Start(const std::string& outputPath, int sourceWidth, int sou
         << " -framerate " << fps
         << " -i - "; // Input 1: Video Pipe
 
-    if (!audioDeviceName.empty()) {
+    // Streams mapped into every output; explicit so the tee muxer and the proxy see the same set
+    std::vector<std::string> audioMaps;
+    if (!m_audioPipes.empty()) {
+        for (const AudioPipe& pipe : m_audioPipes) {
+            cmd << " -thread_queue_size 2048 -f f32le"
+                << " -ar " << AudioMixer::kOutputRate
+                << " -ac " << AudioMixer::kOutputChannels
+                << " -i \"" << pipe.name << "\" ";
+            audioMaps.push_back(std::to_string(audioMaps.size() + 1) + ":a");
+        }
+    } else if (!pcmAudioFiles.empty()) {
+        for (const std::string& file : pcmAudioFiles) {
+            cmd << " -f f32le"
+                << " -ar " << AudioMixer::kOutputRate
+                << " -ac " << AudioMixer::kOutputChannels
+                << " -i \"" << file << "\" ";
+            audioMaps.push_back(std::to_string(audioMaps.size() + 1) + ":a");
+        }
+    } else if (!audioDeviceName.empty()) {
         if (isSystemAudio) {
             cmd << " -thread_queue_size 2048 -f wasapi -i \"audio=" << audioDeviceName << "\" ";
         } else {
             cmd << " -thread_queue_size 2048 -f dshow -i audio=\"" << audioDeviceName << "\" ";
         }
+        audioMaps.push_back("1:a");
     }
 
+    std::string scale;
     if (targetWidth != 0 || targetHeight != 0) {
         std::string wStr = (targetWidth <= 0) ? "-2" : std::to_string(targetWidth);
         std::string hStr = (targetHeight <= 0) ? "-2" : std::to_string(targetHeight);
-        cmd << " -vf \"scale=" << wStr << ":" << hStr << ":flags=bicubic\" ";
+        scale = "scale=" + wStr + ":" + hStr + ":flags=bicubic";
     } else {
-        cmd << " -vf \"scale=trunc(iw/2)*2:trunc(ih/2)*2\" ";
+        scale = "scale=trunc(iw/2)*2:trunc(ih/2)*2";
     }
 
-    cmd << " -c:v libx264 -preset ultrafast -crf 23"
+    // Proxy: the BGRA -> YUV conversion runs once, then the converted planes are split
+    // and the proxy is downscaled from them; FFmpeg runs each output's encoder on its own thread
+    bool proxy = !m_proxyPath.empty() && m_proxyHeight > 0;
+    std::string mainVideo = "0:v";
+    if (proxy) {
+        cmd << " -filter_complex \"[0:v]" << scale << ",format=yuv420p,split=2[vmain][vsrc];"
+            << "[vsrc]scale=-2:" << m_proxyHeight << ":flags=bilinear[vproxy]\"";
+        mainVideo = "[vmain]";
+    } else {
+        cmd << " -vf \"" << scale << "\" ";
+    }
+
+    auto maps = [&](const std::string& video) {
+        cmd << " -map " << video;
+        for (const std::string& audio : audioMaps) cmd << " -map " << audio;
+    };
+
+    maps(mainVideo);
+    cmd << " -c:v libx264 -preset ultrafast" << m_rate.EncoderArgs(m_keyframeInterval)
         << " -c:a aac -b:a 192k" 
         << " -pix_fmt yuv420p" 
         << " -shortest" 
-        << " -y " 
-        << "\"" << outputPath << "\"";
+        << " -y ";
+
+    if (m_streamSinks.empty()) {
+        cmd << "\"" << outputPath << "\"";
+    } else {
+        // Encode once, mux to every sink
+        cmd << " -flags +global_header -f tee \"" << BuildTeeOutput(outputPath) << "\"";
+    }
+
+    if (proxy) {
+        maps("[vproxy]");
+        cmd << " -c:v libx264 -preset veryfast -crf 28" << m_rate.KeyframeArgs(m_keyframeInterval)
+            << " -c:a aac -b:a 96k"
+            << " -pix_fmt yuv420p"
+            << " -shortest"
+            << " -y \"" << m_proxyPath << "\"";
+    }
 
     std::string cmdStr = cmd.str();
     std::cout << "Starting FFmpeg: " << cmdStr << std::endl;
@@ -84,7 +183,10 @@ bool VideoEncoder::Start(const std::string& outputPath, int sourceWidth, int sou
     HANDLE hPipeRead, hPipeWrite;
     SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
     
-    if (!CreatePipe(&hPipeRead, &hPipeWrite, &sa, 0)) return false;
+    if (!CreatePipe(&hPipeRead, &hPipeWrite, &sa, 0)) {
+        CloseAudioPipes();
+        return false;
+    }
     SetHandleInformation(hPipeWrite, HANDLE_FLAG_INHERIT, 0); // Don't inherit write end
 
     STARTUPINFOA si = { sizeof(STARTUPINFOA) };
@@ -101,23 +203,98 @@ bool VideoEncoder::Start(const std::string& outputPath, int sourceWidth, int sou
     if (!success) {
         CloseHandle(hPipeRead);
         CloseHandle(hPipeWrite);
+        CloseAudioPipes();
         return false;
     }
 
     CloseHandle(hPipeRead); // Child has its end
-    CloseHandle(pi.hProcess);
     CloseHandle(pi.hThread);
 
+    m_process = (void*)pi.hProcess;
+
     m_ffmpegPipe = (void*)hPipeWrite;
     m_isRunning = true;
     return true;
 }
 
-bool VideoEncoder::WriteFrame(const std::vector<uint8_t>& bgraData) {
+std::string VideoEncoder::BuildTeeOutput(const std::string& outputPath) const {
+    // Tee treats '\\', '|', '[' and ']' as syntax; Windows accepts '/' as the separator
+    auto escape = [](const std::string& target) {
+        std::string out;
+        for (char c : target) {
+            if (c == '\\') out += '/';
+            else if (c == '|' || c == '[' || c == ']') out += std::string("\\") + c;
+            else out += c;
+        }
+        return out;
+    };
+
+    // The file is written directly and must succeed; every stream sink goes through its
+    // own fifo thread, drops packets when it falls behind and is dropped if it fails
+    std::string spec = "[f=mp4:onfail=abort]" + escape(outputPath);
+    for (const std::string& url : m_streamSinks) {
+        std::string format = "mpegts"; // udp://, srt://, pipes
+        if (url.rfind("rtmp://", 0) == 0 || url.rfind("rtmps://", 0) == 0) format = "flv";
+        else if (url.size() > 4 && url.compare(url.size() - 4, 4, ".mkv") == 0) format = "matroska";
+        else if (url.size() > 4 && url.compare(url.size() - 4, 4, ".mp4") == 0) format = "mp4";
+        // fifo_options is unescaped twice (slave list, then slave options): each ':' inside
+        // it needs two backslashes, or the later options leak to the stream's own muxer
+        spec += "|[f=" + format + ":onfail=ignore:use_fifo=1"
+                ":fifo_options=drop_pkts_on_overflow=1\\\\:attempt_recovery=1\\\\:recover_any_error=1]" + escape(url);
+    }
+    return spec;
+}
+
+bool VideoEncoder::WriteFrame(const Frame& frame) {
     if (!m_isRunning || !m_ffmpegPipe) return false;
+    if (frame.Empty() || frame.width != m_width || frame.height != m_height) return false;
+
+    // One WriteFile per frame: packed views go out as-is, strided ones are packed first
+    const uint8_t* data = frame.data;
+    if (!frame.IsPacked()) {
+        Frame packed = Frame::Wrap(m_packed, frame.width, frame.height);
+        frame.CopyTo(packed);
+        data = packed.data;
+    }
+
+    DWORD bytes = (DWORD)((size_t)frame.width * frame.height * 4);
+    DWORD written;
+    BOOL success = WriteFile((HANDLE)m_ffmpegPipe, data, bytes, &written, NULL);
+    return success && written == bytes;
+}
+
+bool VideoEncoder::WriteAudio(int track, const std::vector<float>& samples) {
+    if (!m_isRunning || track < 0 || track >= (int)m_audioPipes.size()) return false;
+    AudioPipe& pipe = m_audioPipes[track];
+
+    if (!pipe.connected.load(std::memory_order_acquire)) {
+        // FFmpeg opens its inputs in order, so this waits until the video input has been probed
+        if (!ConnectNamedPipe((HANDLE)pipe.handle, NULL) && GetLastError() != ERROR_PIPE_CONNECTED) return false;
+        pipe.connected.store(true, std::memory_order_release);
+    }
+
+    if (samples.empty()) return true;
+    DWORD bytes = (DWORD)(samples.size() * sizeof(float));
     DWORD written;
-    BOOL success = WriteFile((HANDLE)m_ffmpegPipe, bgraData.data(), (DWORD)bgraData.size(), &written, NULL);
-    return success && written == bgraData.size();
+    BOOL success = WriteFile((HANDLE)pipe.handle, samples.data(), bytes, &written, NULL);
+    return success && written == bytes;
+}
+
+void VideoEncoder::ReleaseAudioWaiters() {
+    // Satisfy any ConnectNamedPipe still waiting (FFmpeg died or never reached the input)
+    for (AudioPipe& pipe : m_audioPipes) {
+        if (pipe.connected.load(std::memory_order_acquire) || pipe.dummyClient) continue;
+        HANDLE hClient = CreateFileA(pipe.name.c_str(), GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (hClient != INVALID_HANDLE_VALUE) pipe.dummyClient = (void*)hClient;
+    }
+}
+
+void VideoEncoder::CloseAudioPipes() {
+    for (AudioPipe& pipe : m_audioPipes) {
+        if (pipe.handle) CloseHandle((HANDLE)pipe.handle);
+        if (pipe.dummyClient) CloseHandle((HANDLE)pipe.dummyClient);
+    }
+    m_audioPipes.clear();
 }
 
 void VideoEncoder::Finish() {
@@ -125,5 +302,23 @@ void VideoEncoder::Finish() {
         CloseHandle((HANDLE)m_ffmpegPipe);
         m_ffmpegPipe = nullptr;
     }
+    CloseAudioPipes();
     m_isRunning = false;
 }
+
+double VideoEncoder::GetEncoderCpuSeconds() const {
+    FILETIME created, exited, kernel, user;
+    if (!m_process || !GetProcessTimes((HANDLE)m_process, &created, &exited, &kernel, &user)) return 0.0;
+    auto ticks = [](const FILETIME& t) { return ((uint64_t)t.dwHighDateTime << 32) | t.dwLowDateTime; };
+    return (ticks(kernel) + ticks(user)) / 1e7; // 100 ns units
+}
+
+bool VideoEncoder::WaitForExit() {
+    if (!m_process) return false;
+    DWORD exitCode = 1;
+    WaitForSingleObject((HANDLE)m_process, INFINITE);
+    GetExitCodeProcess((HANDLE)m_process, &exitCode);
+    CloseHandle((HANDLE)m_process);
+    m_process = nullptr;
+    return exitCode == 0;
+}
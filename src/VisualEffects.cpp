@@ -1,42 +1,136 @@
 #include "VisualEffects.hpp"
+#include "CpuDispatch.hpp"
 #include <cmath>
 #include <algorithm>
 
-void VisualEffects::DrawHighlight(std::vector<uint8_t>& bgraData, int width, int height, POINT mousePos, int radius, Color color) {
-    if (bgraData.empty()) return;
+#ifdef SSR_X86_SSE2
+#include <immintrin.h>
+#endif
 
-    int r2 = radius * radius;
-    float alpha = color.a / 255.0f;
+static uint32_t PackColor(VisualEffects::Color color) {
+    return (uint32_t)color.b | (uint32_t)color.g << 8 | (uint32_t)color.r << 16 | (uint32_t)color.a << 24;
+}
+
+void VisualEffects::BlendRow_Scalar(uint8_t* px, int count, uint32_t bgra) {
+    float alpha = (bgra >> 24) / 255.0f;
     float invAlpha = 1.0f - alpha;
+    float b = (float)(bgra & 0xFF) * alpha;
+    float g = (float)((bgra >> 8) & 0xFF) * alpha;
+    float r = (float)((bgra >> 16) & 0xFF) * alpha;
+    for (int i = 0; i < count; ++i, px += 4) {
+        px[0] = (uint8_t)(px[0] * invAlpha + b);
+        px[1] = (uint8_t)(px[1] * invAlpha + g);
+        px[2] = (uint8_t)(px[2] * invAlpha + r);
+    }
+}
 
+void VisualEffects::BlendRow(uint8_t* px, int count, uint32_t bgra) {
+    CpuDispatch::Get().blendRow(px, count, bgra);
+}
+
+#ifdef SSR_X86_SSE2
+// Same float multiply and add per channel as the scalar loop (no FMA), truncated the same way
+void VisualEffects::BlendRow_SSE2(uint8_t* px, int count, uint32_t bgra) {
+    int i = 0;
+    float alpha = (bgra >> 24) / 255.0f;
+    const __m128 inv = _mm_set1_ps(1.0f - alpha);
+    const __m128 add = _mm_setr_ps((float)(bgra & 0xFF) * alpha, (float)((bgra >> 8) & 0xFF) * alpha,
+                                   (float)((bgra >> 16) & 0xFF) * alpha, 0.0f);
+    const __m128i keepAlpha = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(px + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i p0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), inv), add));
+        __m128i p1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), inv), add));
+        __m128i p2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), inv), add));
+        __m128i p3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), inv), add));
+        __m128i out = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+        out = _mm_or_si128(_mm_andnot_si128(keepAlpha, out), _mm_and_si128(keepAlpha, v));
+        _mm_storeu_si128((__m128i*)(px + i * 4), out);
+    }
+    if (i < count) BlendRow_Scalar(px + i * 4, count - i, bgra);
+}
+#endif
+
+#ifdef SSR_X86_AVX2
+SSR_TARGET_AVX2
+void VisualEffects::BlendRow_AVX2(uint8_t* px, int count, uint32_t bgra) {
+    int i = 0;
+    float alpha = (bgra >> 24) / 255.0f;
+    const __m256 inv = _mm256_set1_ps(1.0f - alpha);
+    float b = (float)(bgra & 0xFF) * alpha, g = (float)((bgra >> 8) & 0xFF) * alpha, r = (float)((bgra >> 16) & 0xFF) * alpha;
+    const __m256 add = _mm256_setr_ps(b, g, r, 0.0f, b, g, r, 0.0f);
+    const __m256i keepAlpha = _mm256_set1_epi32((int)0xFF000000u);
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* p = px + i * 4;
+        __m256i p0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p + 0)))), inv), add));
+        __m256i p1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p + 8)))), inv), add));
+        __m256i p2 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p + 16)))), inv), add));
+        __m256i p3 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p + 24)))), inv), add));
+        // Packs interleave the 128-bit lanes; one qword permute after each restores pixel order
+        __m256i w01 = _mm256_permute4x64_epi64(_mm256_packs_epi32(p0, p1), 0xD8);
+        __m256i w23 = _mm256_permute4x64_epi64(_mm256_packs_epi32(p2, p3), 0xD8);
+        __m256i out = _mm256_permute4x64_epi64(_mm256_packus_epi16(w01, w23), 0xD8);
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        out = _mm256_or_si256(_mm256_andnot_si256(keepAlpha, out), _mm256_and_si256(keepAlpha, v));
+        _mm256_storeu_si256((__m256i*)(px + i * 4), out);
+    }
+    _mm256_zeroupper();
+    if (i < count) BlendRow_SSE2(px + i * 4, count - i, bgra);
+}
+#endif
+
+void VisualEffects::CursorRow_Scalar(uint32_t* px, const uint8_t* shape, int count) {
+    // Alpha is left as captured
+    static const uint32_t kKeep[3] = { 0xFFFFFFFFu, 0xFF000000u, 0xFF000000u };
+    static const uint32_t kSet[3] = { 0, 0, 0x00FFFFFFu };
+    for (int i = 0; i < count; ++i) px[i] = (px[i] & kKeep[shape[i]]) | kSet[shape[i]];
+}
+
+void VisualEffects::CursorRow(uint32_t* px, const uint8_t* shape, int count) {
+    CpuDispatch::Get().cursorRow(px, shape, count);
+}
+
+FrameRect VisualEffects::DrawHighlight(const Frame& frame, POINT mousePos, int radius, Color color) {
+    if (frame.Empty()) return {};
+    int width = frame.width;
+    int height = frame.height;
+
+    int r2 = radius * radius;
     int startX = std::max(0, (int)mousePos.x - radius);
     int endX = std::min(width - 1, (int)mousePos.x + radius);
     int startY = std::max(0, (int)mousePos.y - radius);
     int endY = std::min(height - 1, (int)mousePos.y + radius);
 
+    auto blendRow = CpuDispatch::Get().blendRow;
+    uint32_t bgra = PackColor(color);
     for (int y = startY; y <= endY; ++y) {
-        for (int x = startX; x <= endX; ++x) {
-            int dx = x - mousePos.x;
-            int dy = y - mousePos.y;
-            
-            if (dx * dx + dy * dy <= r2) {
-                int pixelPos = (y * width + x) * 4;
-                bgraData[pixelPos]     = (uint8_t)(bgraData[pixelPos]     * invAlpha + color.b * alpha);
-                bgraData[pixelPos + 1] = (uint8_t)(bgraData[pixelPos + 1] * invAlpha + color.g * alpha);
-                bgraData[pixelPos + 2] = (uint8_t)(bgraData[pixelPos + 2] * invAlpha + color.r * alpha);
-            }
-        }
+        // Widest |dx| with dx^2 + dy^2 <= r^2, so each row is one span
+        int dy = y - mousePos.y;
+        int rest = r2 - dy * dy;
+        int half = (int)std::sqrt((double)rest);
+        while (half * half > rest) half--;
+        while ((half + 1) * (half + 1) <= rest) half++;
+
+        int x0 = std::max(startX, (int)mousePos.x - half);
+        int x1 = std::min(endX, (int)mousePos.x + half);
+        if (x0 <= x1) blendRow(frame.Pixel(x0, y), x1 - x0 + 1, bgra);
     }
+    return FrameRect{ startX, startY, endX - startX + 1, endY - startY + 1 }.Intersect(frame.Bounds());
 }
 
-void VisualEffects::DrawCursor(std::vector<uint8_t>& bgraData, int width, int height, POINT mousePos) {
+FrameRect VisualEffects::DrawCursor(const Frame& frame, POINT mousePos) {
+    if (frame.Empty()) return {};
+
     // 12x19 Standard Cursor Bitmap
     // 0 = Transparent
     // 1 = Black Border
     // 2 = White Fill
     static const int cursorW = 12;
     static const int cursorH = 19;
-    static const int cursorShape[19][12] = {
+    static const uint8_t cursorShape[19][12] = {
         {1,0,0,0,0,0,0,0,0,0,0,0},
         {1,1,0,0,0,0,0,0,0,0,0,0},
         {1,2,1,0,0,0,0,0,0,0,0,0},
@@ -58,35 +152,30 @@ void VisualEffects::DrawCursor(std::vector<uint8_t>& bgraData, int width, int he
         {0,0,0,0,0,0,0,0,0,0,0,0}
     };
 
+    auto cursorRow = CpuDispatch::Get().cursorRow;
+    int x0 = std::max(0, -(int)mousePos.x);
+    int x1 = std::min(cursorW, frame.width - (int)mousePos.x);
     for (int y = 0; y < cursorH; ++y) {
-        for (int x = 0; x < cursorW; ++x) {
-            int pixelType = cursorShape[y][x];
-            if (pixelType == 0) continue;
-
-            int px = mousePos.x + x;
-            int py = mousePos.y + y;
-
-            if (px >= 0 && px < width && py >= 0 && py < height) {
-                size_t index = (py * width + px) * 4;
-                
-                if (pixelType == 1) { // Black Border
-                    bgraData[index] = 0; bgraData[index+1] = 0; bgraData[index+2] = 0; 
-                } 
-                else if (pixelType == 2) { // White Fill
-                    bgraData[index] = 255; bgraData[index+1] = 255; bgraData[index+2] = 255;
-                }
-                // (Alpha remains 255 from capture or set clearly here if needed, but usually Capture sets it)
-            }
-        }
+        int py = mousePos.y + y;
+        if (py < 0 || py >= frame.height || x0 >= x1) continue;
+        cursorRow((uint32_t*)frame.Pixel(mousePos.x + x0, py), cursorShape[y] + x0, x1 - x0);
     }
+    return FrameRect{ (int)mousePos.x, (int)mousePos.y, cursorW, cursorH }.Intersect(frame.Bounds());
 }
 
+// The pointer is only polled on Windows; elsewhere the drawing code is built for tools and tests
 POINT VisualEffects::GetMousePosition() {
-    POINT p;
+    POINT p = { 0, 0 };
+#ifdef _WIN32
     GetCursorPos(&p);
+#endif
     return p;
 }
 
 bool VisualEffects::IsLeftClicked() {
+#ifdef _WIN32
     return (GetAsyncKeyState(VK_LBUTTON) & 0x8000) != 0;
+#else
+    return false;
+#endif
 }
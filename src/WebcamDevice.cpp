@@ -1,5 +1,9 @@
 #include "WebcamDevice.hpp"
+#include "WebcamOverlay.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 #include <mfapi.h>
 #include <mfidl.h>
 #include <mfreadwrite.h>
@@ -81,6 +85,7 @@ bool WebcamDevice::Initialize(int deviceIndex) {
 bool WebcamDevice::SetupSourceReader(IMFMediaSource* pSource) {
     IMFAttributes* pAttributes = NULL;
     MFCreateAttributes(&pAttributes, 1);
+    // Only kicks in for the RGB32 fallback; native formats pass through untouched
     pAttributes->SetUINT32(MF_SOURCE_READER_ENABLE_VIDEO_PROCESSING, TRUE);
 
     HRESULT hr = MFCreateSourceReaderFromMediaSource(pSource, pAttributes, &m_pReader);
@@ -94,7 +99,26 @@ bool WebcamDevice::SetupSourceReader(IMFMediaSource* pSource) {
     IMFMediaType* pType = NULL;
     hr = m_pReader->GetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, &pType);
     if (SUCCEEDED(hr)) {
-        MFGetAttributeSize(pType, MF_MT_FRAME_SIZE, (UINT32*)&m_width, (UINT32*)&m_height);
+        // Decoders may pad the frame (1080 -> 1088 rows); the aperture is the visible part
+        UINT32 frameWidth = 0, frameHeight = 0;
+        MFGetAttributeSize(pType, MF_MT_FRAME_SIZE, &frameWidth, &frameHeight);
+        m_width = (int)frameWidth;
+        m_height = m_planeHeight = (int)frameHeight;
+        MFVideoArea aperture = {};
+        if (SUCCEEDED(pType->GetBlob(MF_MT_MINIMUM_DISPLAY_APERTURE, (UINT8*)&aperture, sizeof(aperture), NULL)) &&
+            aperture.Area.cx > 0 && aperture.Area.cy > 0) {
+            m_width = std::min(m_width, (int)aperture.Area.cx);
+            m_height = std::min(m_height, (int)aperture.Area.cy);
+        }
+
+        // Only used when a buffer can't report its own pitch
+        UINT32 stride = 0;
+        GUID subtype = GUID_NULL;
+        if (SUCCEEDED(pType->GetUINT32(MF_MT_DEFAULT_STRIDE, &stride))) {
+            m_defaultStride = (LONG)stride;
+        } else if (SUCCEEDED(pType->GetGUID(MF_MT_SUBTYPE, &subtype))) {
+            MFGetStrideForBitmapInfoHeader(subtype.Data1, frameWidth, &m_defaultStride);
+        }
         SafeRelease(&pType);
     }
 
@@ -102,17 +126,73 @@ bool WebcamDevice::SetupSourceReader(IMFMediaSource* pSource) {
 }
 
 HRESULT WebcamDevice::NormalizeFormat(IMFMediaType* pType) {
-    // Force RGB32 (X8R8G8B8) or ARGB32 for easy compositing
+    // Prefer the camera's native YUV layout and convert in-process, fused with the downscale.
+    // MJPEG cameras are decoded to NV12 by MF's decoder; RGB32 through the video processor
+    // (full-res CPU conversion) is only the last resort.
     IMFMediaType* pNativeType = NULL;
-    HRESULT hr = MFCreateMediaType(&pNativeType);
-    hr = pNativeType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
-    hr = pNativeType->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_RGB32);
-    
-    hr = m_pReader->SetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, NULL, pNativeType);
-    SafeRelease(&pNativeType);
+    GUID nativeSubtype = GUID_NULL;
+    HRESULT hr = m_pReader->GetNativeMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM,
+                                               (DWORD)MF_SOURCE_READER_CURRENT_TYPE_INDEX, &pNativeType);
+    if (SUCCEEDED(hr)) {
+        pNativeType->GetGUID(MF_MT_SUBTYPE, &nativeSubtype);
+        SafeRelease(&pNativeType);
+    }
+
+    struct Candidate {
+        GUID subtype;
+        PixelConvert::Format format;
+    };
+    std::vector<Candidate> candidates;
+    if (nativeSubtype == MFVideoFormat_YUY2) candidates.push_back({ MFVideoFormat_YUY2, PixelConvert::Format::YUY2 });
+    candidates.push_back({ MFVideoFormat_NV12, PixelConvert::Format::NV12 });
+    candidates.push_back({ MFVideoFormat_YUY2, PixelConvert::Format::YUY2 });
+    candidates.push_back({ MFVideoFormat_RGB32, PixelConvert::Format::BGRA });
+
+    for (const Candidate& candidate : candidates) {
+        IMFMediaType* pOutType = NULL;
+        hr = MFCreateMediaType(&pOutType);
+        if (FAILED(hr)) return hr;
+        pOutType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
+        pOutType->SetGUID(MF_MT_SUBTYPE, candidate.subtype);
+
+        hr = m_pReader->SetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, NULL, pOutType);
+        SafeRelease(&pOutType);
+        if (SUCCEEDED(hr)) {
+            m_format = candidate.format;
+            return hr;
+        }
+    }
     return hr;
 }
 
+void WebcamDevice::DeliverBuffer(IMFMediaBuffer* pBuffer) {
+    // Lock2D reports the real pitch (row padding, bottom-up RGB32) and the top row
+    IMF2DBuffer* p2D = NULL;
+    BYTE* scan0 = NULL;
+    LONG pitch = 0;
+    if (SUCCEEDED(pBuffer->QueryInterface(IID_PPV_ARGS(&p2D))) && SUCCEEDED(p2D->Lock2D(&scan0, &pitch))) {
+        Deliver(scan0, (int)pitch);
+        p2D->Unlock2D();
+        SafeRelease(&p2D);
+        return;
+    }
+    SafeRelease(&p2D);
+
+    // Plain buffer: laid out as the media type says (MF_MT_DEFAULT_STRIDE, m_planeHeight rows)
+    BYTE* pData = NULL;
+    DWORD cbLength = 0;
+    if (m_width <= 0 || m_height <= 0 || m_defaultStride == 0 || FAILED(pBuffer->Lock(&pData, NULL, &cbLength))) return;
+    size_t pitchBytes = (size_t)std::abs(m_defaultStride);
+    size_t rows = (m_format == PixelConvert::Format::NV12) ? (size_t)m_planeHeight * 3 / 2 : (size_t)m_planeHeight;
+    size_t minPitch = (size_t)m_width * (m_format == PixelConvert::Format::NV12 ? 1 : m_format == PixelConvert::Format::YUY2 ? 2 : 4);
+    if (pitchBytes >= minPitch && pitchBytes * rows <= cbLength) {
+        // Bottom-up images start with their last row in memory
+        BYTE* top = m_defaultStride < 0 ? pData + pitchBytes * (m_planeHeight - 1) : pData;
+        Deliver(top, (int)m_defaultStride);
+    }
+    pBuffer->Unlock();
+}
+
 void WebcamDevice::Start() {
     if (!m_initialized || m_isStreaming) return;
     m_isStreaming = true;
@@ -127,18 +207,81 @@ void WebcamDevice::Stop() {
     if (m_worker.joinable()) m_worker.join();
 }
 
-bool WebcamDevice::GetFrame(std::vector<uint8_t>& outBuffer, int& width, int& height) {
-    if (!m_initialized) return false;
-
-    std::lock_guard<std::mutex> lock(m_frameMutex);
-    if (!m_lastFrame.empty()) {
-        width = m_width;
-        height = m_height;
-        outBuffer = m_lastFrame;
-        return true;
+std::shared_ptr<WebcamDevice::Subscriber> WebcamDevice::Subscribe(int outputHeight, int maxFps) {
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->m_outputHeight = outputHeight;
+    if (maxFps > 0) {
+        subscriber->m_minInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::microseconds(1000000 / maxFps));
     }
 
-    return false;
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    m_subscribers.push_back(subscriber);
+    return subscriber;
+}
+
+void WebcamDevice::Unsubscribe(const std::shared_ptr<Subscriber>& subscriber) {
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    m_subscribers.erase(std::remove(m_subscribers.begin(), m_subscribers.end(), subscriber), m_subscribers.end());
+}
+
+bool WebcamDevice::Subscriber::GetFrame(std::vector<uint8_t>& outBuffer, int& width, int& height) {
+    FrameView view;
+    if (!AcquireFrame(view)) return false;
+
+    width = view.width;
+    height = view.height;
+    outBuffer.assign(view.data, view.data + (size_t)view.width * view.height * 4);
+    m_framesCopied.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WebcamDevice::Subscriber::AcquireFrame(FrameView& out) {
+    if (m_frames.Update()) m_framesConsumed.fetch_add(1, std::memory_order_relaxed);
+
+    const FrameSlot& slot = m_frames.ReadBuffer();
+    if (slot.pixels.empty()) return false;
+
+    out.data = slot.pixels.data();
+    out.width = slot.width;
+    out.height = slot.height;
+    out.sequence = m_frames.ReadSequence();
+    return true;
+}
+
+WebcamDevice::Stats WebcamDevice::Subscriber::GetStats() const {
+    Stats stats;
+    stats.framesPublished = m_frames.PublishedCount();
+    stats.framesConsumed = m_framesConsumed.load(std::memory_order_relaxed);
+    stats.framesCopied = m_framesCopied.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void WebcamDevice::Deliver(const uint8_t* scan0, int srcStride) {
+    auto now = std::chrono::steady_clock::now();
+    // NV12's UV plane follows all allocated Y rows, padding included
+    const uint8_t* uvPlane = m_format == PixelConvert::Format::NV12 ? scan0 + (ptrdiff_t)srcStride * m_planeHeight : nullptr;
+
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    for (const std::shared_ptr<Subscriber>& subscriber : m_subscribers) {
+        if (subscriber->m_minInterval.count() > 0 && now - subscriber->m_lastDelivery < subscriber->m_minInterval) continue;
+
+        // Convert straight from the native format into the subscriber's private slot at its
+        // requested output size (no reallocation once sized), then publish it
+        int outH = subscriber->m_outputHeight;
+        if (outH <= 0 || outH > m_height) outH = m_height;
+        int outW = WebcamOverlay::TileWidth(m_width, m_height, outH); // Same rounding as the PIP: blitted unscaled
+        if (outW <= 0 || outH <= 0) continue;
+
+        FrameSlot& slot = subscriber->m_frames.WriteBuffer();
+        slot.pixels.resize((size_t)outW * outH * 4);
+        PixelConvert::ConvertScaled(scan0, srcStride, m_width, m_height, m_format,
+                                    slot.pixels.data(), outW * 4, outW, outH, uvPlane);
+        slot.width = outW;
+        slot.height = outH;
+        subscriber->m_frames.Publish();
+        subscriber->m_lastDelivery = now;
+    }
 }
 
 void WebcamDevice::CaptureLoop() {
@@ -158,15 +301,7 @@ void WebcamDevice::CaptureLoop() {
         if (pSample) {
             IMFMediaBuffer* pBuffer = NULL;
             if (SUCCEEDED(pSample->ConvertToContiguousBuffer(&pBuffer))) {
-                BYTE* pData = NULL;
-                DWORD cbLength = 0;
-                if (SUCCEEDED(pBuffer->Lock(&pData, NULL, &cbLength))) {
-                    {
-                        std::lock_guard<std::mutex> lock(m_frameMutex);
-                        m_lastFrame.assign(pData, pData + cbLength);
-                    }
-                    pBuffer->Unlock();
-                }
+                DeliverBuffer(pBuffer);
                 pBuffer->Release();
             }
             pSample->Release();
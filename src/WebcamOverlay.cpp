@@ -0,0 +1,69 @@
+#include "WebcamOverlay.hpp"
+#include "PixelConvert.hpp"
+#include "CpuDispatch.hpp"
+#include <cstring>
+
+int WebcamOverlay::TileWidth(int sourceW, int sourceH, int targetH) {
+    if (sourceW <= 0 || sourceH <= 0 || targetH <= 0) return 0;
+    return (int)((int64_t)sourceW * targetH / sourceH);
+}
+
+void WebcamOverlay::Update(const uint8_t* webBuf, int wW, int wH, uint64_t sequence, int targetH) {
+    if (!webBuf || wW <= 0 || wH <= 0 || targetH <= 0) return;
+
+    int targetW = TileWidth(wW, wH, targetH);
+    if (targetW <= 0) return;
+
+    // Delivered at the PIP size (the recorder's subscription): nothing to scale
+    if (targetW == wW && targetH == wH) {
+        if (sequence != m_sequence || m_pixels != webBuf) m_stats.inPlace++;
+        m_pixels = webBuf;
+        m_tileW = targetW;
+        m_tileH = targetH;
+        m_sourceW = wW;
+        m_sourceH = wH;
+        m_sequence = sequence;
+        return;
+    }
+
+    bool sameGeometry = targetW == m_tileW && targetH == m_tileH && wW == m_sourceW && wH == m_sourceH;
+    if (sameGeometry && sequence == m_sequence && HasTile() && m_pixels == m_tile.data()) return;
+
+    // Nearest-neighbour scale straight into the cached tile (forces alpha to 255)
+    m_tile.resize((size_t)targetW * targetH * 4);
+    PixelConvert::ConvertScaled(webBuf, wW * 4, wW, wH, PixelConvert::Format::BGRA,
+                                m_tile.data(), targetW * 4, targetW, targetH);
+
+    m_pixels = m_tile.data();
+    m_tileW = targetW;
+    m_tileH = targetH;
+    m_sourceW = wW;
+    m_sourceH = wH;
+    m_sequence = sequence;
+    m_stats.rescales++;
+}
+
+FrameRect WebcamOverlay::Blit(const Frame& dst, int x, int y) {
+    if (!HasTile() || dst.Empty()) return {};
+
+    FrameRect r = FrameRect{ x, y, m_tileW, m_tileH }.Intersect(dst.Bounds());
+    if (r.Empty()) return {};
+
+    size_t rowBytes = (size_t)r.width * 4;
+    auto copyRow = CpuDispatch::Get().copyRow;
+    for (int row = r.y; row < r.y + r.height; ++row) {
+        const uint8_t* src = m_pixels + ((size_t)(row - y) * m_tileW + (r.x - x)) * 4;
+        copyRow(dst.Pixel(r.x, row), src, rowBytes);
+    }
+    m_stats.blits++;
+    return r;
+}
+
+void WebcamOverlay::Reset() {
+    m_tile.clear();
+    m_pixels = nullptr;
+    m_tileW = m_tileH = 0;
+    m_sourceW = m_sourceH = 0;
+    m_sequence = 0;
+    m_stats = Stats();
+}
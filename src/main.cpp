@@ -4,22 +4,43 @@
 #include <thread>
 #include <atomic>
 #include <iomanip>
+#include <sstream>
+#include <cmath>
 #include "ScreenCapture.hpp"
 #include "VideoEncoder.hpp"
 #include "VisualEffects.hpp"
 #include "AudioCapture.hpp"
+#include "AudioMixer.hpp"
 #include "Controller.hpp"
+#include "EngineControl.hpp"
+#include "SnapshotStore.hpp"
 #include <filesystem>
 #include <string>
+#include <vector>
 #include "WebcamDevice.hpp"
+#include "WebcamOverlay.hpp"
+#include "FrameCompositor.hpp"
+#include "ChangeMap.hpp"
+#include "FrameSpool.hpp"
+#include "SeekIndex.hpp"
+#include "IdleDetector.hpp"
+#include "RoiMap.hpp"
+#include "FrameExport.hpp"
+#include "CpuDispatch.hpp"
+#include "OverlayPipeline.hpp"
+#include <functional>
+#include <mutex>
 
 // Global state
-std::atomic<bool> g_isRecording(false);
-std::atomic<bool> g_isPaused(false);
-std::atomic<bool> g_shouldExit(false);
-Controller::Settings g_currentSettings;
+EngineControl g_engine;                          // UI -> engine commands, engine state
+std::atomic<int64_t> g_startRequestedUs(0);       // steady_clock time of the Start flip, for time-to-first-frame
+SnapshotStore<Controller::Settings> g_settings; // Published by the UI, read by the engine once per frame
 std::string g_saveDirectory = ".";
 Controller* g_uiPtr = nullptr;
+std::mutex g_transcodeMutex;                     // One spool transcode at a time
+std::mutex g_transcodeThreadsMutex;
+std::vector<std::thread> g_transcodeThreads;     // Joined at exit
+std::atomic<bool> g_cancelTranscodes(false);     // Set at exit: stop feeding FFmpeg, keep the spool
 
 namespace fs = std::filesystem;
 
@@ -37,211 +58,738 @@ std::string GetNextRecordingFilename() {
 }
 
 /**
- * Helper to composite webcam frame over screen frame
+ * Audio Thread: pulls mic and/or system audio, resamples and mixes it
+ * in-process and feeds the encoder's PCM track(s) (or the spool's audio
+ * files) on a wall-clock schedule. Reports the output level to the idle
+ * detector and, while it reports idle, holds back only the pre-roll.
  */
-void CompositeWebcam(std::vector<uint8_t>& screenBuf, int sW, int sH, 
-                     const std::vector<uint8_t>& webBuf, int wW, int wH,
-                     POINT webcamPos, RECT customRegion) {
-    if (webBuf.empty()) return;
-
-    // Fixed PIP size: 20% of screen height
-    int targetH = sH / 5;
-    int targetW = (int)((float)wW / wH * targetH);
-    
-    // Position: Convert screen coordinates to relative capture coordinates
-    // If customRegion is full screen (0,0,0,0), then left/top are 0.
-    int startX = webcamPos.x - customRegion.left;
-    int startY = webcamPos.y - customRegion.top;
-
-    // Basic Nearest Neighbor Downscaling for simplicity & speed
-    for (int y = 0; y < targetH; y++) {
-        for (int x = 0; x < targetW; x++) {
-            // Screen coordinates
-            int screenX = startX + x;
-            int screenY = startY + y;
-
-            if (screenX < 0 || screenY < 0 || screenX >= sW || screenY >= sH) continue;
-
-            // Map to webcam coordinates
-            int srcX = x * wW / targetW;
-            int srcY = y * wH / targetH;
-
-            int dstIdx = (screenY * sW + screenX) * 4;
-            int srcIdx = (srcY * wW + srcX) * 4;
-
-            // Direct copy without alpha-blending for speed
-            uint8_t* d = &screenBuf[dstIdx];
-            const uint8_t* s = &webBuf[srcIdx];
-            d[0] = s[0]; // B
-            d[1] = s[1]; // G
-            d[2] = s[2]; // R
-            d[3] = 255;  // A
+void AudioThread(std::function<bool(int, const std::vector<float>&)> writeTrack, AudioCapture* mic, AudioCapture* system,
+                 bool separateTracks, IdleDetector* idle, std::atomic<bool>& running) {
+    AudioMixer mixer;
+    std::vector<std::pair<AudioCapture*, int>> inputs;
+    int micSource = mic ? mixer.AddSource(mic->GetSampleRate(), mic->GetChannels()) : -1;
+    int systemSource = system ? mixer.AddSource(system->GetSampleRate(), system->GetChannels()) : -1;
+    if (mic) inputs.push_back({ mic, micSource });
+    if (system) inputs.push_back({ system, systemSource });
+    uint64_t settingsVersion = UINT64_MAX;
+
+    std::vector<float> captured;
+    std::vector<float> mixed;
+
+    // Newest pre-roll per track while idle; written ahead of the first active audio
+    int tracks = separateTracks ? (int)inputs.size() : 1;
+    std::vector<std::vector<float>> held(tracks);
+    size_t heldLimit = (size_t)(IdleDetector::kPrerollSeconds * AudioMixer::kOutputRate) * AudioMixer::kOutputChannels;
+
+    // The devices have been running since warm-up; what they buffered before the start isn't part of the recording
+    for (auto& [source, index] : inputs) source->GetAudioSamples(captured);
+
+    uint64_t framesOut = 0;
+    uint64_t totalFrames = 0;
+    auto clockStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration processingTime{ 0 };
+
+    while (running) {
+        if (g_engine.GetState() == EngineControl::State::Paused) {
+            // Block until resumed, then drop what the devices buffered meanwhile and
+            // restart the clock so the track continues seamlessly
+            g_engine.WaitWhileState(EngineControl::State::Paused);
+            for (auto& [source, index] : inputs) source->GetAudioSamples(captured);
+            mixer.Flush();
+            clockStart = std::chrono::steady_clock::now();
+            framesOut = 0;
+            continue;
+        }
+
+        auto workStart = std::chrono::steady_clock::now();
+
+        // Gains follow the live settings; only re-applied when a new snapshot was published
+        auto settings = g_settings.Load();
+        if (settings->version != settingsVersion) {
+            settingsVersion = settings->version;
+            mixer.SetGain(micSource, settings->value.micGain);
+            mixer.SetGain(systemSource, settings->value.systemGain);
+        }
+
+        for (auto& [source, index] : inputs) {
+            if (source->GetAudioSamples(captured)) {
+                mixer.PushSamples(index, captured.data(), captured.size() / source->GetChannels());
+            }
+        }
+
+
+        // Produce exactly as much audio as wall-clock time has elapsed
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clockStart);
+        uint64_t due = (uint64_t)elapsed.count() * AudioMixer::kOutputRate / 1000000;
+        size_t frames = (size_t)(due - framesOut);
+
+        if (frames > 0) {
+            bool holding = idle && idle->IsIdle();
+            float level = 0.0f;
+            for (int t = 0; t < tracks; ++t) {
+                if (separateTracks) mixer.ReadSource(inputs[t].second, frames, mixed);
+                else mixer.Mix(frames, mixed);
+
+                if (idle) {
+                    double sum = 0.0;
+                    for (float v : mixed) sum += (double)v * v;
+                    float rms = (float)std::sqrt(sum / mixed.size());
+                    if (rms > level) level = rms;
+                }
+                if (holding) {
+                    std::vector<float>& h = held[t];
+                    h.insert(h.end(), mixed.begin(), mixed.end());
+                    if (h.size() > heldLimit) h.erase(h.begin(), h.end() - heldLimit);
+                    continue;
+                }
+
+                processingTime += std::chrono::steady_clock::now() - workStart;
+                if (!held[t].empty()) {
+                    if (!writeTrack(t, held[t])) running = false;
+                    held[t].clear();
+                }
+                if (!writeTrack(t, mixed)) running = false;
+                workStart = std::chrono::steady_clock::now();
+            }
+            if (idle) idle->SetAudioLevel(level);
+            framesOut += frames;
+            if (!holding) totalFrames += frames;
+        }
+        processingTime += std::chrono::steady_clock::now() - workStart;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (totalFrames > 0) {
+        double seconds = (double)totalFrames / AudioMixer::kOutputRate;
+        double ms = std::chrono::duration<double, std::milli>(processingTime).count();
+        std::cout << "Audio mix cost: " << std::fixed << std::setprecision(2)
+                  << (ms / seconds) << " ms per second of audio (" << inputs.size() << " source(s))" << std::endl;
+    }
+}
+
+/**
+ * Spool transcode: replays a spool into FFmpeg at below-normal priority and
+ * deletes it once the MP4 is written. Yields to a live recording by simply
+ * not feeding FFmpeg, which then blocks on its input.
+ */
+void TranscodeSpool(std::string spoolPath) {
+    std::lock_guard<std::mutex> lock(g_transcodeMutex);
+    if (g_cancelTranscodes) return; // Exiting: the spool is picked up on the next launch
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    FrameSpoolReader reader;
+    if (!reader.Open(spoolPath)) {
+        std::cerr << "Unreadable spool: " << spoolPath << std::endl;
+        return;
+    }
+    const FrameSpool::FileHeader& info = reader.Info();
+    std::string outputPath = fs::path(spoolPath).replace_extension("").string();
+
+    std::vector<std::string> audioFiles;
+    for (int t = 0; t < info.audioTracks; ++t) audioFiles.push_back(FrameSpool::AudioPath(spoolPath, t));
+
+    VideoEncoder encoder;
+    int keyframeInterval = SeekIndex::ReadIntervalSeconds(SeekIndex::PathFor(outputPath));
+    encoder.SetKeyframeInterval(keyframeInterval);
+
+    // Every frame's change is known up front: keyframes go exactly on the scene changes
+    // (the spool's own flag: the setting may have changed since it was recorded)
+    if (info.flags & FrameSpool::AdaptiveRateControl) {
+        std::vector<float> changed;
+        reader.ChangedFractions(changed);
+        RateController::Stats rc;
+        int outWidth, outHeight;
+        VideoEncoder::OutputSize(info.width, info.height, info.targetWidth, info.targetHeight, outWidth, outHeight);
+        encoder.SetRateControl(RateController::Offline(outWidth, outHeight, info.fps, changed, keyframeInterval, &rc));
+        if (rc.frames > 0) {
+            std::cout << "Rate control: " << rc.sceneChanges << " scene change(s), " << std::fixed << std::setprecision(0)
+                      << (100.0 * rc.staticFrames / rc.frames) << "% static, " << (100.0 * rc.burstFrames / rc.frames)
+                      << "% burst frames" << std::endl;
         }
     }
+    if (!encoder.Start(outputPath, info.width, info.height, info.fps, "", false,
+                       info.targetWidth, info.targetHeight, 0, audioFiles)) {
+        std::cerr << "Failed to start transcode of " << spoolPath << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Frame frame;
+    size_t frames = 0;
+    bool ok = true;
+    while (ok && !g_cancelTranscodes && reader.Next(frame)) {
+        g_engine.WaitWhileState(EngineControl::State::Warming, EngineControl::State::Recording);
+        ok = encoder.WriteFrame(frame);
+        frames++;
+    }
+    bool cancelled = g_cancelTranscodes;
+    encoder.Finish();
+    ok = encoder.WaitForExit() && ok && !cancelled;
+    reader.Close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Transcoded " << frames << " spooled frames in " << std::fixed << std::setprecision(1)
+              << seconds << " s: " << outputPath
+              << (cancelled ? " (stopped at exit, spool kept)" : ok ? "" : " (FFmpeg failed, spool kept)") << std::endl;
+
+    if (ok) {
+        std::error_code ec;
+        fs::remove(spoolPath, ec);
+        for (const std::string& file : audioFiles) fs::remove(file, ec);
+    }
+}
+
+void StartTranscode(const std::string& spoolPath) {
+    std::lock_guard<std::mutex> lock(g_transcodeThreadsMutex);
+    g_transcodeThreads.emplace_back(TranscodeSpool, spoolPath);
+}
+
+// At exit: a transcode in progress stops after its current frame (its spool is kept and
+// encoded on the next launch) and queued ones don't start
+void StopTranscodes() {
+    g_cancelTranscodes = true;
+    std::lock_guard<std::mutex> lock(g_transcodeThreadsMutex);
+    for (std::thread& t : g_transcodeThreads) t.join();
+    g_transcodeThreads.clear();
 }
 
 /**
  * The Recording Engine Thread
  */
 void RecordingThread() {
+    using State = EngineControl::State;
+    using Command = EngineControl::Command;
+
     ScreenCapture capture;
     VideoEncoder encoder;
-    AudioCapture audio;
-    WebcamDevice webcam;
+    FrameSpool spool;
+    SeekIndex seekIndex;
+    std::vector<uint8_t> thumbPixels; // Preview-scale output, shared by the UI preview and the seek index
+    IdleDetector idle;
+    RoiMap roiMap;
+    OverlayPipeline overlays;
+    FrameExport frameExport;
+    const std::vector<FrameRect> noDamage;
+    AudioCapture micAudio;
+    AudioCapture systemAudio;
+    std::shared_ptr<WebcamDevice::Subscriber> webcam;
+    WebcamOverlay webcamOverlay;
+
+    // Devices (audio endpoints, the camera on first subscribe) are opened from this thread
+    CoInitializeEx(nullptr, COINIT_MULTITHREADED);
 
     if (!capture.Initialize()) {
         std::cerr << "Capture initialization failed!" << std::endl;
+        CoUninitialize();
         return;
     }
+    std::cout << "CPU kernels: " << CpuDispatch::Describe() << std::endl;
 
-    std::vector<uint8_t> frameBuffer;
-    int screenWidth, screenHeight;
+    Frame screen;                // Read-only view into the capture backend (pristine)
+    FrameCompositor compositor;  // Composited output
+    ChangeMap changeMap;         // Tile-hash damage when the backend reports none
+    std::vector<FrameRect> changeRects;
+    int screenWidth = 0, screenHeight = 0;
     int fps = 30;
     auto frameDuration = std::chrono::microseconds(1000000 / fps);
 
-    while (!g_shouldExit) {
-        if (g_isRecording) {
-            std::string outputPath = GetNextRecordingFilename();
-            std::cout << "\nStarting Recording: " << outputPath << std::endl;
-
-            // 1. Setup Audio
-            std::string micName = "";
-            if (g_currentSettings.recordAudio) {
-                if (audio.Initialize(g_currentSettings.useSystemAudio)) {
-                    micName = g_currentSettings.useSystemAudio ? "" : audio.GetDeviceName();
-                    audio.Start();
-                }
+    bool shutdown = false;
+    bool rewarm = false;
+    while (!shutdown) {
+        // Idle: blocked in the kernel until the UI asks for something
+        Command command = rewarm ? Command::Prepare : g_engine.WaitCommand();
+        rewarm = false;
+        if (command == Command::Shutdown) break;
+        if (command != Command::Prepare && command != Command::Start) continue; // Stale pause/stop
+
+        // 1. Warm-up: everything slow (device activation, camera, FFmpeg spawn) happens here,
+        // ahead of Start (the UI prepares when it shows and whenever a source changes), so the
+        // start itself is just a state flip
+        g_engine.SetState(State::Warming);
+        bool wasWarm = (command == Command::Prepare);
+        auto warmStart = std::chrono::steady_clock::now();
+        std::string outputPath = GetNextRecordingFilename();
+        std::cout << "\nPreparing Recording: " << outputPath << std::endl;
+
+        // Session-level settings (sources, region, output size) are fixed for the whole recording
+        auto sessionSnapshot = g_settings.Load();
+        const Controller::Settings& session = sessionSnapshot->value;
+
+        // The first screen image fixes the output size for the session
+        capture.SetRegion(session.customRegion);
+        if (!capture.AcquireFrame(screen)) {
+            std::cerr << "No screen image available!" << std::endl;
+            g_engine.SetState(State::Idle);
+            continue;
+        }
+        screenWidth = screen.width;
+        screenHeight = screen.height;
+
+        // Audio (mic and/or system loopback, mixed in-process)
+        bool useMic = false;
+        bool useSystem = false;
+        if (session.recordAudio) {
+            if (session.useMicAudio && micAudio.Initialize(false)) {
+                useMic = micAudio.Start();
+            }
+            if (session.useSystemAudio && systemAudio.Initialize(true)) {
+                useSystem = systemAudio.Start();
             }
+        }
+        int audioSources = (useMic ? 1 : 0) + (useSystem ? 1 : 0);
+        bool separateTracks = session.separateAudioTracks && audioSources > 1;
+        int audioTracks = separateTracks ? audioSources : (audioSources > 0 ? 1 : 0);
+
+        // Join the shared camera session (already warm if the preview is showing);
+        // camera frames arrive already at PIP size
+        int pipHeight = session.webcamHeight > 0 ? session.webcamHeight : screenHeight / 5;
+        if (session.useWebcam && g_uiPtr) {
+            webcam = g_uiPtr->GetCameraService().Subscribe(pipHeight);
+        }
+
+        // FFmpeg just waits on its input pipe until the first frame arrives. In spool mode
+        // nothing is encoded now: frames and audio go to a preallocated spool file instead.
+        bool spoolMode = session.spoolRecording;
+        std::string spoolPath = outputPath + ".spool";
+        encoder.SetStreamSinks(session.streamSinks);
+        std::string proxyPath = session.proxyHeight > 0
+            ? fs::path(outputPath).replace_extension("").string() + "_proxy.mp4" : std::string();
+        encoder.SetProxyOutput(proxyPath, session.proxyHeight);
+        encoder.SetKeyframeInterval(session.seekIndexInterval);
+        int outWidth, outHeight;
+        VideoEncoder::OutputSize(screenWidth, screenHeight, session.width, session.height, outWidth, outHeight);
+        encoder.SetRateControl(session.adaptiveRateControl ? RateController::Live(outWidth, outHeight, fps) : RateController::Fixed());
+        bool sinkReady = spoolMode
+            ? spool.Create(spoolPath, screenWidth, screenHeight, fps, session.width, session.height, audioTracks,
+                           session.adaptiveRateControl ? FrameSpool::AdaptiveRateControl : 0)
+            : encoder.Start(outputPath, screenWidth, screenHeight, fps,
+                            "", false,
+                            session.width, session.height, audioTracks);
+        if (!sinkReady) {
+            std::cerr << (spoolMode ? "Failed to create spool file!" : "Failed to start Video Encoder!") << std::endl;
+            micAudio.Stop();
+            systemAudio.Stop();
+            if (webcam) g_uiPtr->GetCameraService().Unsubscribe(webcam);
+            micAudio.Cleanup();
+            systemAudio.Cleanup();
+            g_engine.SetState(State::Idle);
+            continue;
+        }
+
+        auto warmMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - warmStart);
+        std::cout << "Warm-up: devices and encoder ready in " << warmMs.count() << " ms" << std::endl;
+
+        // 2. Ready: block until the flip (or until the session is abandoned). Another Prepare
+        // means the sources changed: drop this session and warm up again for the new ones
+        while (command != Command::Start && command != Command::Stop && command != Command::Shutdown) {
+            command = g_engine.WaitCommand();
+            if (command == Command::Prepare) break;
+        }
 
-            // 1.5 Setup Webcam
-            if (g_currentSettings.useWebcam) {
-                if (webcam.Initialize(0)) {
-                    webcam.Start();
+        if (command != Command::Start) {
+            // Abandoned before it started: drop the empty output
+            micAudio.Stop();
+            systemAudio.Stop();
+            if (webcam) g_uiPtr->GetCameraService().Unsubscribe(webcam);
+            encoder.ReleaseAudioWaiters();
+            encoder.Finish();
+            spool.Discard();
+            micAudio.Cleanup();
+            systemAudio.Cleanup();
+            std::error_code ec;
+            if (!spoolMode) fs::remove(outputPath, ec);
+            if (!proxyPath.empty()) fs::remove(proxyPath, ec);
+            shutdown = (command == Command::Shutdown);
+            rewarm = (command == Command::Prepare);
+            g_engine.SetState(State::Idle);
+            continue;
+        }
+
+        // 3. Recording
+        g_engine.SetState(State::Recording);
+
+        // Sidecar entries are indexed by output frame, so they line up with the forced keyframes
+        // (and, in spool mode, with the frames the transcode will write)
+        std::string indexPath = SeekIndex::PathFor(outputPath);
+        if (session.seekIndexInterval > 0 && !seekIndex.Start(indexPath, fps, session.seekIndexInterval, screenWidth, screenHeight)) {
+            std::cerr << "Failed to create seek index: " << indexPath << std::endl;
+        }
+        idle.Configure(fps, session.idlePauseSeconds);
+        if (session.exportFrames && !frameExport.Open(FrameExport::DefaultName(), screenWidth, screenHeight)) {
+            std::cerr << "Failed to create frame export: " << FrameExport::DefaultName() << std::endl;
+        }
+
+        std::atomic<bool> audioRunning(audioTracks > 0);
+        std::thread audioWorker;
+        if (audioTracks > 0) {
+            auto writeTrack = [&encoder, &spool, spoolMode](int track, const std::vector<float>& samples) {
+                return spoolMode ? spool.WriteAudio(track, samples) : encoder.WriteAudio(track, samples);
+            };
+            audioWorker = std::thread(AudioThread, writeTrack,
+                                      useMic ? &micAudio : nullptr, useSystem ? &systemAudio : nullptr,
+                                      separateTracks, session.idlePauseSeconds > 0 ? &idle : nullptr, std::ref(audioRunning));
+        }
+
+        int frameCount = 0;
+        uint64_t lastSequence = 0;
+        int hashedFrames = 0;
+        long long hashUs = 0;
+        bool webcamComposited = false;
+        bool stopping = false;
+        Frame lastOut;
+
+        // The overlay variant is chosen here and again only when a new settings snapshot is published
+        auto overlayFeatures = [](const Controller::Settings& s) {
+            return OverlayPipeline::Features{ s.roiQuantization, s.showHighlight, s.showCursor };
+        };
+        overlays.Configure(overlayFeatures(session));
+        uint64_t overlayVersion = sessionSnapshot->version;
+        auto startTime = std::chrono::steady_clock::now();
+
+        // `thumb`: the frame already at preview scale, if made; otherwise the index gathers from `frame`
+        // A sink that stops taking frames (disk full, FFmpeg gone) ends the recording; what it
+        // accepted so far is kept
+        bool sinkFailed = false;
+        auto writeFrame = [&](const Frame& frame, const Frame* thumb = nullptr) {
+            if (sinkFailed) return;
+            if (!(spoolMode ? spool.WriteFrame(frame) : encoder.WriteFrame(frame))) {
+                std::cerr << (spoolMode ? "Spool write failed (disk full?)" : "Encoder stopped taking frames")
+                          << " after " << frameCount << " frames; stopping" << std::endl;
+                sinkFailed = true;
+                stopping = true;
+                return;
+            }
+            seekIndex.AddFrame((uint64_t)frameCount, thumb ? *thumb : frame);
+            frameCount++;
+        };
+
+        // Sleeps until `deadline`; a command wakes the wait immediately
+        auto waitUntil = [&](std::chrono::steady_clock::time_point deadline) {
+            while (!stopping && g_engine.WaitCommandUntil(deadline, command)) {
+                if (command == Command::Pause) {
+                    // No capture or encode work at all while paused; the thread just blocks
+                    g_engine.SetState(State::Paused);
+                    do {
+                        command = g_engine.WaitCommand();
+                    } while (command != Command::Resume && command != Command::Stop && command != Command::Shutdown);
+
+                    if (command == Command::Resume) {
+                        // Output timestamps come from the frame count, so re-anchoring the
+                        // schedule keeps the encoded timeline continuous across the pause
+                        startTime = std::chrono::steady_clock::now() - frameDuration * frameCount;
+                        deadline = std::chrono::steady_clock::now();
+                        g_engine.SetState(State::Recording);
+                        continue;
+                    }
+                }
+                if (command == Command::Stop || command == Command::Shutdown) {
+                    stopping = true;
+                    shutdown = (command == Command::Shutdown);
+                }
+            }
+        };
+
+        while (!stopping) {
+            // Newest screen image as a zero-copy view; when nothing changed it is the
+            // previous image again, so the output keeps a steady FPS either way
+            capture.AcquireFrame(screen);
+
+            // No OS damage for a new image (no XDamage, DXGI rect overflow, forced grab):
+            // derive it from tile hashes so the compositor still copies only what changed.
+            // Images with OS damage re-hash just the damaged tiles, so the hashes always
+            // describe the previous image and never an older one.
+            if (screen.sequence != lastSequence) {
+                auto hashStart = std::chrono::steady_clock::now();
+                if (!screen.damage) {
+                    changeMap.Update(screen);
+                    changeMap.ToRects(changeRects);
+                    screen.damage = &changeRects;
+                    hashedFrames++;
+                } else if (screen.sequence == lastSequence + 1) {
+                    changeMap.Refresh(screen, *screen.damage);
+                } else {
+                    // Damage only covers the last step; the skipped images' changes need a full pass
+                    changeMap.Update(screen);
+                    hashedFrames++;
                 }
+                hashUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hashStart).count();
             }
+            bool screenChanged = screen.sequence != lastSequence;
+            lastSequence = screen.sequence;
 
-            // 2. Start Encoder
-            capture.SetRegion(g_currentSettings.customRegion);
-            capture.CaptureFrame(frameBuffer, screenWidth, screenHeight);
-            if (!encoder.Start(outputPath, screenWidth, screenHeight, fps, 
-                          micName, g_currentSettings.useSystemAudio,
-                          g_currentSettings.width, g_currentSettings.height)) {
-                std::cerr << "Failed to start Video Encoder!" << std::endl;
-                g_isRecording = false;
-                if (g_currentSettings.recordAudio) audio.Stop();
-                if (g_currentSettings.useWebcam) webcam.Stop();
-                audio.Cleanup();
-                webcam.Cleanup();
+            // Auto-pause: while idle nothing is composited or encoded and the timeline stands still
+            IdleDetector::Action idleAction = idle.Update(screen, screenChanged, VisualEffects::GetMousePosition());
+            if (idleAction == IdleDetector::Action::Skip) {
+                waitUntil(std::chrono::steady_clock::now() + frameDuration);
                 continue;
             }
+            if (idleAction == IdleDetector::Action::Resume) {
+                // The compositor still holds the last output (the image idling began with): it
+                // stands in for the pre-roll, then the schedule is re-anchored like a manual resume.
+                // A short idle period gets a shorter pre-roll: the audio thread held only that long.
+                for (int i = 0; i < idle.ResumeFrames(); ++i) writeFrame(lastOut);
+                startTime = std::chrono::steady_clock::now() - frameDuration * frameCount;
+            }
 
-            int frameCount = 0;
-            auto startTime = std::chrono::steady_clock::now();
+            // Output = pristine screen + this frame's overlays. Only the capture's damage and
+            // last frame's overlay areas are copied; the encoder's size is fixed for the session.
+            Frame out = compositor.Begin(screen, screenWidth, screenHeight);
+
+            // One snapshot per frame: highlight, cursor and webcam geometry can change live
+            auto snapshot = g_settings.Load();
+            const Controller::Settings& live = snapshot->value;
+
+            // OFFSET mouse position relative to the captured area start
+            POINT mousePos = VisualEffects::GetMousePosition();
+            POINT origin = capture.GetCaptureOrigin();
+            mousePos.x -= origin.x;
+            mousePos.y -= origin.y;
+            if (snapshot->version != overlayVersion) {
+                overlays.Configure(overlayFeatures(live));
+                overlayVersion = snapshot->version;
+            }
 
-            while (g_isRecording) {
-                auto nextFrameTime = startTime + (frameDuration * (frameCount + 1));
+            // ROI, highlight and cursor, in that order
+            overlays.Run(out, OverlayPipeline::Input{ mousePos, screenChanged ? screen.damage : &noDamage }, roiMap, compositor);
 
-                if (g_isPaused) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                    startTime += std::chrono::milliseconds(10);
-                    continue;
+            // Webcam
+            if (webcam) {
+                // PIP resized from the preview: have the camera deliver at the new size
+                int livePipHeight = live.webcamHeight > 0 ? live.webcamHeight : screenHeight / 5;
+                if (livePipHeight != pipHeight) {
+                    pipHeight = livePipHeight;
+                    webcam->SetOutputHeight(pipHeight);
                 }
 
-                // Try to acquire next frame. If it fails (no screen change), 
-                // we'll reuse the previous frameBuffer to maintain steady FPS.
-                int capturedW, capturedH;
-                capture.CaptureFrame(frameBuffer, capturedW, capturedH);
-
-                // Effects
-                if (g_currentSettings.showHighlight || g_currentSettings.showCursor) {
-                    POINT mousePos = VisualEffects::GetMousePosition();
-                    
-                    // OFFSET mouse position relative to the captured area start
-                    POINT origin = capture.GetCaptureOrigin();
-                    mousePos.x -= origin.x;
-                    mousePos.y -= origin.y;
-
-                    if (g_currentSettings.showHighlight) {
-                        bool isClicked = VisualEffects::IsLeftClicked();
-                        VisualEffects::Color color = isClicked ? VisualEffects::Color{255, 0, 0, 150} : VisualEffects::Color{255, 255, 0, 100};
-                        VisualEffects::DrawHighlight(frameBuffer, screenWidth, screenHeight, mousePos, isClicked ? 30 : 25, color);
-                    }
-                    if (g_currentSettings.showCursor) {
-                        VisualEffects::DrawCursor(frameBuffer, screenWidth, screenHeight, mousePos);
+                // Zero-copy view of the newest camera frame, delivered at the PIP size and
+                // blitted in place; only a frame still at an old size (PIP resized) is rescaled
+                WebcamDevice::FrameView webFrame;
+                if (webcam->AcquireFrame(webFrame)) {
+                    webcamOverlay.Update(webFrame.data, webFrame.width, webFrame.height, webFrame.sequence, pipHeight);
+
+                    // Position: Convert screen coordinates to relative capture coordinates
+                    // If customRegion is full screen (0,0,0,0), then left/top are 0.
+                    int startX = live.webcamPos.x - session.customRegion.left;
+                    int startY = live.webcamPos.y - session.customRegion.top;
+                    compositor.AddOverlay(webcamOverlay.Blit(out, startX, startY));
+
+                    if (!webcamComposited) {
+                        webcamComposited = true;
+                        auto firstMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+                        std::cout << "Webcam: first composited frame " << firstMs.count() << " ms after start" << std::endl;
                     }
                 }
+            }
 
-                // Webcam
-                if (g_currentSettings.useWebcam) {
-                    // Dynamic update of webcam position if window is moved
-                    if (g_uiPtr && g_uiPtr->GetWebcamPreviewWindow()) {
-                        RECT rc;
-                        GetWindowRect(g_uiPtr->GetWebcamPreviewWindow(), &rc);
-                        g_currentSettings.webcamPos.x = rc.left;
-                        g_currentSettings.webcamPos.y = rc.top;
-                    }
+            // Throttled thumbnail of the composited frame for the UI and the seek index: the
+            // full-size output is gathered once at preview scale, and both take that copy
+            bool wantPreview = g_uiPtr && g_uiPtr->GetOutputPreview().WantsFrame();
+            bool wantIndex = seekIndex.WantsFrame((uint64_t)frameCount);
+            Frame thumb;
+            if (wantPreview || wantIndex) {
+                thumb = Frame::Wrap(thumbPixels, SeekIndex::kThumbWidth, SeekIndex::ThumbHeight(out.width, out.height));
+                PixelConvert::ConvertScaled(out.data, out.stride, out.width, out.height, out.format,
+                                            thumb.data, thumb.stride, thumb.width, thumb.height);
+                if (wantPreview) g_uiPtr->GetOutputPreview().Submit(thumb.data, thumb.stride, thumb.width, thumb.height);
+            }
 
-                    std::vector<uint8_t> webFrame;
-                    int wW, wH;
-                    if (webcam.GetFrame(webFrame, wW, wH)) {
-                        CompositeWebcam(frameBuffer, screenWidth, screenHeight, webFrame, wW, wH, 
-                                       g_currentSettings.webcamPos, g_currentSettings.customRegion);
-                        if (g_uiPtr) g_uiPtr->SetPreviewFrame(webFrame, wW, wH);
-                    }
-                }
+            writeFrame(out, wantIndex ? &thumb : nullptr);
+            lastOut = out;
 
-                encoder.WriteFrame(frameBuffer);
-                frameCount++;
+            // Local consumers read this in place; the slot only takes what changed since it was written
+            if (frameExport.IsOpen()) {
+                Frame exported = out;
+                exported.damage = compositor.Damage();
+                frameExport.Publish(exported, (uint64_t)frameCount - 1);
+            }
 
-                std::this_thread::sleep_until(nextFrameTime);
+            if (frameCount == 1) {
+                int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                std::cout << "Time to first frame: " << std::fixed << std::setprecision(1)
+                          << (nowUs - g_startRequestedUs.load()) / 1000.0 << " ms ("
+                          << (wasWarm ? "pre-warmed" : "cold start") << ")" << std::endl;
             }
 
-            if (g_currentSettings.recordAudio) audio.Stop();
-            if (g_currentSettings.useWebcam) webcam.Stop();
-            encoder.Finish();
-            audio.Cleanup();
-            webcam.Cleanup();
+            // Pace to the next frame slot
+            waitUntil(startTime + frameDuration * frameCount);
+        }
+
+        // 4. Finalizing
+        g_engine.SetState(State::Finalizing);
+
+        audioRunning = false;
+        encoder.ReleaseAudioWaiters();
+        if (audioWorker.joinable()) audioWorker.join();
+
+        micAudio.Stop();
+        systemAudio.Stop();
+        if (webcam) {
+            WebcamDevice::Stats stats = webcam->GetStats();
+            WebcamOverlay::Stats pip = webcamOverlay.GetStats();
+            std::cout << "Webcam: " << stats.framesPublished << " frames published, "
+                      << stats.framesConsumed << " consumed, "
+                      << stats.framesCopied << " copied; PIP rescaled "
+                      << pip.rescales << "x, used in place " << pip.inPlace << "x for "
+                      << pip.blits << " composited frames" << std::endl;
+
+            // Leaves the camera running if the preview is still subscribed
+            g_uiPtr->GetCameraService().Unsubscribe(webcam);
+        }
+        webcamOverlay.Reset();
+
+        FrameCompositor::Stats comp = compositor.GetStats();
+        if (comp.frameBytes > 0) {
+            std::cout << "Compositing: copied " << std::fixed << std::setprecision(1)
+                      << (100.0 * comp.bytesCopied / comp.frameBytes) << "% of full-frame traffic ("
+                      << comp.fullCopies << " full refreshes in " << comp.frames << " frames)" << std::endl;
+        }
+        compositor.Reset();
+        if (hashUs > 0) {
+            std::cout << "Change map: " << hashedFrames << " frames fully hashed at " << screenWidth << "x" << screenHeight
+                      << ", " << std::fixed << std::setprecision(2) << (hashUs / 1000.0) << " ms in total" << std::endl;
+        }
+        changeMap.Reset();
+        if (!spoolMode && frameCount > 0) {
+            // One encode regardless of the sink count, so this should not grow with more sinks
+            double recordedSeconds = (double)frameCount / fps;
+            std::cout << "Encoder CPU: " << std::fixed << std::setprecision(1)
+                      << (100.0 * encoder.GetEncoderCpuSeconds() / recordedSeconds) << "% of one core, file + "
+                      << session.streamSinks.size() << " stream sink(s)"
+                      << (session.proxyHeight > 0 ? " + " + std::to_string(session.proxyHeight) + "p proxy" : "") << std::endl;
+        }
+        encoder.Finish();
+        micAudio.Cleanup();
+        systemAudio.Cleanup();
+
+        RoiMap::Stats roi = roiMap.GetStats();
+        if (roi.frames > 0) {
+            std::cout << "ROI: " << std::fixed << std::setprecision(1) << (100.0 * roi.focusBlocks / roi.blocks) << "% focus, "
+                      << (100.0 * roi.coarseBlocks / roi.blocks) << "% coarse macroblocks, " << std::setprecision(3)
+                      << (roi.workUs / 1000.0 / roi.frames) << " ms/frame" << std::endl;
+        }
+        roiMap.Reset();
+
+        if (frameExport.IsOpen()) {
+            FrameExport::Stats ex = frameExport.GetStats();
+            frameExport.Close();
+            std::cout << "Frame export: " << ex.published << " frames published, " << ex.skipped << " skipped (no reader), "
+                      << std::fixed << std::setprecision(1) << (ex.frameBytes ? 100.0 * ex.bytes / ex.frameBytes : 0.0)
+                      << "% of full-frame copies, " << std::setprecision(3)
+                      << (ex.published ? ex.publishUs / 1000.0 / ex.published : 0.0) << " ms/frame" << std::endl;
+        }
+
+        IdleDetector::Stats idleStats = idle.GetStats();
+        if (idleStats.idlePeriods > 0) {
+            std::cout << "Auto-pause: " << idleStats.idlePeriods << " idle period(s), " << std::fixed << std::setprecision(1)
+                      << ((double)idleStats.skippedFrames / fps) << " s not encoded (" << frameCount << " frames written)" << std::endl;
+        }
+
+        if (seekIndex.IsOpen()) {
+            seekIndex.Finish();
+            SeekIndex::Stats st = seekIndex.GetStats();
+            std::cout << "Seek index: " << st.entries << " entries, " << std::fixed << std::setprecision(1)
+                      << (st.bytes / 1024.0) << " KB, " << std::setprecision(0)
+                      << (st.entries ? (double)st.workUs / st.entries : 0.0) << " us/entry" << std::endl;
+        }
+
+        if (spoolMode) {
+            spool.Finish();
+            FrameSpool::Stats st = spool.GetStats();
+            if (st.frames > 0) {
+                double minutes = (double)st.frames / fps / 60.0;
+                double writeMs = st.writeUs / 1000.0;
+                std::cout << "Spool: " << st.frames << " frames (" << st.keyFrames << " key, " << st.deltaFrames
+                          << " delta, " << st.repeatFrames << " repeat), " << std::fixed << std::setprecision(1)
+                          << (st.bytesWritten / 1048576.0 / minutes) << " MB/min vs "
+                          << (st.rawBytes / 1048576.0 / minutes) << " MB/min raw; write "
+                          << std::setprecision(2) << (writeMs / st.frames) << " ms/frame ("
+                          << std::setprecision(0) << (writeMs > 0 ? st.bytesWritten / 1048.576 / writeMs : 0.0) << " MB/s)" << std::endl;
+            }
+            StartTranscode(spoolPath);
+            std::cout << "\nRecording spooled; encoding in the background." << std::endl;
+        } else {
             std::cout << "\nRecording saved." << std::endl;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (sinkFailed && g_uiPtr) {
+            std::ostringstream message;
+            message << (spoolMode ? "Could not write to the spool file (is the disk full?)."
+                                  : "The encoder stopped accepting frames.") << "\n\n";
+            if (frameCount > 0) {
+                message << "The first " << std::fixed << std::setprecision(1) << ((double)frameCount / fps)
+                        << " s of the recording were kept.";
+            } else {
+                message << "Nothing was recorded.";
+            }
+            g_uiPtr->NotifyRecordingFailed(message.str());
+        }
+
+        g_engine.SetState(State::Idle);
     }
     capture.Cleanup();
+    CoUninitialize();
 }
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nShowCmd) {
     Controller ui;
     g_uiPtr = &ui;
 
+    ui.SetOnPrepareCallback([&ui]() {
+        g_settings.Publish(ui.GetSettings());
+        g_saveDirectory = ui.GetSavePath();
+        g_engine.Post(EngineControl::Command::Prepare);
+    });
+
     ui.SetOnStartCallback([&ui]() {
-        g_currentSettings = ui.GetSettings();
+        // The session settings match the last Prepare (the UI re-prepares when they change);
+        // this publishes the rest as they are at the click
+        g_settings.Publish(ui.GetSettings());
         g_saveDirectory = ui.GetSavePath();
-        g_isRecording = true;
+        g_startRequestedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        g_engine.Post(EngineControl::Command::Start);
+    });
+
+    ui.SetOnSettingsChangedCallback([](const Controller::Settings& settings) {
+        g_settings.Publish(settings);
     });
 
     ui.SetOnStopCallback([]() {
-        g_isRecording = false;
-        g_isPaused = false;
+        g_engine.Post(EngineControl::Command::Stop);
     });
 
     ui.SetOnPauseCallback([](bool paused) {
-        g_isPaused = paused;
+        g_engine.Post(paused ? EngineControl::Command::Pause : EngineControl::Command::Resume);
         return true;
     });
 
+    // Resolve FFmpeg once up front instead of on every Start
+    VideoEncoder::Prewarm();
+
+    // Spools left over from a previous run (exit or crash before the transcode finished)
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(ui.GetSavePath(), ec)) {
+        if (entry.path().extension() == ".spool") StartTranscode(entry.path().string());
+    }
+
     std::thread engine(RecordingThread);
 
     if (!ui.Create()) {
         std::cerr << "Failed to create UI!" << std::endl;
-        g_shouldExit = true;
+        g_engine.Post(EngineControl::Command::Shutdown);
         engine.join();
+        StopTranscodes();
         return -1;
     }
 
     ui.Run();
 
-    g_shouldExit = true;
-    g_isRecording = false;
+    // Finalizes a recording still in progress (which may queue its transcode), then exits
+    g_engine.Post(EngineControl::Command::Shutdown);
     engine.join();
+    StopTranscodes();
 
     return 0;
 }
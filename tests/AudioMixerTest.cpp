@@ -0,0 +1,154 @@
+// AudioResampler and AudioMixer on known signals. A 1 kHz sine at 44.1 kHz resampled to 48 kHz
+// must come out as a 1 kHz sine of the same amplitude (fitted at 1 kHz, with a small residual
+// left after subtracting the fit). The mixer must sum its sources with their gains, clamp
+// the sum to [-1, 1], duplicate mono to both channels and pad an underrun with silence.
+#include "AudioMixer.hpp"
+#include "Check.hpp"
+#include <cmath>
+#include <vector>
+
+static const double kPi = 3.14159265358979323846;
+
+// Amplitude of the `hz` component of `signal` (one channel of `channels`, from `skip` frames
+// on) and the RMS left after subtracting that sine; `frames` should hold whole cycles
+static void FitSine(const std::vector<float>& signal, int channels, int channel, size_t skip, size_t frames,
+                    double rate, double hz, double& amplitude, double& residual) {
+    double i = 0.0, q = 0.0;
+    for (size_t n = 0; n < frames; ++n) {
+        double v = signal[(skip + n) * channels + channel];
+        double w = 2.0 * kPi * hz * (double)(skip + n) / rate;
+        i += v * std::cos(w);
+        q += v * std::sin(w);
+    }
+    i *= 2.0 / frames;
+    q *= 2.0 / frames;
+    amplitude = std::sqrt(i * i + q * q);
+    double sum = 0.0;
+    for (size_t n = 0; n < frames; ++n) {
+        double w = 2.0 * kPi * hz * (double)(skip + n) / rate;
+        double e = signal[(skip + n) * channels + channel] - (i * std::cos(w) + q * std::sin(w));
+        sum += e * e;
+    }
+    residual = std::sqrt(sum / frames);
+}
+
+static std::vector<float> Sine(double rate, double hz, float amplitude, size_t frames, int channels) {
+    std::vector<float> out(frames * channels);
+    for (size_t n = 0; n < frames; ++n) {
+        for (int c = 0; c < channels; ++c) out[n * channels + c] = amplitude * (float)std::sin(2.0 * kPi * hz * n / rate);
+    }
+    return out;
+}
+
+static std::vector<float> Constant(float value, size_t frames, int channels) {
+    return std::vector<float>(frames * channels, value);
+}
+
+int main() {
+    // Resampler: one second of 44.1 kHz mono in 10 ms chunks, as a capture device hands it over
+    {
+        AudioResampler resampler;
+        CHECK(resampler.Configure(44100, 48000, 1));
+        CHECK(!resampler.IsPassthrough());
+        std::vector<float> in = Sine(44100.0, 1000.0, 0.5f, 44100, 1);
+        std::vector<float> out;
+        for (size_t at = 0; at < in.size(); at += 441) resampler.Process(in.data() + at, 441, out);
+        CHECK(out.size() > 48000 - 64 && out.size() <= 48000); // Less only the filter's delay
+
+        // The filter delay is a fixed time offset, which the fit absorbs as phase
+        double amplitude, residual;
+        FitSine(out, 1, 0, 480, 48000 - 960, 48000.0, 1000.0, amplitude, residual);
+        std::printf("44.1 -> 48 kHz: 1 kHz amplitude %.5f, residual %.2e\n", amplitude, residual);
+        CHECK(std::fabs(amplitude - 0.5) < 0.005);
+        CHECK(residual < 1e-3);
+
+        // Same rate in and out is a plain copy
+        AudioResampler same;
+        CHECK(same.Configure(48000, 48000, 2) && same.IsPassthrough());
+        std::vector<float> stereo = Sine(48000.0, 440.0, 0.25f, 480, 2), copy;
+        same.Process(stereo.data(), 480, copy);
+        CHECK(copy == stereo);
+    }
+
+    std::vector<float> out;
+
+    // Sum with gains, then clamping at full scale in both directions
+    {
+        AudioMixer mixer;
+        int a = mixer.AddSource(48000, 2);
+        int b = mixer.AddSource(48000, 2, 0.5f);
+        std::vector<float> x = Constant(0.25f, 480, 2), y = Constant(0.5f, 480, 2);
+        mixer.PushSamples(a, x.data(), 480);
+        mixer.PushSamples(b, y.data(), 480);
+        mixer.Mix(480, out);
+        CHECK(out.size() == 960);
+        for (float v : out) CHECK(v == 0.5f);
+
+        mixer.SetGain(b, 1.0f);
+        x = Constant(0.8f, 480, 2);
+        y = Constant(0.7f, 480, 2);
+        mixer.PushSamples(a, x.data(), 480);
+        mixer.PushSamples(b, y.data(), 480);
+        mixer.Mix(480, out);
+        for (float v : out) CHECK(v == 1.0f);
+
+        x = Constant(-0.9f, 480, 2);
+        y = Constant(-0.6f, 480, 2);
+        mixer.PushSamples(a, x.data(), 480);
+        mixer.PushSamples(b, y.data(), 480);
+        mixer.Mix(480, out);
+        for (float v : out) CHECK(v == -1.0f);
+
+        // One source on its own track: its gain applies and it clamps too
+        mixer.SetGain(a, 2.0f);
+        x = Constant(0.3f, 480, 2);
+        mixer.PushSamples(a, x.data(), 480);
+        mixer.ReadSource(a, 240, out);
+        for (float v : out) CHECK(v == 0.6f);
+        x = Constant(0.75f, 240, 2);
+        mixer.PushSamples(a, x.data(), 240);
+        mixer.ReadSource(a, 480, out);
+        for (size_t i = 0; i < out.size(); ++i) CHECK(out[i] == (i < 480 ? 0.6f : 1.0f));
+    }
+
+    // Mono is duplicated to both channels; an underrun is padded with silence
+    {
+        AudioMixer mixer;
+        int mono = mixer.AddSource(48000, 1);
+        std::vector<float> ramp(300);
+        for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = (float)i / 1000.0f;
+        mixer.PushSamples(mono, ramp.data(), ramp.size());
+        mixer.Mix(400, out);
+        CHECK(out.size() == 800);
+        for (size_t n = 0; n < 400; ++n) {
+            float expected = n < 300 ? ramp[n] : 0.0f;
+            CHECK(out[n * 2] == expected && out[n * 2 + 1] == expected);
+        }
+    }
+
+    // A 44.1 kHz mic and a 48 kHz system source mixed: both tones at their own level
+    {
+        AudioMixer mixer;
+        int mic = mixer.AddSource(44100, 1, 0.5f);
+        int system = mixer.AddSource(48000, 2);
+        std::vector<float> voice = Sine(44100.0, 500.0, 0.6f, 44100, 1);
+        std::vector<float> music = Sine(48000.0, 3000.0, 0.2f, 48000, 2);
+        std::vector<float> track;
+        for (int chunk = 0; chunk < 100; ++chunk) {
+            mixer.PushSamples(mic, voice.data() + chunk * 441, 441);
+            mixer.PushSamples(system, music.data() + chunk * 960, 480);
+            mixer.Mix(480, out);
+            track.insert(track.end(), out.begin(), out.end());
+        }
+        // The mic lags by the filter delay, and the first chunks hold less than 10 ms of it; skip those
+        double voiceAmp, musicAmp, residual;
+        FitSine(track, 2, 0, 4800, 38400, 48000.0, 500.0, voiceAmp, residual);
+        FitSine(track, 2, 1, 4800, 38400, 48000.0, 3000.0, musicAmp, residual);
+        std::printf("mix: 500 Hz mic %.4f (0.3 expected), 3 kHz system %.4f (0.2 expected)\n", voiceAmp, musicAmp);
+        CHECK(std::fabs(voiceAmp - 0.3) < 0.005);
+        CHECK(std::fabs(musicAmp - 0.2) < 0.005);
+    }
+
+    std::printf("ok\n");
+    return 0;
+}
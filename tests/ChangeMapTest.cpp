@@ -0,0 +1,106 @@
+// ChangeMap must see every real change: single pixels anywhere in a tile, changes crafted to
+// cancel in plain weighted sums, pixels swapped between rows, and edge tiles. Refresh() must
+// keep the baseline on the latest frame so a later Update() diffs against it.
+#include "ChangeMap.hpp"
+#include "Check.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng(99);
+
+static uint32_t Get(const Frame& f, int x, int y) {
+    uint32_t v;
+    std::memcpy(&v, f.Pixel(x, y), 4);
+    return v;
+}
+
+static void Set(const Frame& f, int x, int y, uint32_t v) {
+    std::memcpy(f.Pixel(x, y), &v, 4);
+}
+
+// Applies `edit`, checks the tile at (x, y) is reported (and nothing else), then undoes it
+template <typename Edit>
+static void ExpectChanged(ChangeMap& map, const Frame& f, int x, int y, Edit edit) {
+    std::vector<uint8_t> before(f.data, f.data + (size_t)f.stride * f.height);
+    edit();
+    map.Update(f);
+    CHECK(map.ChangedCount() == 1);
+    CHECK(map.IsChanged(x / ChangeMap::kTileSize, y / ChangeMap::kTileSize));
+    std::memcpy(f.data, before.data(), before.size());
+    map.Update(f);
+    CHECK(map.ChangedCount() == 1);
+}
+
+int main() {
+    // 100x50: the last tile column is 4 px wide and the last tile row 2 px tall
+    std::vector<uint8_t> pixels;
+    Frame f = Frame::Wrap(pixels, 100, 50);
+    for (uint8_t& b : pixels) b = (uint8_t)rng();
+
+    ChangeMap map;
+    map.Update(f);
+    CHECK(map.ChangedCount() == (size_t)map.TilesX() * map.TilesY());
+    map.Update(f);
+    CHECK(map.ChangedCount() == 0);
+
+    // Blue +3 at (0,5) and -1 at (4,5): cancels in the column-weighted sums (weights 1 and 3)
+    ExpectChanged(map, f, 0, 5, [&] {
+        Set(f, 0, 5, Get(f, 0, 5) + 3);
+        Set(f, 4, 5, Get(f, 4, 5) - 1);
+    });
+
+    // (+d, -2d, +d) down a column: cancels in both Fletcher sums
+    ExpectChanged(map, f, 20, 17, [&] {
+        Set(f, 20, 17, Get(f, 20, 17) + 0x10);
+        Set(f, 20, 18, Get(f, 20, 18) - 0x20);
+        Set(f, 20, 19, Get(f, 20, 19) + 0x10);
+    });
+
+    // Two pixels of a column swapped 8 rows apart, with a difference s2 loses (2^29 * 8 = 2^32)
+    ExpectChanged(map, f, 37, 32, [&] {
+        Set(f, 37, 32, 0x20000000u);
+        Set(f, 37, 40, 0x00000000u);
+        map.Update(f);
+        Set(f, 37, 32, 0x00000000u);
+        Set(f, 37, 40, 0x20000000u);
+    });
+
+    // Every single-pixel change, at every position of a full and a clipped tile
+    for (int y = 0; y < 50; ++y) {
+        for (int x : { 16, 17, 23, 31, 96, 99 }) {
+            ExpectChanged(map, f, x, y, [&] { Set(f, x, y, Get(f, x, y) ^ (1u << (rng() % 32))); });
+        }
+    }
+
+    // Random offsetting pairs and triples inside one tile
+    for (int trial = 0; trial < 20000; ++trial) {
+        int tx = (int)(rng() % 6) * 16, ty = (int)(rng() % 3) * 16;
+        int d = (int)(rng() % 7) + 1;
+        int x0 = tx + (int)(rng() % 16), y0 = ty + (int)(rng() % 16);
+        int x1 = tx + (int)(rng() % 16), y1 = ty + (int)(rng() % 16);
+        if (x0 == x1 && y0 == y1) continue;
+        ExpectChanged(map, f, x0, y0, [&] {
+            Set(f, x0, y0, Get(f, x0, y0) + d);
+            Set(f, x1, y1, Get(f, x1, y1) - d);
+        });
+    }
+
+    // Stale baseline: a caret switched off on a frame with OS damage (Refresh) and back on
+    // on a frame without it (Update) must still show up as a change
+    Set(f, 50, 20, 0xFF000000u);
+    map.Update(f);
+    Set(f, 50, 20, 0xFFFFFFFFu);
+    map.Refresh(f, { FrameRect{ 48, 16, 4, 8 } });
+    CHECK(map.ChangedCount() == 1);
+    Set(f, 50, 20, 0xFF000000u);
+    map.Update(f);
+    CHECK(map.ChangedCount() == 1 && map.IsChanged(3, 1));
+
+    std::vector<FrameRect> rects;
+    map.ToRects(rects);
+    CHECK(rects.size() == 1 && rects[0].x == 48 && rects[0].y == 16 && rects[0].width == 16);
+
+    std::printf("ok\n");
+    return 0;
+}
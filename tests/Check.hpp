@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal assertions for the test executables: the first failure is reported and ends the test
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                                            \
+        }                                                                            \
+    } while (0)
+
+// Exit code ctest reports as "skipped" (SKIP_RETURN_CODE in tests/CMakeLists.txt)
+constexpr int kSkipped = 77;
@@ -0,0 +1,194 @@
+// ClipEditor: cut planning against a keyframe list, then trims and splits of a generated clip
+// (6 s, 30 FPS, a keyframe every second, AAC audio). Every output is fully decoded with
+// -xerror and must keep the audio stream. Its frame count is checked. Copied frames must
+// decode to the same CRCs as the source. The re-encoded head of an exact cut can't match
+// bit for bit, so its first frame must be closest to the source frame at the cut time and
+// not to either neighbour. The clip part needs FFmpeg with libx264 ($FFMPEG, or ffmpeg on
+// PATH) and is skipped without it.
+#include "ClipEditor.hpp"
+#include "Check.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+static const char* kNull = "NUL";
+static const char* kBinary = "b";
+#else
+static const char* kNull = "/dev/null";
+static const char* kBinary = "";
+#endif
+
+namespace fs = std::filesystem;
+
+static bool Near(double a, double b) { return std::fabs(a - b) < 1e-6; }
+
+static void CheckPlans() {
+    std::vector<double> keys = { 0.0, 2.0, 4.0, 6.0 };
+
+    // Copy cuts start on the keyframe at or before the start
+    ClipEditor::CutPlan p = ClipEditor::Plan(keys, 3.0, 5.0, false);
+    CHECK(Near(p.copyStart, 2.0) && !p.reencodeHead && !p.reencodeAll);
+    p = ClipEditor::Plan(keys, 4.0, -1.0, false);
+    CHECK(Near(p.copyStart, 4.0));
+    p = ClipEditor::Plan(keys, 4.0004, -1.0, true); // Within the tolerance: on the keyframe
+    CHECK(Near(p.copyStart, 4.0) && !p.reencodeHead);
+
+    // Exact: re-encode up to the next keyframe, or everything if none comes before the end
+    p = ClipEditor::Plan(keys, 3.0, 5.0, true);
+    CHECK(p.reencodeHead && Near(p.copyStart, 4.0));
+    p = ClipEditor::Plan(keys, 2.5, 3.5, true);
+    CHECK(p.reencodeAll && Near(p.copyStart, 2.5));
+    p = ClipEditor::Plan(keys, 6.5, -1.0, true);
+    CHECK(p.reencodeAll);
+    p = ClipEditor::Plan(keys, 0.0, 1.0, true);
+    CHECK(Near(p.copyStart, 0.0) && !p.reencodeHead && !p.reencodeAll);
+}
+
+static std::string Quote(const std::string& s) { return "\"" + s + "\""; }
+
+// Video frames in `file`, from a packet listing (nothing decoded); -1 on failure
+static int CountFrames(const std::string& ffmpeg, const std::string& file) {
+    std::string cmd = Quote(ffmpeg) + " -v error -nostdin -i " + Quote(file) + " -map 0:v:0 -c copy -f framecrc -";
+    std::FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) return -1;
+    int frames = 0;
+    char line[512];
+    while (std::fgets(line, sizeof(line), pipe)) {
+        if (line[0] != '#' && line[0] != '\n') frames++;
+    }
+    return pclose(pipe) == 0 ? frames : -1;
+}
+
+// CRC of every decoded video frame in `file`; empty if any packet fails to decode (-xerror)
+static std::vector<std::string> DecodedCrcs(const std::string& ffmpeg, const std::string& file) {
+    std::string cmd = Quote(ffmpeg) + " -v error -nostdin -xerror -i " + Quote(file) + " -map 0:v:0 -f framecrc -";
+    std::vector<std::string> crcs;
+    std::FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) return crcs;
+    char line[512];
+    while (std::fgets(line, sizeof(line), pipe)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        std::string text(line);
+        size_t comma = text.find_last_of(',');
+        if (comma != std::string::npos) crcs.push_back(text.substr(comma + 1, text.find_last_not_of(" \r\n") - comma));
+    }
+    if (pclose(pipe) != 0) crcs.clear();
+    return crcs;
+}
+
+static std::vector<std::string> Slice(const std::vector<std::string>& v, size_t from, size_t to) {
+    return to <= v.size() && from <= to ? std::vector<std::string>(v.begin() + from, v.begin() + to) : std::vector<std::string>();
+}
+
+// Luma of video frames [first, first + count) of `file`, decoded
+static std::vector<uint8_t> Luma(const std::string& ffmpeg, const std::string& file, int first, int count) {
+    std::string cmd = Quote(ffmpeg) + " -v error -nostdin -i " + Quote(file) + " -map 0:v:0 -vf \"select=between(n\\," +
+                      std::to_string(first) + "\\," + std::to_string(first + count - 1) + ")\" -fps_mode passthrough"
+                      " -pix_fmt gray -f rawvideo -";
+    std::vector<uint8_t> pixels;
+    std::FILE* pipe = popen(cmd.c_str(), (std::string("r") + kBinary).c_str());
+    if (!pipe) return pixels;
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0) pixels.insert(pixels.end(), buffer, buffer + n);
+    pclose(pipe);
+    return pixels;
+}
+
+// Mean absolute luma difference between two frames of `size` bytes
+static double Distance(const uint8_t* a, const uint8_t* b, size_t size) {
+    double sum = 0.0;
+    for (size_t i = 0; i < size; ++i) sum += std::abs(a[i] - b[i]);
+    return sum / size;
+}
+
+// The first frame of an exact cut at source frame `frame` is nearest that frame, not its neighbours
+static bool StartsAt(const std::string& ffmpeg, const std::string& clip, const std::string& cut, int frame) {
+    const size_t size = 320 * 180;
+    std::vector<uint8_t> first = Luma(ffmpeg, cut, 0, 1), source = Luma(ffmpeg, clip, frame - 1, 3);
+    if (first.size() != size || source.size() != 3 * size) return false;
+    double before = Distance(first.data(), source.data(), size);
+    double at = Distance(first.data(), source.data() + size, size);
+    double after = Distance(first.data(), source.data() + 2 * size, size);
+    std::printf("%s: first frame %.2f from source frame %d (%.2f, %.2f from its neighbours)\n",
+                fs::path(cut).filename().string().c_str(), at, frame, before, after);
+    return at < 2.0 && at < before && at < after;
+}
+
+static bool HasAudio(const std::string& ffmpeg, const std::string& file) {
+    std::string cmd = Quote(ffmpeg) + " -v quiet -nostdin -i " + Quote(file) + " -map 0:a:0 -c copy -f null - > " + kNull + " 2>&1";
+    return std::system(cmd.c_str()) == 0;
+}
+
+int main() {
+    CheckPlans();
+
+    const char* env = std::getenv("FFMPEG");
+    std::string ffmpeg = env && *env ? env : "ffmpeg";
+    if (std::system((Quote(ffmpeg) + " -v quiet -hide_banner -h encoder=libx264 > " + kNull + " 2>&1").c_str()) != 0) {
+        std::printf("Plans ok; no FFmpeg with libx264, clip checks skipped\n");
+        return kSkipped;
+    }
+
+    fs::path dir = fs::temp_directory_path() / ("ssr_clip_test_" + std::to_string(std::rand()));
+    fs::create_directories(dir);
+    std::string clip = (dir / "clip.mp4").string();
+    std::string make = Quote(ffmpeg) + " -v error -nostdin -f lavfi -i testsrc2=size=320x180:rate=30 "
+                       "-f lavfi -i sine=frequency=440:sample_rate=48000 -t 6 "
+                       "-c:v libx264 -preset ultrafast -g 30 -keyint_min 30 -sc_threshold 0 -pix_fmt yuv420p "
+                       "-c:a aac -b:a 96k -y " + Quote(clip);
+    CHECK(std::system(make.c_str()) == 0);
+    CHECK(CountFrames(ffmpeg, clip) == 180);
+
+    ClipEditor editor(ffmpeg);
+    std::vector<double> keys;
+    double frameDuration = 0.0;
+    CHECK(editor.ListKeyframes(clip, keys, &frameDuration));
+    CHECK(keys.size() == 6 && Near(keys[2], 2.0));
+    CHECK(std::fabs(frameDuration - 1.0 / 30) < 1e-4);
+
+    auto out = [&](const char* name) { return (dir / name).string(); };
+    std::vector<std::string> source = DecodedCrcs(ffmpeg, clip);
+    CHECK(source.size() == 180);
+
+    // Copy trim from 2.5 s: starts on the 2 s keyframe
+    CHECK(editor.Trim(clip, out("trim.mp4"), 2.5, 4.5, false));
+    CHECK(CountFrames(ffmpeg, out("trim.mp4")) == 75);
+    CHECK(DecodedCrcs(ffmpeg, out("trim.mp4")) == Slice(source, 60, 135));
+    CHECK(HasAudio(ffmpeg, out("trim.mp4")));
+    // Exact trim: exactly 2.5 s to 4.5 s; re-encoded up to the 4 s keyframe, copied after it
+    CHECK(editor.Trim(clip, out("trim_exact.mp4"), 2.5, 4.5, true));
+    CHECK(CountFrames(ffmpeg, out("trim_exact.mp4")) == 60);
+    std::vector<std::string> exact = DecodedCrcs(ffmpeg, out("trim_exact.mp4"));
+    CHECK(exact.size() == 60 && Slice(exact, 45, 60) == Slice(source, 120, 135));
+    CHECK(StartsAt(ffmpeg, clip, out("trim_exact.mp4"), 75));
+    CHECK(HasAudio(ffmpeg, out("trim_exact.mp4")));
+
+    // Copy split at 2.5 s cuts both parts on the 2 s keyframe: no frame in both
+    CHECK(editor.Split(clip, 2.5, out("a.mp4"), out("b.mp4"), false));
+    CHECK(CountFrames(ffmpeg, out("a.mp4")) == 60);
+    CHECK(CountFrames(ffmpeg, out("b.mp4")) == 120);
+    CHECK(DecodedCrcs(ffmpeg, out("a.mp4")) == Slice(source, 0, 60));
+    CHECK(DecodedCrcs(ffmpeg, out("b.mp4")) == Slice(source, 60, 180));
+    // Exact split: 75 + 105
+    CHECK(editor.Split(clip, 2.5, out("c.mp4"), out("d.mp4"), true));
+    CHECK(CountFrames(ffmpeg, out("c.mp4")) == 75);
+    CHECK(CountFrames(ffmpeg, out("d.mp4")) == 105);
+    CHECK(DecodedCrcs(ffmpeg, out("c.mp4")) == Slice(source, 0, 75));
+    std::vector<std::string> second = DecodedCrcs(ffmpeg, out("d.mp4"));
+    CHECK(second.size() == 105 && Slice(second, 45, 105) == Slice(source, 120, 180));
+    CHECK(StartsAt(ffmpeg, clip, out("d.mp4"), 75));
+    for (const char* name : { "a.mp4", "b.mp4", "c.mp4", "d.mp4" }) CHECK(HasAudio(ffmpeg, out(name)));
+
+    // No keyframe after the start before the split point
+    CHECK(!editor.Split(clip, 0.5, out("e.mp4"), out("f.mp4"), false));
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    std::printf("ok\n");
+    return 0;
+}
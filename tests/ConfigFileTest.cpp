@@ -0,0 +1,63 @@
+// ConfigFile parsing: comments, whitespace, repeated keys, typed getters with fallbacks, and
+// warnings (not failures) for malformed lines and mistyped values.
+#include "ConfigFile.hpp"
+#include "Check.hpp"
+
+int main() {
+    ConfigFile config;
+    config.Parse(
+        "# Simple Screen Recorder settings\n"
+        "spool_recording = yes\n"
+        "\n"
+        "  count=12   # trailing comment\r\n"
+        "stream = udp://127.0.0.1:5000\n"
+        "stream = udp://127.0.0.1:5001\n"
+        "name = first\n"
+        "name = second\n"
+        "this line has no equals sign\n"
+        "= no key\n"
+        "flag = maybe\n"
+        "size = 12px\n"
+        "gain = 0.5\n"
+        "loud = very\n"
+        "empty =\n");
+
+    CHECK(config.GetBool("spool_recording", false));
+    CHECK(config.GetInt("count", 0) == 12);
+    CHECK(config.GetString("name") == "second");
+    CHECK(config.Has("empty") && config.GetString("empty", "x").empty());
+    CHECK(!config.Has("missing"));
+    CHECK(config.GetInt("missing", 7) == 7);
+    CHECK(config.GetFloat("gain", 1.0f) == 0.5f);
+    CHECK(config.GetFloat("count", 0.0f) == 12.0f);
+    CHECK(config.GetFloat("missing", 2.0f) == 2.0f);
+
+    auto streams = config.GetAll("stream");
+    CHECK(streams.size() == 2 && streams[0] == "udp://127.0.0.1:5000" && streams[1] == "udp://127.0.0.1:5001");
+    CHECK(config.GetAll("missing").empty());
+
+    CHECK(config.Warnings().size() == 2); // The two malformed lines
+    CHECK(config.GetBool("flag", true) == true);
+    CHECK(config.GetInt("size", 3) == 3);
+    CHECK(config.GetInt("empty", 4) == 4);
+    CHECK(config.GetFloat("loud", 1.5f) == 1.5f);
+    CHECK(config.GetFloat("empty", 2.5f) == 2.5f);
+    CHECK(config.Warnings().size() == 7);
+
+    for (const char* v : { "true", "on", "1", "yes" }) {
+        ConfigFile c;
+        c.Parse(std::string("b = ") + v);
+        CHECK(c.GetBool("b", false));
+    }
+    for (const char* v : { "false", "off", "0", "no" }) {
+        ConfigFile c;
+        c.Parse(std::string("b = ") + v);
+        CHECK(!c.GetBool("b", true));
+    }
+
+    ConfigFile missing;
+    CHECK(!missing.Load("/nonexistent/settings.ini"));
+
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+// FrameCompositor against a randomized screen: a strided capture image that changes only inside
+// the damage it reports, with overlays drawn into the output every frame. After Begin() the
+// output must equal the pristine screen everywhere (last frame's overlays fully removed), and
+// Damage() must cover every pixel that differs from the previous output. Also covers unknown
+// damage, skipped sequences, repeated sequences, a screen of the wrong size and a resize.
+#include "FrameCompositor.hpp"
+#include "Check.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng(37);
+
+static int Rand(int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); }
+
+static FrameRect RandomRect(int width, int height, int maxSide) {
+    int w = Rand(1, maxSide), h = Rand(1, maxSide);
+    return { Rand(-w / 2, width - w / 2), Rand(-h / 2, height - h / 2), w, h }; // May stick out
+}
+
+static void Fill(const Frame& frame, const FrameRect& rect, uint32_t color) {
+    FrameRect r = rect.Intersect(frame.Bounds());
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        uint32_t* row = (uint32_t*)frame.Pixel(r.x, y);
+        for (int x = 0; x < r.width; ++x) row[x] = color;
+    }
+}
+
+static bool Inside(const std::vector<FrameRect>& rects, int x, int y) {
+    for (const FrameRect& r : rects) {
+        if (x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height) return true;
+    }
+    return false;
+}
+
+// Strided screen image (row padding filled with garbage the compositor must never copy)
+struct Screen {
+    std::vector<uint8_t> pixels;
+    Frame frame;
+    std::vector<FrameRect> damage;
+
+    void Resize(int width, int height) {
+        int stride = width * 4 + 64;
+        pixels.assign((size_t)stride * height, 0xAB);
+        frame.data = pixels.data();
+        frame.stride = stride;
+        frame.width = width;
+        frame.height = height;
+        for (int y = 0; y < height; ++y) {
+            uint32_t* row = (uint32_t*)frame.Row(y);
+            for (int x = 0; x < width; ++x) row[x] = (uint32_t)rng();
+        }
+    }
+};
+
+int main() {
+    FrameCompositor compositor;
+    Screen screen;
+    int width = 317, height = 203;
+    screen.Resize(width, height);
+    screen.frame.sequence = 1;
+
+    std::vector<uint8_t> previous;
+    uint64_t fullRefreshes = 0;
+    for (int f = 0; f < 500; ++f) {
+        // Screen update: a few damaged rects, now and then unknown damage, a skipped
+        // sequence, no change at all, or a different size
+        int event = Rand(0, 99);
+        bool resized = false;
+        if (f > 0 && event < 2) {
+            width = Rand(200, 340);
+            height = Rand(150, 220);
+            screen.Resize(width, height);
+            screen.frame.sequence++;
+            screen.frame.damage = nullptr;
+            resized = true;
+        } else if (f > 0 && event < 80) {
+            screen.damage.clear();
+            for (int i = Rand(1, 4); i > 0; --i) {
+                FrameRect r = RandomRect(width, height, 60);
+                Fill(screen.frame, r, (uint32_t)rng());
+                screen.damage.push_back(r);
+            }
+            bool unknown = event < 6;
+            bool skipped = event >= 6 && event < 10;
+            screen.frame.sequence += skipped ? 2 : 1;
+            screen.frame.damage = unknown ? nullptr : &screen.damage;
+            fullRefreshes += unknown || skipped;
+        } // Otherwise the same sequence again
+
+        // A screen of another size is ignored: the output keeps the last good image
+        if (f > 0 && Rand(0, 99) < 3) {
+            std::vector<uint8_t> other;
+            Frame wrong = Frame::Wrap(other, width + 8, height);
+            wrong.sequence = screen.frame.sequence + 100;
+            Frame out = compositor.Begin(wrong, width, height);
+            CHECK(out.width == width && out.height == height);
+        }
+
+        Frame out = compositor.Begin(screen.frame, width, height);
+        CHECK(out.width == width && out.height == height);
+        for (int y = 0; y < height; ++y) {
+            CHECK(std::memcmp(out.Row(y), screen.frame.Row(y), (size_t)width * 4) == 0);
+        }
+
+        // This frame's overlays (cursor, highlight, PIP)
+        for (int i = Rand(0, 3); i > 0; --i) {
+            FrameRect r = RandomRect(width, height, 48);
+            Fill(out, r, 0xFF00FF00u | (uint32_t)i);
+            compositor.AddOverlay(r.Intersect(out.Bounds()));
+        }
+
+        // Every pixel that differs from the previous output lies in the reported damage
+        const std::vector<FrameRect>* damage = compositor.Damage();
+        if (damage && !resized && f > 0) {
+            for (int y = 0; y < height; ++y) {
+                const uint32_t* now = (const uint32_t*)out.Row(y);
+                const uint32_t* before = (const uint32_t*)(previous.data() + (size_t)y * width * 4);
+                for (int x = 0; x < width; ++x) CHECK(now[x] == before[x] || Inside(*damage, x, y));
+            }
+        }
+        previous.assign(out.data, out.data + (size_t)width * height * 4);
+    }
+
+    FrameCompositor::Stats st = compositor.GetStats();
+    std::printf("%llu frames, %llu full copies, %.1f%% of full-copy traffic\n", (unsigned long long)st.frames,
+                (unsigned long long)st.fullCopies, 100.0 * st.bytesCopied / st.frameBytes);
+    CHECK(st.fullCopies >= fullRefreshes);
+    CHECK(st.bytesCopied < st.frameBytes / 4); // Damage and overlay areas only, mostly
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+// FrameExport under load, writer and reader in separate processes over POSIX shm. The writer
+// publishes frames whose content follows from the frame number (one band of rows rewritten per
+// frame, so slots are mostly brought up to date from damage, with a full frame now and then).
+// The reader checks every frame it reads:
+// - Tearing: a frame that Valid() accepts must match its frame number exactly.
+// - Lap detection: after a deliberate stall, a frame the writer has since overwritten
+//   must be rejected by Valid().
+#include "FrameExport.hpp"
+#include "Check.hpp"
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static constexpr int kWidth = 640;
+static constexpr int kHeight = 360;
+static constexpr int kBands = 12; // 30 rows each
+static constexpr int kBandRows = kHeight / kBands;
+static constexpr uint64_t kFrames = 30000;
+
+// Band b of frame n holds the number (plus one) of the latest frame m <= n that rewrote it
+static uint32_t Expected(uint64_t n, int band) {
+    if (n < (uint64_t)band) return 0;
+    return (uint32_t)(n - (n - band) % kBands) + 1;
+}
+
+#ifndef _WIN32
+static int RunReader(const std::string& name) {
+    FrameExportReader reader;
+    for (int i = 0; i < 1000 && !reader.Open(name); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!reader.IsOpen()) return 2;
+
+    uint64_t acquired = 0, checked = 0, rejected = 0, stalls = 0, after = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (!reader.WriterClosed() && std::chrono::steady_clock::now() < deadline) {
+        Frame frame;
+        FrameExportReader::Token token;
+        if (!reader.Acquire(frame, token, after)) {
+            std::this_thread::yield();
+            continue;
+        }
+        after = token.published;
+        acquired++;
+
+        bool match = frame.width == kWidth && frame.height == kHeight;
+        for (int y = 0; y < kHeight && match; ++y) {
+            uint32_t want = Expected(token.frameNumber, y / kBandRows);
+            const uint32_t* row = (const uint32_t*)frame.Row(y);
+            for (int x = 0; x < kWidth; ++x) match = match && row[x] == want;
+        }
+
+        // Every 64th frame: stall until the writer has moved at least a full ring further
+        bool stalled = false;
+        if (acquired % 64 == 0) {
+            stalled = true;
+            Frame newer;
+            FrameExportReader::Token latest;
+            while (!reader.WriterClosed() &&
+                   !(reader.Acquire(newer, latest) && latest.published >= token.published + FrameExport::kSlots)) {
+                std::this_thread::yield();
+            }
+            if (reader.WriterClosed()) break;
+        }
+
+        if (reader.Valid(token)) {
+            if (!match) {
+                std::fprintf(stderr, "torn frame %llu accepted\n", (unsigned long long)token.frameNumber);
+                return 1;
+            }
+            if (stalled) {
+                std::fprintf(stderr, "frame %llu overwritten during a stall but still valid\n", (unsigned long long)token.frameNumber);
+                return 1;
+            }
+            checked++;
+        } else {
+            rejected++;
+            stalls += stalled;
+        }
+    }
+    std::printf("reader: %llu frames verified, %llu rejected (%llu after forced laps)\n",
+                (unsigned long long)checked, (unsigned long long)rejected, (unsigned long long)stalls);
+    return checked > 100 && stalls > 0 ? 0 : 3;
+}
+#endif
+
+int main() {
+#ifdef _WIN32
+    return kSkipped; // Covers the POSIX shm path; the Windows mapping shares the seqlock code
+#else
+    std::string name = "SimpleScreenRecorder.test." + std::to_string(getpid());
+    FrameExport writer;
+    if (!writer.Open(name, kWidth, kHeight)) {
+        std::printf("POSIX shm not available, skipped\n");
+        return kSkipped;
+    }
+
+    pid_t child = fork();
+    CHECK(child >= 0);
+    if (child == 0) {
+        int result = RunReader(name);
+        std::fflush(stdout);
+        _exit(result);
+    }
+
+    std::vector<uint8_t> pixels;
+    Frame frame = Frame::Wrap(pixels, kWidth, kHeight);
+    std::memset(pixels.data(), 0, pixels.size());
+    std::vector<FrameRect> damage(1);
+    uint64_t published = 0;
+    for (uint64_t n = 0; n < kFrames; ++n) {
+        int band = (int)(n % kBands);
+        for (int y = band * kBandRows; y < (band + 1) * kBandRows; ++y) {
+            uint32_t* row = (uint32_t*)frame.Row(y);
+            for (int x = 0; x < kWidth; ++x) row[x] = (uint32_t)n + 1;
+        }
+        damage[0] = { 0, band * kBandRows, kWidth, kBandRows };
+        frame.damage = n % 500 == 0 ? nullptr : &damage; // Unknown damage now and then: full copies
+        frame.sequence = n;
+        published += writer.Publish(frame, n);
+        if (n % 16 == 0) std::this_thread::yield();
+    }
+    FrameExport::Stats st = writer.GetStats();
+    writer.Close();
+
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status));
+    std::printf("writer: %llu published, %llu full copies, %.0f%% of the bytes of full copies\n",
+                (unsigned long long)published, (unsigned long long)st.fullCopies,
+                st.frameBytes ? 100.0 * st.bytes / st.frameBytes : 0.0);
+    CHECK(WEXITSTATUS(status) == 0);
+    CHECK(published > 0 && st.fullCopies < published);
+    std::printf("ok\n");
+    return 0;
+#endif
+}
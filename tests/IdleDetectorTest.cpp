@@ -0,0 +1,68 @@
+// IdleDetector: goes idle after the configured quiet time, ignores caret-sized damage, resumes
+// on activity, and caps the resume pre-roll at the slots the idle period actually skipped (the
+// audio thread holds no more audio than that, so a longer pre-roll would put video ahead).
+#include "IdleDetector.hpp"
+#include "Check.hpp"
+#include <vector>
+
+using Action = IdleDetector::Action;
+
+int main() {
+    const int fps = 30;
+    IdleDetector idle;
+    idle.Configure(fps, 2);
+    CHECK(idle.PrerollFrames() == 15);
+
+    Frame screen;
+    screen.width = 1920;
+    screen.height = 1080;
+    std::vector<FrameRect> caret = { { 100, 100, 2, 18 } };
+    std::vector<FrameRect> typing = { { 0, 0, 200, 40 } };
+    POINT mouse = { 10, 10 };
+
+    // Quiet except for a blinking caret: idle after exactly 2 s
+    auto quiet = [&](int slot) {
+        screen.damage = &caret;
+        return idle.Update(screen, slot % 15 == 0, mouse);
+    };
+    auto active = [&] {
+        screen.damage = &typing;
+        return idle.Update(screen, true, mouse);
+    };
+    for (int i = 1; i < 2 * fps; ++i) CHECK(quiet(i) == Action::Record);
+    CHECK(quiet(2 * fps) == Action::Skip);
+    CHECK(idle.IsIdle());
+
+    // Short idle period: 3 slots skipped, so only 3 frames of pre-roll
+    CHECK(quiet(0) == Action::Skip);
+    CHECK(quiet(1) == Action::Skip);
+    CHECK(active() == Action::Resume);
+    CHECK(!idle.IsIdle());
+    CHECK(idle.ResumeFrames() == 3);
+    CHECK(active() == Action::Record);
+
+    // Long idle period: the full pre-roll
+    for (int i = 1; i <= 2 * fps; ++i) quiet(i);
+    for (int i = 0; i < 100; ++i) CHECK(quiet(i) == Action::Skip);
+    mouse.x += 5; // Cursor movement alone resumes
+    CHECK(idle.Update(screen, false, mouse) == Action::Resume);
+    CHECK(idle.ResumeFrames() == idle.PrerollFrames());
+
+    // Audio above the silence threshold keeps the recording active
+    idle.SetAudioLevel(0.05f);
+    for (int i = 1; i <= 4 * fps; ++i) CHECK(quiet(i) == Action::Record);
+    idle.SetAudioLevel(0.0f);
+
+    IdleDetector::Stats st = idle.GetStats();
+    CHECK(st.idlePeriods == 2);
+    CHECK(st.skippedFrames == 3 + 101);
+
+    // Off: always Record
+    IdleDetector off;
+    off.Configure(fps, 0);
+    screen.damage = &caret;
+    for (int i = 0; i < 10 * fps; ++i) CHECK(off.Update(screen, false, mouse) == Action::Record);
+
+    std::printf("ok\n");
+    return 0;
+}
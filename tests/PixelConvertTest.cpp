@@ -0,0 +1,184 @@
+// PixelConvert::ConvertScaled on camera buffer layouts as Media Foundation hands them over:
+// rows padded past the width, NV12 with padding rows between the Y and UV planes (1080 -> 1088)
+// and bottom-up RGB32 (negative pitch). Every output pixel must match a per-pixel reference
+// built from the unpadded image: nearest-neighbour source sample, then the scalar YUV kernel.
+// The kernel itself is pinned by known colours worked out by hand from its BT.601 formula,
+// through padded NV12 and YUY2 at every CpuDispatch level.
+#include "PixelConvert.hpp"
+#include "CpuDispatch.hpp"
+#include "Check.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng(99);
+
+static constexpr int kW = 70, kH = 46;      // Odd chroma column count, even height
+static constexpr int kStride = 96;          // Padded pitch (bytes per row)
+static constexpr int kPlaneRows = kH + 10;  // Allocated Y rows (padding rows before UV)
+
+// Unpadded source samples
+struct Image {
+    std::vector<uint8_t> y = std::vector<uint8_t>((size_t)kW * kH);
+    std::vector<uint8_t> u = std::vector<uint8_t>((size_t)kW / 2 * kH);  // One per 2x1 pair
+    std::vector<uint8_t> v = std::vector<uint8_t>((size_t)kW / 2 * kH);
+    std::vector<uint32_t> bgra = std::vector<uint32_t>((size_t)kW * kH);
+};
+
+static Image MakeImage() {
+    Image img;
+    for (uint8_t& s : img.y) s = (uint8_t)rng();
+    for (uint8_t& s : img.u) s = (uint8_t)rng();
+    for (uint8_t& s : img.v) s = (uint8_t)rng();
+    for (uint32_t& p : img.bgra) p = (uint32_t)rng() & 0x00FFFFFFu;
+    return img;
+}
+
+// Expected BGRA for a conversion to dstW x dstH; NV12 shares chroma between row pairs
+static std::vector<uint8_t> Reference(const Image& img, PixelConvert::Format format, int dstW, int dstH) {
+    std::vector<uint8_t> out((size_t)dstW * dstH * 4);
+    for (int y = 0; y < dstH; ++y) {
+        int sy = (int)((int64_t)y * kH / dstH);
+        for (int x = 0; x < dstW; ++x) {
+            int sx = (int)((int64_t)x * kW / dstW);
+            uint8_t* px = &out[((size_t)y * dstW + x) * 4];
+            if (format == PixelConvert::Format::BGRA) {
+                uint32_t p = img.bgra[(size_t)sy * kW + sx] | 0xFF000000u;
+                std::memcpy(px, &p, 4);
+                continue;
+            }
+            int cy = format == PixelConvert::Format::NV12 ? sy & ~1 : sy;
+            size_t c = (size_t)cy * (kW / 2) + sx / 2;
+            PixelConvert::YuvRowToBGRA_Scalar(&img.y[(size_t)sy * kW + sx], &img.u[c], &img.v[c], px, 1);
+        }
+    }
+    return out;
+}
+
+static std::vector<uint8_t> Convert(const uint8_t* src, int stride, PixelConvert::Format format, int dstW, int dstH,
+                                    const uint8_t* uvPlane = nullptr) {
+    std::vector<uint8_t> out((size_t)dstW * dstH * 4, 0xCD);
+    PixelConvert::ConvertScaled(src, stride, kW, kH, format, out.data(), dstW * 4, dstW, dstH, uvPlane);
+    return out;
+}
+
+// Limited-range YUV and the BGRA it must give (0xAARRGGBB). With c = Y - 16, d = U - 128,
+// e = V - 128: B = (75c + 129d + 32) >> 6, G = (75c - 25d - 52e + 32) >> 6,
+// R = (75c + 102e + 32) >> 6, each clamped to 0..255.
+struct KnownColor {
+    uint8_t y, u, v;
+    uint32_t bgra;
+};
+static const KnownColor kKnown[] = {
+    { 235, 128, 128, 0xFFFFFFFFu }, // White: 16457 >> 6 = 257, clamped
+    { 16, 128, 128, 0xFF000000u },  // Black: 32 >> 6 = 0
+    { 126, 128, 128, 0xFF818181u }, // Grey: 8282 >> 6 = 129
+    { 81, 90, 240, 0xFFFF0000u },   // Red: B 5 >> 6 = 0, G 33 >> 6 = 0, R 16331 >> 6 = 255
+    { 145, 54, 34, 0xFF01FF02u },   // Green: B 161 >> 6 = 2, G 16445 >> 6 = 256 clamped, R 119 >> 6 = 1
+    { 100, 150, 80, 0xFF16818Fu },  // Unclamped: B 9170 >> 6 = 143, G 8278 >> 6 = 129, R 1436 >> 6 = 22
+};
+static constexpr int kKnownCount = sizeof(kKnown) / sizeof(kKnown[0]);
+
+// 36 x 4 pixels, one known colour per 2x2 block cycling through kKnown (36 so the SIMD loops
+// and their tails both run), in padded NV12 and YUY2 filled with 0xEE around the image
+static void CheckKnownColors() {
+    const int w = 36, h = 4, stride = 48, planeRows = h + 2;
+    std::vector<uint8_t> nv12((size_t)stride * planeRows * 3 / 2, 0xEE);
+    std::vector<uint8_t> yuy2((size_t)stride * 2 * h, 0xEE);
+    uint8_t* uv = nv12.data() + (size_t)stride * planeRows;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; x += 2) {
+            const KnownColor& k = kKnown[(x / 2 + y / 2) % kKnownCount];
+            nv12[(size_t)y * stride + x] = nv12[(size_t)y * stride + x + 1] = k.y;
+            uv[(size_t)(y / 2) * stride + x] = k.u;
+            uv[(size_t)(y / 2) * stride + x + 1] = k.v;
+            uint8_t* pair = &yuy2[(size_t)y * stride * 2 + x * 2];
+            pair[0] = pair[2] = k.y;
+            pair[1] = k.u;
+            pair[3] = k.v;
+        }
+    }
+
+    CpuDispatch::Isa best = CpuDispatch::Detected();
+    for (CpuDispatch::Isa isa : { CpuDispatch::Isa::Scalar, CpuDispatch::Isa::SSE2, CpuDispatch::Isa::AVX2 }) {
+        if (CpuDispatch::Force(isa) != isa) continue;
+        for (PixelConvert::Format format : { PixelConvert::Format::NV12, PixelConvert::Format::YUY2 }) {
+            bool isNv12 = format == PixelConvert::Format::NV12;
+            std::vector<uint32_t> out((size_t)w * h, 0);
+            PixelConvert::ConvertScaled(isNv12 ? nv12.data() : yuy2.data(), isNv12 ? stride : stride * 2, w, h, format,
+                                        (uint8_t*)out.data(), w * 4, w, h, isNv12 ? uv : nullptr);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    uint32_t expected = kKnown[(x / 2 + y / 2) % kKnownCount].bgra;
+                    if (out[(size_t)y * w + x] != expected) {
+                        std::printf("%s %s (%d,%d): 0x%08X, expected 0x%08X\n", CpuDispatch::Name(isa),
+                                    isNv12 ? "NV12" : "YUY2", x, y, out[(size_t)y * w + x], expected);
+                    }
+                    CHECK(out[(size_t)y * w + x] == expected);
+                }
+            }
+        }
+    }
+    CpuDispatch::Force(best);
+}
+
+int main() {
+    CheckKnownColors();
+    Image img = MakeImage();
+    const int sizes[][2] = { { kW, kH }, { 35, 23 }, { 16, 9 }, { 1, 1 } };
+
+    // NV12 with padded pitch and padding rows: the UV plane starts after kPlaneRows rows
+    std::vector<uint8_t> nv12((size_t)kStride * kPlaneRows * 3 / 2, 0xEE);
+    for (int y = 0; y < kH; ++y) {
+        std::memcpy(&nv12[(size_t)y * kStride], &img.y[(size_t)y * kW], kW);
+        if (y % 2) continue;
+        uint8_t* uv = &nv12[(size_t)kStride * kPlaneRows + (size_t)(y / 2) * kStride];
+        for (int c = 0; c < kW / 2; ++c) {
+            uv[c * 2] = img.u[(size_t)y * (kW / 2) + c];
+            uv[c * 2 + 1] = img.v[(size_t)y * (kW / 2) + c];
+        }
+    }
+    const uint8_t* uvPlane = nv12.data() + (size_t)kStride * kPlaneRows;
+    for (auto& size : sizes) {
+        CHECK(Convert(nv12.data(), kStride, PixelConvert::Format::NV12, size[0], size[1], uvPlane) ==
+              Reference(img, PixelConvert::Format::NV12, size[0], size[1]));
+    }
+
+    // Without padding rows, the default UV position (right after kH rows) is the same image
+    std::vector<uint8_t> tight((size_t)kStride * kH * 3 / 2);
+    std::memcpy(tight.data(), nv12.data(), (size_t)kStride * kH);
+    std::memcpy(tight.data() + (size_t)kStride * kH, uvPlane, (size_t)kStride * kH / 2);
+    CHECK(Convert(tight.data(), kStride, PixelConvert::Format::NV12, 35, 23) ==
+          Reference(img, PixelConvert::Format::NV12, 35, 23));
+
+    // YUY2 with padded pitch
+    std::vector<uint8_t> yuy2((size_t)kStride * 2 * kH, 0xEE);
+    for (int y = 0; y < kH; ++y) {
+        uint8_t* row = &yuy2[(size_t)y * kStride * 2];
+        for (int c = 0; c < kW / 2; ++c) {
+            row[c * 4] = img.y[(size_t)y * kW + c * 2];
+            row[c * 4 + 1] = img.u[(size_t)y * (kW / 2) + c];
+            row[c * 4 + 2] = img.y[(size_t)y * kW + c * 2 + 1];
+            row[c * 4 + 3] = img.v[(size_t)y * (kW / 2) + c];
+        }
+    }
+    for (auto& size : sizes) {
+        CHECK(Convert(yuy2.data(), kStride * 2, PixelConvert::Format::YUY2, size[0], size[1]) ==
+              Reference(img, PixelConvert::Format::YUY2, size[0], size[1]));
+    }
+
+    // Bottom-up RGB32 with padded pitch: the top row is last in memory, the pitch negative
+    int pitch = kStride * 4;
+    std::vector<uint8_t> rgb32((size_t)pitch * kH, 0xEE);
+    for (int y = 0; y < kH; ++y) {
+        std::memcpy(&rgb32[(size_t)(kH - 1 - y) * pitch], &img.bgra[(size_t)y * kW], (size_t)kW * 4);
+    }
+    const uint8_t* top = rgb32.data() + (size_t)(kH - 1) * pitch;
+    for (auto& size : sizes) {
+        CHECK(Convert(top, -pitch, PixelConvert::Format::BGRA, size[0], size[1]) ==
+              Reference(img, PixelConvert::Format::BGRA, size[0], size[1]));
+    }
+
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,86 @@
+// RateController without FFmpeg: scene-change detection (a large change the screen then
+// settles on, at most one per second), the merge of scene keyframes into the seek index grid
+// (scenes within a second of a grid keyframe are left to it), the fallback to x264's own
+// scene-cut once there are too many keyframes for one command line, and the argument strings.
+#include "RateController.hpp"
+#include "Check.hpp"
+#include <string>
+#include <vector>
+
+static const int kFps = 30;
+
+// `seconds` of a static screen with full-frame changes at `scenes` (frame numbers)
+static std::vector<float> Changes(double seconds, const std::vector<size_t>& scenes) {
+    std::vector<float> changed((size_t)(seconds * kFps), 0.0f);
+    for (size_t f : scenes) changed[f] = 1.0f;
+    return changed;
+}
+
+int main() {
+    using Scenes = std::vector<uint64_t>;
+
+    // A single change that settles
+    CHECK(RateController::SceneChanges(Changes(10, { 60 }), kFps) == Scenes{ 60 });
+
+    // Below kSceneChangeFraction is no scene
+    std::vector<float> changed = Changes(10, {});
+    changed[60] = RateController::kSceneChangeFraction - 0.01f;
+    CHECK(RateController::SceneChanges(changed, kFps).empty());
+    changed[60] = RateController::kSceneChangeFraction;
+    CHECK(RateController::SceneChanges(changed, kFps) == Scenes{ 60 });
+
+    // Settle window (the half second after): motion there rejects it, light noise doesn't
+    changed = Changes(10, { 60 });
+    for (size_t f = 61; f <= 75; ++f) changed[f] = 0.3f; // Scrolling
+    CHECK(RateController::SceneChanges(changed, kFps).empty());
+    for (size_t f = 61; f <= 75; ++f) changed[f] = RateController::kSettledFraction; // Caret, clock
+    CHECK(RateController::SceneChanges(changed, kFps) == Scenes{ 60 });
+    changed[76] = 1.0f; // Just past the window; within a second, so not a scene of its own
+    CHECK(RateController::SceneChanges(changed, kFps) == Scenes{ 60 });
+
+    // A second change inside the window: the first never settled, the second does
+    CHECK(RateController::SceneChanges(Changes(10, { 60, 70 }), kFps) == Scenes{ 70 });
+
+    // One-second spacing: 80 is too close to 60, 90 is exactly a second after it
+    CHECK(RateController::SceneChanges(Changes(10, { 60, 80 }), kFps) == Scenes{ 60 });
+    CHECK((RateController::SceneChanges(Changes(10, { 60, 90 }), kFps) == Scenes{ 60, 90 }));
+    CHECK((RateController::SceneChanges(Changes(10, { 60, 80, 100 }), kFps) == Scenes{ 60, 100 }));
+
+    // Frame 0 (the first keyframe anyway) and changes too close to the end to judge are skipped
+    CHECK(RateController::SceneChanges(Changes(10, { 0, 290 }), kFps).empty());
+
+    // Grid every 10 s over a minute plus scenes at 5, 10.5, 19.2, 25 and 39 s: 10.5 and 19.2
+    // are within a second of 10 and 20 and dropped; 39 is exactly a second from 40 and kept
+    RateController::Stats stats;
+    RateController::Params p = RateController::Offline(1920, 1080, kFps, Changes(60, { 150, 315, 576, 750, 1170 }), 10, &stats);
+    CHECK(p.keyframeTimes == (std::vector<double>{ 0, 5, 10, 20, 25, 30, 39, 40, 50 }));
+    CHECK(p.scenecut == 0);
+    CHECK(stats.frames == 1800 && stats.sceneChanges == 5 && stats.staticFrames == 1795 && stats.burstFrames == 5);
+
+    // Without a grid the scenes are the only forced keyframes
+    p = RateController::Offline(1920, 1080, kFps, Changes(60, { 150, 315 }), 0);
+    CHECK(p.keyframeTimes == (std::vector<double>{ 5, 10.5 }));
+
+    // A scene every second for longer than kMaxForcedKeyframes seconds: too many to force,
+    // so x264's scene-cut takes over and the grid falls back to its expression
+    size_t count = RateController::kMaxForcedKeyframes + 100;
+    std::vector<size_t> many;
+    for (size_t i = 1; i <= count; ++i) many.push_back(i * kFps);
+    p = RateController::Offline(1920, 1080, kFps, Changes((double)count + 2, many), 10, &stats);
+    CHECK(stats.sceneChanges == count);
+    CHECK(p.keyframeTimes.empty() && p.scenecut == 40);
+    CHECK(p.EncoderArgs(10).find("scenecut=40 -force_key_frames \"expr:gte(t,n_forced*10)\"") != std::string::npos);
+
+    // Argument strings
+    CHECK(RateController::Fixed().EncoderArgs(0) == " -crf 23");
+    CHECK(RateController::Fixed().EncoderArgs(10) == " -crf 23 -force_key_frames \"expr:gte(t,n_forced*10)\"");
+    CHECK(RateController::Live(1920, 1080, 30).EncoderArgs(0) ==
+          " -crf 23 -maxrate 6220k -bufsize 12441k -x264-params keyint=600:min-keyint=30:scenecut=40");
+    p = RateController::Offline(1280, 720, kFps, Changes(30, { 150, 315 }), 10);
+    CHECK(p.EncoderArgs(10) == " -crf 23 -maxrate 2764k -bufsize 5529k -x264-params keyint=600:min-keyint=30:scenecut=0"
+                               " -force_key_frames 0.000,5.000,10.000,20.000");
+    CHECK(p.KeyframeArgs(10) == " -force_key_frames 0.000,5.000,10.000,20.000");
+
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+// SeekIndex round trip: a sidecar written from full-size frames and from preview-scale copies
+// (as the engine passes them) is read back with SeekIndex::Read. Each entry must sit on the
+// interval grid and decode to exactly the nearest-neighbour thumbnail of its frame. Also reads
+// an unfinished sidecar (entry count not yet written, last entry cut short) and rejects junk.
+#include "SeekIndex.hpp"
+#include "Check.hpp"
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static constexpr int kWidth = 640, kHeight = 360, kFps = 30, kInterval = 2;
+
+// Frame n: a gradient plus a block whose position depends on n
+static void Render(std::vector<uint8_t>& pixels, int n) {
+    Frame frame = Frame::Wrap(pixels, kWidth, kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        uint32_t* row = (uint32_t*)frame.Row(y);
+        for (int x = 0; x < kWidth; ++x) {
+            bool block = x / 64 == n % 10 && y / 60 == n % 6;
+            row[x] = block ? 0xFFFFFFFFu : 0xFF000000u | (uint32_t)(x * 255 / kWidth) << 16 | (uint32_t)(y * 255 / kHeight) << 8 | (uint32_t)(n & 0xFF);
+        }
+    }
+}
+
+static std::vector<uint8_t> Thumbnail(const std::vector<uint8_t>& pixels, int width, int height) {
+    std::vector<uint8_t> thumb((size_t)width * height * 4);
+    PixelConvert::ConvertScaled(pixels.data(), kWidth * 4, kWidth, kHeight, PixelConvert::Format::BGRA,
+                                thumb.data(), width * 4, width, height);
+    return thumb;
+}
+
+int main() {
+    fs::path dir = fs::temp_directory_path() / ("ssr_seekindex_test_" + std::to_string(std::random_device()()));
+    fs::create_directories(dir);
+    std::string path = (dir / "clip.mp4.idx").string();
+
+    const int thumbW = SeekIndex::kThumbWidth, thumbH = SeekIndex::ThumbHeight(kWidth, kHeight);
+    CHECK(thumbH == 90);
+
+    SeekIndex index;
+    CHECK(index.Start(path, kFps, kInterval, kWidth, kHeight));
+    std::vector<uint8_t> pixels, small;
+    std::vector<std::vector<uint8_t>> expected;
+    const int frames = kFps * kInterval * 5 + 7;
+    for (int n = 0; n < frames; ++n) {
+        if (!index.WantsFrame((uint64_t)n)) {
+            index.AddFrame((uint64_t)n, Frame()); // No work off the grid
+            continue;
+        }
+        Render(pixels, n);
+        expected.push_back(Thumbnail(pixels, thumbW, thumbH));
+        Frame full = Frame::Wrap(pixels, kWidth, kHeight);
+        if (expected.size() % 2) {
+            index.AddFrame((uint64_t)n, full);
+        } else {
+            // The engine's path: the preview-scale copy, taken as-is
+            small = expected.back();
+            index.AddFrame((uint64_t)n, Frame::Wrap(small, thumbW, thumbH));
+        }
+    }
+    CHECK(expected.size() == 6);
+    index.Finish();
+    CHECK(SeekIndex::ReadIntervalSeconds(path) == kInterval);
+
+    SeekIndex::FileHeader header;
+    std::vector<SeekIndex::Thumbnail> entries;
+    CHECK(SeekIndex::Read(path, header, entries));
+    CHECK(header.fps == kFps && header.entryCount == expected.size());
+    CHECK(header.thumbWidth == thumbW && header.thumbHeight == thumbH);
+    CHECK(entries.size() == expected.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        uint64_t frame = i * kFps * kInterval;
+        CHECK(entries[i].entry.frameIndex == frame);
+        CHECK(entries[i].entry.timeUs == (int64_t)(frame * 1000000 / kFps));
+        CHECK(entries[i].pixels == expected[i]);
+    }
+
+    // Unfinished: entry count still 0 and the last entry cut short; the complete ones are found
+    std::string partial = (dir / "partial.idx").string();
+    fs::copy_file(path, partial);
+    uintmax_t size = fs::file_size(partial);
+    fs::resize_file(partial, size - 10);
+    {
+        std::FILE* f = std::fopen(partial.c_str(), "r+b");
+        CHECK(f);
+        header.entryCount = 0;
+        std::fwrite(&header, sizeof(header), 1, f);
+        std::fclose(f);
+    }
+    CHECK(SeekIndex::Read(partial, header, entries));
+    CHECK(entries.size() == expected.size() - 1);
+    for (size_t i = 0; i < entries.size(); ++i) CHECK(entries[i].pixels == expected[i]);
+
+    // Not a sidecar
+    std::string junk = (dir / "junk.idx").string();
+    {
+        std::FILE* f = std::fopen(junk.c_str(), "wb");
+        CHECK(f);
+        std::fputs("not an index", f);
+        std::fclose(f);
+    }
+    CHECK(!SeekIndex::Read(junk, header, entries) && entries.empty());
+    CHECK(!SeekIndex::Read((dir / "missing.idx").string(), header, entries));
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * ssr-clip: trims and splits finished recordings from a console, on Windows
+ * and Linux alike (ClipEditor does the work):
+ *   ssr-clip trim  <input> <output> <start> <end> [--exact]   (seconds; end < 0 = to the end)
+ *   ssr-clip split <input> <seconds> <first> <second> [--exact]
+ * Stream copies cut on keyframes; --exact re-encodes only the partial GOP at the start.
+ * FFmpeg is $FFMPEG if set, else the one next to this executable, else the one on PATH.
+ */
+#include "ClipEditor.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+static std::string FindFFmpeg(const char* argv0) {
+    if (const char* env = std::getenv("FFMPEG")) {
+        if (*env) return env;
+    }
+#ifdef _WIN32
+    const char* name = "ffmpeg.exe";
+#else
+    const char* name = "ffmpeg";
+#endif
+    std::error_code ec;
+    std::filesystem::path local = std::filesystem::absolute(argv0, ec).parent_path() / name;
+    if (!ec && std::filesystem::exists(local, ec)) return local.make_preferred().string();
+    return name;
+}
+
+static int Usage() {
+    std::fprintf(stderr, "Usage: ssr-clip trim <input> <output> <start> <end> [--exact]\n"
+                         "       ssr-clip split <input> <seconds> <first> <second> [--exact]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return Usage();
+    std::string verb = argv[1];
+    bool exact = std::string(argv[argc - 1]) == "--exact";
+    int args = argc - 2 - (exact ? 1 : 0);
+    if ((verb != "trim" && verb != "split") || args != 4) return Usage();
+
+    ClipEditor editor(FindFFmpeg(argv[0]));
+    auto start = std::chrono::steady_clock::now();
+    bool ok = verb == "trim"
+        ? editor.Trim(argv[2], argv[3], std::atof(argv[4]), std::atof(argv[5]), exact)
+        : editor.Split(argv[2], std::atof(argv[3]), argv[4], argv[5], exact);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        std::fprintf(stderr, "%s\n", editor.LastError().c_str());
+        return 1;
+    }
+    std::printf("%s in %.2f s\n", verb == "trim" ? "Trimmed" : "Split", seconds);
+    return 0;
+}